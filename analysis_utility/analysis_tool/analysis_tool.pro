@@ -1,10 +1,10 @@
-QT += widgets xml charts sql
+QT += widgets xml charts sql network
 QMAKE_CXXFLAGS += -std=gnu++11 -Wno-unused-parameter
 
 HEADERS = $$files(src/*.h, true)
 SOURCES = $$files(src/*.cpp, true)
 
-INCLUDEPATH += src /usr/include/libusb-1.0/ ../../power_measurement_utility/mcu/common/
+INCLUDEPATH += src /usr/include/libusb-1.0/ ../../power_measurement_utility/mcu/common/ ../../target/libtulipp/
 
 RESOURCES     = application.qrc
 
@@ -49,6 +49,11 @@ Analysis::Analysis() {
   Config::asUs = settings.value("asUsPath", "aarch64-none-elf-as").toString();
   Config::linkerUs = settings.value("linkerUsPath", "aarch64-none-elf-gcc").toString();
   Config::linkerppUs = settings.value("linkerppUsPath", "aarch64-none-elf-g++").toString();
+  Config::buildCacheDir = settings.value("buildCacheDir", QDir::homePath() + "/.tulipp/cache").toString();
+  Config::buildCacheSize = settings.value("buildCacheSize", 20000).toUInt();
+  Config::dseWorkers = settings.value("dseWorkers", "").toString();
+  Config::dseWorkerSecret = settings.value("dseWorkerSecret", "").toString();
+  Config::makeJobs = settings.value("makeJobs", QThread::idealThreadCount() > 0 ? QThread::idealThreadCount() : 1).toUInt();
   Config::core = settings.value("core", 0).toUInt();
   Config::sensor = settings.value("sensor", 0).toUInt();
   Config::window = settings.value("window", 1).toUInt();
@@ -56,6 +61,7 @@ Analysis::Analysis() {
   Config::regionsInTable = settings.value("regionsInTable", false).toBool();
   Config::loopsInTable = settings.value("loopsInTable", false).toBool();
   Config::basicblocksInTable = settings.value("basicblocksInTable", false).toBool();
+  Config::openGlGraph = settings.value("openGlGraph", false).toBool();
   
   Config::sdsocVersion = Sdsoc::getSdsocVersion();
 
@@ -84,25 +90,8 @@ void Analysis::load() {
 
   if(dse) dse->setCfg(project->cfg);
 
-  QDir dir(".");
-  dir.setFilter(QDir::Files);
-  // read files from tulipp project dir
-  {
-    QStringList nameFilter;
-    nameFilter << "*.elf" << "*.dse";
-    dir.setNameFilters(nameFilter);
-
-    QFileInfoList list = dir.entryInfoList();
-    for(auto fileInfo : list) {
-      QString path = fileInfo.filePath();
-      QString suffix = fileInfo.suffix();
-      if(suffix == "dse") {
-        std::ifstream inputFile(path.toUtf8()); 
-        inputFile >> *dse;
-        inputFile.close();
-      }
-    }
-  }
+  // read DSE results from tulipp project dir
+  if(dse) dse->load();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -24,6 +24,7 @@
 #include "mainwindow.h"
 #include "analysis.h"
 #include "cfg/loop.h"
+#include "dse/dseworker.h"
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -97,6 +98,11 @@ int main(int argc, char *argv[]) {
                                        QCoreApplication::translate("main", "file"));
   parser.addOption(loadProfileOption);
 
+  QCommandLineOption loadGProfOption(QStringList() << "load-gprof",
+                                     QCoreApplication::translate("main", "Load call graph and loop counts"),
+                                     QCoreApplication::translate("main", "gmon file,elf file"));
+  parser.addOption(loadGProfOption);
+
   QCommandLineOption cflagsOption(QStringList() << "compile-flags",
                                   QCoreApplication::translate("main", "Extra compile flags"),
                                   QCoreApplication::translate("main", "flags"));
@@ -142,6 +148,16 @@ int main(int argc, char *argv[]) {
                                   QCoreApplication::translate("main", "core,sensor"));
   parser.addOption(dumpRoiOption);
 
+  QCommandLineOption dseWorkerOption(QStringList() << "dse-worker",
+                                     QCoreApplication::translate("main", "Build DSE individuals for other processes"),
+                                     QCoreApplication::translate("main", "host:port or socket"));
+  parser.addOption(dseWorkerOption);
+
+  QCommandLineOption dseBuildOnOption(QStringList() << "dse-build-on",
+                                      QCoreApplication::translate("main", "Build on a DSE worker instead of locally"),
+                                      QCoreApplication::translate("main", "host:port or socket"));
+  parser.addOption(dseBuildOnOption);
+
   parser.process(app);
 
   QSettings settings;
@@ -177,6 +193,11 @@ int main(int argc, char *argv[]) {
     Config::projectDir = "";
   }
 
+  if(parser.isSet(dseWorkerOption)) {
+    DseWorker worker;
+    return worker.run(parser.value(dseWorkerOption)) ? 0 : 1;
+  }
+
   bool batch =
     parser.isSet(getRuntimeOption) ||
     parser.isSet(getPowerOption) ||
@@ -186,6 +207,7 @@ int main(int argc, char *argv[]) {
     parser.isSet(cleanOption) || 
     parser.isSet(buildOption) || 
     parser.isSet(loadProfileOption) || 
+    parser.isSet(loadGProfOption) || 
     parser.isSet(runOption) || 
     parser.isSet(exportOption) || 
     parser.isSet(dumpRoiOption) || 
@@ -210,10 +232,19 @@ int main(int argc, char *argv[]) {
     }
 
     if(parser.isSet(buildOption)) {
-      printf("Building application\n");
-      if(!analysis.project->makeBin()) {
-        printf("Can't build project\n");
-        return -1;
+      if(parser.isSet(dseBuildOnOption)) {
+        printf("Building application on %s\n", parser.value(dseBuildOnOption).toUtf8().constData());
+        Sdsoc *sdsoc = dynamic_cast<Sdsoc*>(analysis.project);
+        if(!sdsoc || !DseWorker::build(parser.value(dseBuildOnOption), sdsoc, QMap<QString,QStringList>()) || sdsoc->errorCode) {
+          printf("Can't build project on worker\n");
+          return -1;
+        }
+      } else {
+        printf("Building application\n");
+        if(!analysis.project->makeBin()) {
+          printf("Can't build project\n");
+          return -1;
+        }
       }
     }
 
@@ -225,6 +256,15 @@ int main(int argc, char *argv[]) {
       }
     }
 
+    if(parser.isSet(loadGProfOption)) {
+      QStringList arg = parser.value(loadGProfOption).split(',');
+      printf("Loading call graph\n");
+      if((arg.size() != 2) || !analysis.loadGProfFile(arg[0], arg[1])) {
+        printf("Can't load call graph\n");
+        return -1;
+      }
+    }
+
     if(parser.isSet(runOption)) {
       printf("Running application\n");
       if(!analysis.runApp()) {
@@ -288,7 +328,7 @@ int main(int argc, char *argv[]) {
     if(parser.isSet(getCountOption)) {
       double runtime, energy;
       uint64_t count;
-      QStringList arg = parser.value(getRuntimeOption).split(',');
+      QStringList arg = parser.value(getCountOption).split(',');
       if(!getProfData(analysis, arg[0], arg[1], arg[2].toUInt(), 0, &runtime, &energy, &count)) return -1;
       printf("%ld\n", count);
     }
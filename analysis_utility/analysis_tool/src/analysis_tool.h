@@ -123,6 +123,9 @@
 #define SCALE_IN_FACTOR 1.25
 #define SCALE_OUT_FACTOR 0.8
 
+// CFG vertex text is not painted when zoomed further out than this
+#define CFG_TEXT_MIN_LOD 0.4
+
 ///////////////////////////////////////////////////////////////////////////////
 // build defines
 
@@ -26,7 +26,7 @@
 #include "function.h"
 #include "profile/profline.h"
 
-int BasicBlock::appendInstructions(QGraphicsItem *parent, int xx, int yy, unsigned *width,
+int BasicBlock::appendInstructions(CfgItem *parent, int xx, int yy, unsigned *width,
                                    Vertex *visualTop, QVector<BasicBlock*> callStack, float scaling) {
   for(auto child : children) {
     Instruction *instr = dynamic_cast<Instruction*>(child);
@@ -115,73 +115,23 @@ void BasicBlock::appendLocalItems(int startX, int yy, Vertex *visualTop, QVector
 
 void BasicBlock::getProfData(unsigned core, QVector<BasicBlock*> callStack,
                              double *runtime, double *energy, double *runtimeFrame, double *energyFrame, uint64_t *count) {
-  if(cachedRuntime == INT_MAX) {
-    Profile *profile = getTop()->getProfile();
-
-    if(profile) {
-      profile->getProfData(core, this, &cachedRuntime, cachedEnergy, &cachedRuntimeFrame, cachedEnergyFrame, &cachedCount);
+  Profile *profile = getTop()->getProfile();
 
-      for(auto child : children) {
-        Instruction *instr = dynamic_cast<Instruction*>(child);
-        if(instr) {
-          if(instr->name == INSTR_ID_CALL) {
-            Function *func = getModule()->getFunctionById(instr->target);
-            if(!func) {
-              func = getTop()->getFunctionById(instr->target);
-            }
-            if(func) {
-              if(!callStack.contains(this)) {
-                double runtimeChild;
-                double runtimeChildFrame;
-                double energyChild[Pmu::MAX_SENSORS];
-                double energyChildFrame[Pmu::MAX_SENSORS];
-                uint64_t countChild;
-                callStack.push_back(this);
-                func->getProfData(core, callStack, &runtimeChild, energyChild, &runtimeChildFrame, energyChildFrame, &countChild);
-
-                if((func->callers == 1) && (func->caller.contains(this))) {
-                  cachedRuntime += runtimeChild;
-                  cachedRuntimeFrame += runtimeChildFrame;
-                  for(unsigned i = 0; i < Pmu::MAX_SENSORS; i++) {
-                    cachedEnergy[i] += energyChild[i];
-                    cachedEnergyFrame[i] += energyChildFrame[i];
-                  }
-                } else {
-                  double ratio = profile->getArcRatio(core, this, func);
-
-                  cachedRuntime += runtimeChild * ratio;
-                  cachedRuntimeFrame += runtimeChildFrame * ratio;
-                  for(unsigned i = 0; i < Pmu::MAX_SENSORS; i++) {
-                    cachedEnergy[i] += energyChild[i] * ratio;
-                    cachedEnergyFrame[i] += energyChildFrame[i] * ratio;
-                  }
-                }
-              }
-            }
-          }
-        }
-      }
-    } else {
-      cachedRuntime = 0;
-      cachedRuntimeFrame = 0;
-      for(unsigned i = 0; i < Pmu::MAX_SENSORS; i++) {
-        cachedEnergy[i] = 0;
-        cachedEnergyFrame[i] = 0;
-      }
-      cachedCount = 0;
+  if(profile) {
+    profile->getInclusiveProfile(core, getTop())->getProfData(this, runtime, energy, runtimeFrame, energyFrame, count);
+
+  } else {
+    *runtime = 0;
+    *runtimeFrame = 0;
+    for(unsigned i = 0; i < Pmu::MAX_SENSORS; i++) {
+      energy[i] = 0;
+      energyFrame[i] = 0;
     }
+    *count = 0;
   }
-
-  *runtime = cachedRuntime;
-  *runtimeFrame = cachedRuntimeFrame;
-  for(unsigned i = 0; i < Pmu::MAX_SENSORS; i++) {
-    energy[i] = cachedEnergy[i];
-    energyFrame[i] = cachedEnergyFrame[i];
-  }
-  *count = cachedCount;
 }
 
-void BasicBlock::getMeasurements(unsigned core, QVector<BasicBlock*> callStack, QVector<Measurement> *measurements) {
+void BasicBlock::getMeasurements(unsigned core, QVector<BasicBlock*> callStack, QVector<MeasurementSpan> *measurements) {
   Profile *profile = getTop()->getProfile();
 
   if(profile) {
@@ -52,7 +52,7 @@ public:
 
   virtual QString getCfgName();
 
-  virtual int appendInstructions(QGraphicsItem *parent, int xx, int yy, unsigned *width,
+  virtual int appendInstructions(CfgItem *parent, int xx, int yy, unsigned *width,
                                  Vertex *visualTop, QVector<BasicBlock*> callStack, float scaling);
 
   void appendEdge(QString edgeId) {
@@ -109,7 +109,7 @@ public:
   virtual void getProfData(unsigned core, QVector<BasicBlock*> callStack,
                            double *runtime, double *energy, double *runtimeFrame, double *energyFrame, uint64_t *count);
 
-  virtual void getMeasurements(unsigned core, QVector<BasicBlock*> callStack, QVector<Measurement> *measurements);
+  virtual void getMeasurements(unsigned core, QVector<BasicBlock*> callStack, QVector<MeasurementSpan> *measurements);
 
   virtual void calculateCallers();
 
@@ -19,9 +19,16 @@
  *
  *****************************************************************************/
 
+#include <atomic>
+
 #include "cfg.h"
 
+// CFGs are built by several threads at once
+static std::atomic<unsigned> nextSerial(0);
+
 Cfg::Cfg() : Container("", "", NULL, 0) {
+  serial = ++nextSerial;
+
   externalMod = new Module("__External__", this);
   appendChild(externalMod);
 
@@ -44,6 +51,7 @@ void Cfg::clearCachedProfilingData() {
 
 void Cfg::setProfile(Profile *profile) {
   this->profile = profile;
+  profile->clearInclusiveProfiles();
   profile->addExternalFunctions(this);
   clearCachedProfilingData();
 }
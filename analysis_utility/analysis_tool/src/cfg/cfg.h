@@ -39,6 +39,8 @@ private:
 
 public:
   Module *externalMod;
+  // unique for every Cfg instance, also when a new Cfg reuses the address of a deleted one
+  unsigned serial;
 
   Cfg();
   virtual ~Cfg();
@@ -0,0 +1,107 @@
+/******************************************************************************
+ *
+ *  This file is part of the TULIPP Analysis Utility
+ *
+ *  Copyright 2018 Asbjørn Djupdal, NTNU, TULIPP EU Project
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *****************************************************************************/
+
+#ifndef CFGITEM_H
+#define CFGITEM_H
+
+#include <vector>
+#include <QGraphicsItem>
+#include <QVariant>
+
+// Layout record for one element of a CFG drawing.
+// The layout code builds a tree of these instead of QGraphicsItems.  CfgScene
+// only creates graphics items for the records intersecting the viewport, and
+// hands them back to a pool for reuse when they scroll out of view.
+
+class CfgItem {
+  QPointF position;
+  qreal z;
+  QVariant itemData[2];
+
+public:
+  enum { VERTEX, EDGE, TYPES };
+
+  CfgItem *parent;
+  std::vector<CfgItem*> children;
+  QGraphicsItem *item; // graphics item while visible, else NULL
+
+  CfgItem(CfgItem *parent) {
+    this->parent = parent;
+    z = 0;
+    item = NULL;
+    if(parent) parent->children.push_back(this);
+  }
+  virtual ~CfgItem() {
+    for(auto child : children) {
+      delete child;
+    }
+  }
+
+  void setPos(const QPointF &pos) {
+    position = pos;
+    if(item) item->setPos(pos);
+  }
+  void setPos(qreal x, qreal y) {
+    setPos(QPointF(x, y));
+  }
+  QPointF pos() const {
+    return position;
+  }
+
+  void setZValue(qreal z) {
+    this->z = z;
+    if(item) item->setZValue(z);
+  }
+  qreal zValue() const {
+    return z;
+  }
+
+  // key is 0 (vertex) or 1 (callstack), copied to the graphics item
+  void setData(int key, const QVariant &value) {
+    itemData[key] = value;
+    if(item) item->setData(key, value);
+  }
+  QVariant data(int key) const {
+    return itemData[key];
+  }
+
+  // area covered by this record and its children, in parent coordinates
+  virtual QRectF boundingRect() const {
+    return QRectF();
+  }
+
+  // pool the graphics item belongs to
+  virtual int itemType() const {
+    return TYPES;
+  }
+  virtual QGraphicsItem *createItem() const {
+    return NULL;
+  }
+  // set all properties of a new or reused graphics item from this record
+  virtual void updateItem(QGraphicsItem *item) const {
+    item->setPos(position);
+    item->setZValue(z);
+    item->setData(0, itemData[0]);
+    item->setData(1, itemData[1]);
+  }
+};
+
+#endif
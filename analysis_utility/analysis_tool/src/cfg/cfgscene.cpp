@@ -32,30 +32,102 @@ CfgScene::CfgScene(QComboBox *colorBox, TextView *textView, QObject *parent) : Q
   this->textView = textView;
   zvalue = 1;
   lastElement = NULL;
+  root = NULL;
+}
+
+void CfgScene::clearItems() {
+  delete root;
+  root = NULL;
+
+  clear();
+
+  for(int i = 0; i < CfgItem::TYPES; i++) {
+    for(auto item : itemPool[i]) {
+      delete item;
+    }
+    itemPool[i].clear();
+  }
 }
 
 void CfgScene::drawElement(Container *element, QVector<BasicBlock*> callStack) {
   lastElement = element;
   lastCallStack = callStack;
 
-  clear();
+  clearItems();
 
-  QGraphicsLineItem *item = new QGraphicsLineItem();
-  item->setPos(0,0);
+  // lay out the whole drawing, this does not create any graphics items
+  root = new CfgItem(NULL);
   element->callStack = callStack;
-  element->appendItems(item, element, callStack, 1);
+  element->appendItems(root, element, callStack, 1);
   element->setPos(0,0);
 
-  addItem(item);
-
   setSceneRect(QRectF(0, 0, element->width, element->height));
 
   element->closeItems();
+
+  updateVisibleItems();
+}
+
+void CfgScene::updateVisibleItems() {
+  if(!root) return;
+
+  QRectF visible;
+  for(auto view : views()) {
+    visible |= view->mapToScene(view->viewport()->rect()).boundingRect();
+  }
+
+  // a margin of half a view in each direction, so that slow scrolling doesn't create items at every step
+  visible.adjust(-visible.width()/2, -visible.height()/2, visible.width()/2, visible.height()/2);
+
+  for(auto child : root->children) {
+    showItems(child, NULL, root->pos(), visible);
+  }
+}
+
+void CfgScene::showItems(CfgItem *record, QGraphicsItem *parentItem, QPointF offset, const QRectF &visible) {
+  QPointF pos = offset + record->pos();
+
+  // children are drawn inside their parent, so nothing below an invisible record can be visible
+  if(!visible.intersects(record->boundingRect().translated(pos))) {
+    hideItems(record);
+    return;
+  }
+
+  if(!record->item) {
+    QVector<QGraphicsItem*> &pool = itemPool[record->itemType()];
+    record->item = pool.size() ? pool.takeLast() : record->createItem();
+    record->updateItem(record->item);
+    if(parentItem) {
+      record->item->setParentItem(parentItem);
+    } else {
+      addItem(record->item);
+    }
+  }
+
+  for(auto child : record->children) {
+    showItems(child, record->item, pos, visible);
+  }
+}
+
+void CfgScene::hideItems(CfgItem *record) {
+  if(record->item) {
+    for(auto child : record->children) {
+      hideItems(child);
+    }
+
+    QGraphicsItem *item = record->item;
+    record->item = NULL;
+
+    item->setParentItem(NULL);
+    removeItem(item);
+    itemPool[record->itemType()].push_back(item);
+  }
 }
 
 void CfgScene::mousePressEvent(QGraphicsSceneMouseEvent *mouseEvent) {
   if(mouseEvent->button() == Qt::LeftButton) {
     QGraphicsItem *item = itemAt(mouseEvent->scenePos(), QTransform());
+    if(!item) return;
     Vertex *el = (Vertex*)item->data(0).value<void*>();
     if(el) {
       textView->loadFile(el->getSourceFilename(), el->getSourceLineNumber());
@@ -78,6 +150,7 @@ void CfgScene::mousePressEvent(QGraphicsSceneMouseEvent *mouseEvent) {
 void CfgScene::mouseDoubleClickEvent(QGraphicsSceneMouseEvent *mouseEvent) {
   if (mouseEvent->button() == Qt::LeftButton) {
     QGraphicsItem *item = itemAt(mouseEvent->scenePos(), QTransform());
+    if(!item) return;
     Vertex *el = (Vertex*)item->data(0).value<void*>();
     Container *cont = dynamic_cast<Container*>(el);
     if(cont) {
@@ -37,9 +37,20 @@ class CfgScene : public QGraphicsScene {
   Container *lastElement;
   QVector<BasicBlock*> lastCallStack;
 
+  // layout of the current drawing, graphics items only exist for the visible part
+  CfgItem *root;
+  // unused graphics items, by CfgItem type
+  QVector<QGraphicsItem*> itemPool[CfgItem::TYPES];
+
+  void showItems(CfgItem *record, QGraphicsItem *parentItem, QPointF offset, const QRectF &visible);
+  void hideItems(CfgItem *record);
+  void clearItems();
+
 public:
   explicit CfgScene(QComboBox *colorBox, TextView *textView, QObject *parent = 0);
-  ~CfgScene() {}
+  ~CfgScene() {
+    clearItems();
+  }
   void drawElement(Container *element, QVector<BasicBlock*> callStack = QVector<BasicBlock*>());
   void mousePressEvent(QGraphicsSceneMouseEvent *mouseEvent);
   void mouseDoubleClickEvent(QGraphicsSceneMouseEvent *mouseEvent);
@@ -50,9 +61,11 @@ public:
   }
   void clearScene() {
     lastElement = NULL;
-    clear();
+    clearItems();
     update();
   }
+  // create graphics items for the part of the drawing that is visible in the views
+  void updateVisibleItems();
 };
 
 #endif
@@ -25,12 +25,27 @@
 #include "cfgscene.h"
 #include "vertex.h"
 #include "function.h"
+#include "loop.h"
 
 void CfgView::mouseReleaseEvent(QMouseEvent *event) {
   QGraphicsView::mouseReleaseEvent(event);
   viewport()->setCursor(Qt::ArrowCursor);
 }
 
+void CfgView::scrollContentsBy(int dx, int dy) {
+  QGraphicsView::scrollContentsBy(dx, dy);
+  updateVisibleItems();
+}
+
+void CfgView::resizeEvent(QResizeEvent *event) {
+  QGraphicsView::resizeEvent(event);
+  updateVisibleItems();
+}
+
+void CfgView::updateVisibleItems() {
+  static_cast<CfgScene*>(scene())->updateVisibleItems();
+}
+
 void CfgView::wheelEvent(QWheelEvent *event) {
   if(event->modifiers() & Qt::ControlModifier) {
     if(event->delta() > 0) zoomInEvent();
@@ -174,6 +189,23 @@ QVector<AnalysisInfo> removeValid(QVector<AnalysisInfo> externalCalls) {
   return calls;
 }
 
+static QString hlsRange(int64_t min, int64_t max) {
+  if((min < 0) || (max < 0)) return "?";
+  if(min == max) return QString::number(min);
+  return QString::number(min) + "-" + QString::number(max);
+}
+
+static void getAllNestedLoops(Container *container, QVector<Loop*> &loops) {
+  QVector<Loop*> found;
+  container->getAllLoops(found, QVector<BasicBlock*>());
+  for(auto loop : found) {
+    if(!loops.contains(loop)) {
+      loops.push_back(loop);
+      getAllNestedLoops(loop, loops);
+    }
+  }
+}
+
 void CfgView::hlsAnalysisEvent() {
   AnalysisModel *analysisModel = new AnalysisModel(contextVertex->getCfgName());
 
@@ -225,6 +257,54 @@ void CfgView::hlsAnalysisEvent() {
   if(isMember) analysisModel->addType("Is a class member");
   if(hasPointerToPointerArg) analysisModel->addType("Has argument with pointer to pointer");
 
+  Container *container = dynamic_cast<Container*>(contextVertex);
+  if(container) {
+    QVector<Loop*> loops;
+    getAllNestedLoops(container, loops);
+
+    QVector<Container*> estimated;
+    if(container->hls.valid) estimated.push_back(container);
+    for(auto loop : loops) {
+      if(loop->hls.valid) estimated.push_back(loop);
+    }
+
+    if(estimated.size()) {
+      unsigned typeId = analysisModel->addType("HLS estimates vs. measurements");
+      for(auto cont : estimated) {
+        QString text = cont->getTableName() + ": " + hlsRange(cont->hls.latencyMin, cont->hls.latencyMax) + " cycles";
+        if(cont->isLoop()) {
+          text += ", trip count " + hlsRange(cont->hls.tripCountMin, cont->hls.tripCountMax);
+          if(cont->hls.ii) text += ", II " + QString::number(cont->hls.ii);
+        } else {
+          text += QString(", %1 BRAMs, %2 LUTs, %3 DSPs, %4 registers")
+            .arg(cont->hls.brams).arg(cont->hls.luts).arg(cont->hls.dsps).arg(cont->hls.regs);
+        }
+
+        double runtime, runtimeFrame;
+        double energy[Pmu::MAX_SENSORS];
+        double energyFrame[Pmu::MAX_SENSORS];
+        uint64_t count = 0;
+        cont->getProfData(Config::core, QVector<BasicBlock*>(), &runtime, energy, &runtimeFrame, energyFrame, &count);
+        if(count) text += QString(" (measured %1 s in %2 executions)").arg(runtime).arg(count);
+
+        analysisModel->addLine(typeId, text, cont->getSourceFilename(), cont->getSourceLineNumber());
+      }
+    }
+
+    QVector<Loop*> missedII;
+    for(auto loop : loops) {
+      if(loop->hls.missedII()) missedII.push_back(loop);
+    }
+
+    if(missedII.size()) {
+      unsigned typeId = analysisModel->addType("Has pipelined loops that did not reach II=1");
+      for(auto loop : missedII) {
+        analysisModel->addLine(typeId, loop->getTableName() + ": II " + QString::number(loop->hls.ii),
+                               loop->getSourceFilename(), loop->getSourceLineNumber());
+      }
+    }
+  }
+
   analysisView->setModel(NULL);
   analysisView->setModel(analysisModel);
   QSettings settings;
@@ -55,6 +55,9 @@ protected:
   void wheelEvent(QWheelEvent *event);
   void keyPressEvent(QKeyEvent *event);
   void contextMenuEvent(QContextMenuEvent *event);
+  void scrollContentsBy(int dx, int dy);
+  void resizeEvent(QResizeEvent *event);
+  void updateVisibleItems();
 
 public:
   CfgView(QTreeView *analysisView, QGraphicsScene *scene);
@@ -66,9 +69,11 @@ public:
 public slots:
   void zoomInEvent() {
     scale(SCALE_IN_FACTOR, SCALE_IN_FACTOR);
+    updateVisibleItems();
   }
   void zoomOutEvent() {
     scale(SCALE_OUT_FACTOR, SCALE_OUT_FACTOR);
+    updateVisibleItems();
   }
   void clearColorsEvent();
   void setTopEvent();
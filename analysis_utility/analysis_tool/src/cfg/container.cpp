@@ -34,7 +34,7 @@
 #include "loop.h"
 
 extern QColor edgeColors[];
-unsigned Container::exitNodeCounter = 0;
+std::atomic<unsigned> Container::exitNodeCounter(0);
 
 void Container::cycleRemoval() {
   for(auto child : children) {
@@ -614,7 +614,7 @@ void Container::displayEdge(Edge *edge, unsigned edgeNum) {
       targetY += getLocalVertex(target)->y;
     }
 
-    std::vector<LineSegment> lines;
+    QPainterPath path(QPointF(sourceX, sourceY));
 
     if((sourceRow - targetRow) > 1) {
       // edge is spanning more than one row
@@ -622,11 +622,11 @@ void Container::displayEdge(Edge *edge, unsigned edgeNum) {
       unsigned currentRoutingYSource = currentRoutingYs[sourceRow-1];
       unsigned currentRoutingYTarget = currentRoutingYs[targetRow];
 
-      lines.push_back(LineSegment(edge, new QGraphicsLineItem(sourceX, sourceY, sourceX, currentRoutingYSource, getBaseItem())));
-      lines.push_back(LineSegment(edge, new QGraphicsLineItem(sourceX, currentRoutingYSource, currentRoutingX, currentRoutingYSource, getBaseItem())));
-      lines.push_back(LineSegment(edge, new QGraphicsLineItem(currentRoutingX, currentRoutingYSource, currentRoutingX, currentRoutingYTarget, getBaseItem())));
-      lines.push_back(LineSegment(edge, new QGraphicsLineItem(currentRoutingX, currentRoutingYTarget, targetX, currentRoutingYTarget, getBaseItem())));
-      lines.push_back(LineSegment(edge, new QGraphicsLineItem(targetX, currentRoutingYTarget, targetX, targetY, getBaseItem())));
+      path.lineTo(sourceX, currentRoutingYSource);
+      path.lineTo(currentRoutingX, currentRoutingYSource);
+      path.lineTo(currentRoutingX, currentRoutingYTarget);
+      path.lineTo(targetX, currentRoutingYTarget);
+      path.lineTo(targetX, targetY);
       
       currentRoutingXs[targetColumn] -= LINE_CLEARANCE;
       currentRoutingYs[sourceRow-1] -= LINE_CLEARANCE;
@@ -636,13 +636,16 @@ void Container::displayEdge(Edge *edge, unsigned edgeNum) {
       // edge is between neighbouring rows
       unsigned currentRoutingY = currentRoutingYs[sourceRow-1];
 
-      lines.push_back(LineSegment(edge, new QGraphicsLineItem(sourceX, sourceY, sourceX, currentRoutingY, getBaseItem())));
-      lines.push_back(LineSegment(edge, new QGraphicsLineItem(sourceX, currentRoutingY, targetX, currentRoutingY, getBaseItem())));
-      lines.push_back(LineSegment(edge, new QGraphicsLineItem(targetX, currentRoutingY, targetX, targetY, getBaseItem())));
+      path.lineTo(sourceX, currentRoutingY);
+      path.lineTo(targetX, currentRoutingY);
+      path.lineTo(targetX, targetY);
       
       currentRoutingYs[sourceRow-1] -= LINE_CLEARANCE;
     }
 
+    std::vector<LineSegment> lines;
+    lines.push_back(LineSegment(edge, new EdgeItem(path, getBaseItem())));
+
     for(auto line : lines) {
       QPen pen = line.item->pen();
       if(edge->color == -1) {
@@ -807,7 +810,7 @@ void Container::getProfData(unsigned core, QVector<BasicBlock*> callStack,
   *count = cachedCount;
 }
 
-void Container::getMeasurements(unsigned core, QVector<BasicBlock*> callStack, QVector<Measurement> *measurements) {
+void Container::getMeasurements(unsigned core, QVector<BasicBlock*> callStack, QVector<MeasurementSpan> *measurements) {
   for(auto child : children) {
     child->getMeasurements(core, callStack, measurements);
   }
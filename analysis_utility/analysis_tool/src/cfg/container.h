@@ -24,6 +24,7 @@
 
 #include <assert.h>
 #include <unordered_set>
+#include <atomic>
 
 #include "analysis_tool.h"
 #include "vertex.h"
@@ -43,7 +44,7 @@ class Container : public Vertex {
   std::vector<unsigned> currentRoutingXs;
   std::vector<unsigned> currentRoutingYs;
 
-  static unsigned exitNodeCounter;
+  static std::atomic<unsigned> exitNodeCounter;
 
   std::map<QString,Vertex*> idVertexCache;
 
@@ -69,6 +70,8 @@ public:
 
   unsigned treeviewRow;
 
+  HlsInfo hls;
+
   Container(QString id, QString name, Container *parent, unsigned treeviewRow, QString sourceFilename = "", unsigned sourceLineNumber = 1, unsigned sourceColumn = 1) : Vertex(id, name, parent, sourceFilename, sourceLineNumber, sourceColumn) {
     expanded = false;
     this->treeviewRow = treeviewRow;
@@ -206,7 +209,7 @@ public:
   //---------------------------------------------------------------------------
   // profiling data
   
-  virtual void getMeasurements(unsigned core, QVector<BasicBlock*> callStack, QVector<Measurement> *measurements);
+  virtual void getMeasurements(unsigned core, QVector<BasicBlock*> callStack, QVector<MeasurementSpan> *measurements);
 
   virtual void getProfData(unsigned core, QVector<BasicBlock*> callStack,
                            double *runtime, double *energy, double *runtimeFrame, double *energyFrame, uint64_t *count);
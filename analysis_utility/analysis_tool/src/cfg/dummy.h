@@ -48,7 +48,7 @@ public:
     target->setLineSegmentsTarget(lines);
   }
 
-  virtual void appendItems(QGraphicsItem *parent, Vertex *visualTop, QVector<BasicBlock*> callStack, float scaling) {
+  virtual void appendItems(CfgItem *parent, Vertex *visualTop, QVector<BasicBlock*> callStack, float scaling) {
     width = 0;
     height = 0;
     lineSegments.clear();
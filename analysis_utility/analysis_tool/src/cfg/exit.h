@@ -36,13 +36,13 @@ public:
   virtual QString getSourceFilename();
   virtual std::vector<unsigned> getSourceLineNumber();
 
-  virtual void appendItems(QGraphicsItem *parent, Vertex *visualTop, QVector<BasicBlock*> callStack, float scaling) {
+  virtual void appendItems(CfgItem *parent, Vertex *visualTop, QVector<BasicBlock*> callStack, float scaling) {
     QPolygonF polygon;
     polygon << QPointF(INPUTOUTPUT_SIZE/2,INPUTOUTPUT_SIZE)
             << QPointF(0, 0)
             << QPointF(INPUTOUTPUT_SIZE, 0);
 
-    baseItems.push(new QGraphicsPolygonItem(polygon, parent));
+    baseItems.push(new VertexItem(polygon, parent));
 
     getBaseItem()->setData(0, QVariant::fromValue((void*)this));
     getBaseItem()->setData(1, makeQVariant(callStack));
@@ -22,15 +22,69 @@
 #ifndef LINESEGMENT_H
 #define LINESEGMENT_H
 
-#include <QGraphicsLineItem>
+#include <QGraphicsPathItem>
+#include <QPainterPathStroker>
+#include <QPen>
 #include "edge.h"
+#include "cfgitem.h"
+
+// Layout record for a routed edge, all segments are kept in a single path
+class EdgeItem : public CfgItem {
+  QPainterPath path;
+  QPen itemPen;
+
+public:
+  EdgeItem(const QPainterPath &path, CfgItem *parent) : CfgItem(parent), path(path) {}
+
+  QPen pen() const {
+    return itemPen;
+  }
+  void setPen(const QPen &pen) {
+    itemPen = pen;
+    if(item) static_cast<QGraphicsPathItem*>(item)->setPen(pen);
+  }
+
+  QRectF boundingRect() const {
+    qreal w = itemPen.widthF() ? itemPen.widthF() : 1;
+    return path.boundingRect().adjusted(-w, -w, w, w);
+  }
+
+  int itemType() const {
+    return EDGE;
+  }
+  QGraphicsItem *createItem() const;
+  void updateItem(QGraphicsItem *item) const {
+    CfgItem::updateItem(item);
+    QGraphicsPathItem *pathItem = static_cast<QGraphicsPathItem*>(item);
+    pathItem->setPath(path);
+    pathItem->setPen(itemPen);
+  }
+};
+
+// Graphics item showing an EdgeItem
+class EdgeGraphicsItem : public QGraphicsPathItem {
+public:
+  EdgeGraphicsItem() : QGraphicsPathItem() {}
+
+  // the default path item shape includes the area enclosed by the path,
+  // which would hide the vertices below from itemAt()
+  QPainterPath shape() const {
+    QPainterPathStroker stroker;
+    stroker.setWidth(pen().widthF() ? pen().widthF() : 1);
+    return stroker.createStroke(path());
+  }
+};
+
+inline QGraphicsItem *EdgeItem::createItem() const {
+  return new EdgeGraphicsItem();
+}
 
 class LineSegment {
 public:
   Edge *edge;
-  QGraphicsLineItem *item;
+  EdgeItem *item;
 
-  LineSegment(Edge *edge, QGraphicsLineItem *item) {
+  LineSegment(Edge *edge, EdgeItem *item) {
     this->edge = edge;
     this->item = item;
   }
@@ -31,7 +31,6 @@
 #include "cfg.h"
 #include "dummy.h"
 #include "region.h"
-#include "textitem.h"
 
 void Vertex::reverseEdge(Edge *edge) {
   Vertex *target = edge->target;
@@ -69,7 +68,7 @@ void Vertex::reverseEdge(Edge *edge) {
 
 }
 
-void Vertex::appendItems(QGraphicsItem *parent, Vertex *visualTop, QVector<BasicBlock*> callStack, float scaling) {
+void Vertex::appendItems(CfgItem *parent, Vertex *visualTop, QVector<BasicBlock*> callStack, float scaling) {
   unsigned xx = 0;
   unsigned yy = 0;
 
@@ -79,7 +78,7 @@ void Vertex::appendItems(QGraphicsItem *parent, Vertex *visualTop, QVector<Basic
   height = 0;
 
   // create base item (rectangle)
-  baseItems.push(new QGraphicsPolygonItem(parent));
+  baseItems.push(new VertexItem(parent));
   getBaseItem()->setPos(QPointF(x, y));
   getBaseItem()->setData(0, QVariant::fromValue((void*)this));
   getBaseItem()->setData(1, makeQVariant(callStack));
@@ -210,26 +209,20 @@ void Vertex::appendItems(QGraphicsItem *parent, Vertex *visualTop, QVector<Basic
   xx = TEXT_CLEARANCE;
   yy += TEXT_CLEARANCE;
 
-  TextItem *text = new TextItem(getCfgName(), getBaseItem());
-  text->setPos(QPointF(xx, yy));
-  text->setData(0, QVariant::fromValue((void*)this));
-  text->setData(1, makeQVariant(callStack));
+  QSizeF textSize = getBaseItem()->addText(getCfgName(), QPointF(xx, yy));
 
-  unsigned textwidth = text->boundingRect().width() + TEXT_CLEARANCE*2;
+  unsigned textwidth = textSize.width() + TEXT_CLEARANCE*2;
   if(textwidth > width) width = textwidth;
-  yy += text->boundingRect().height();
+  yy += textSize.height();
 
   if(Config::includeId) {
     // create id text
     xx = TEXT_CLEARANCE;
     yy += TEXT_CLEARANCE;
-    text = new TextItem(id, getBaseItem());
-    text->setPos(QPointF(xx, yy));
-    text->setData(0, QVariant::fromValue((void*)this));
-    text->setData(1, makeQVariant(callStack));
-    textwidth = text->boundingRect().width() + TEXT_CLEARANCE*2;
+    textSize = getBaseItem()->addText(id, QPointF(xx, yy));
+    textwidth = textSize.width() + TEXT_CLEARANCE*2;
     if(textwidth > width) width = textwidth;
-    yy += text->boundingRect().height();
+    yy += textSize.height();
   }
 
   if(Config::includeProfData && (Config::colorMode != Config::STRUCT) && (profData != 0)) {
@@ -237,27 +230,16 @@ void Vertex::appendItems(QGraphicsItem *parent, Vertex *visualTop, QVector<Basic
     xx = TEXT_CLEARANCE;
     yy += TEXT_CLEARANCE;
     if(isFunction()) {
-      text = new TextItem("Profile: " + QString::number(profData) + " Count: " + QString::number(count), getBaseItem());
+      textSize = getBaseItem()->addText("Profile: " + QString::number(profData) + " Count: " + QString::number(count), QPointF(xx, yy));
     } else {
-      text = new TextItem("Profile: " + QString::number(profData), getBaseItem());
+      textSize = getBaseItem()->addText("Profile: " + QString::number(profData), QPointF(xx, yy));
     }
-    text->setPos(QPointF(xx, yy));
-    text->setData(0, QVariant::fromValue((void*)this));
-    text->setData(1, makeQVariant(callStack));
-    textwidth = text->boundingRect().width() + TEXT_CLEARANCE*2;
+    textwidth = textSize.width() + TEXT_CLEARANCE*2;
     if(textwidth > width) width = textwidth;
-    yy += text->boundingRect().height();
+    yy += textSize.height();
   }
 
-  QGraphicsPolygonItem *innerPoly = NULL;
-
   if(isContainer()) {
-    innerPoly = new QGraphicsPolygonItem(getBaseItem());
-    innerPoly->setPos(QPointF(LINE_CLEARANCE, yy + LINE_CLEARANCE));
-    innerPoly->setData(0, QVariant::fromValue((void*)this));
-    innerPoly->setData(1, makeQVariant(callStack));
-    innerPoly->setBrush(BACKGROUND_COLOR);
-
     appendLocalItems(LINE_CLEARANCE, yy + LINE_CLEARANCE, visualTop, callStack, scaling);
 
   } else {
@@ -272,11 +254,11 @@ void Vertex::appendItems(QGraphicsItem *parent, Vertex *visualTop, QVector<Basic
 
   if(isContainer()) {
     QPolygonF polygon;
-    polygon << QPointF(0, 0)
-            << QPointF(width, 0)
-            << QPointF(width, height-yy-LINE_CLEARANCE)
-            << QPointF(0, height-yy-LINE_CLEARANCE);
-    innerPoly->setPolygon(polygon);
+    polygon << QPointF(LINE_CLEARANCE, yy + LINE_CLEARANCE)
+            << QPointF(LINE_CLEARANCE + width, yy + LINE_CLEARANCE)
+            << QPointF(LINE_CLEARANCE + width, height)
+            << QPointF(LINE_CLEARANCE, height);
+    getBaseItem()->setInnerPolygon(polygon);
     width += 2*LINE_CLEARANCE;
     height += LINE_CLEARANCE;
   }
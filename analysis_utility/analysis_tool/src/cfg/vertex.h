@@ -32,12 +32,12 @@
 #include <QDomDocument>
 #include <QAbstractItemModel>
 #include <QModelIndex>
-#include <QGraphicsPolygonItem>
 
 #include "analysis_tool.h"
 #include "config/config.h"
 #include "edge.h"
 #include "linesegment.h"
+#include "vertexitem.h"
 #include "analysis_tool.h"
 #include "profile/profline.h"
 
@@ -68,12 +68,45 @@ public:
 
 ///////////////////////////////////////////////////////////////////////////////
 
+// estimates from the Vivado HLS synthesis report, -1 where HLS could not tell
+class HlsInfo {
+public:
+  bool valid;
+  int64_t tripCountMin;
+  int64_t tripCountMax;
+  int64_t latencyMin;
+  int64_t latencyMax;
+  int64_t iterationLatency;
+  int64_t ii; // achieved initiation interval, 0 if not pipelined
+
+  // resources, only for functions
+  double brams;
+  double luts;
+  double dsps;
+  double regs;
+
+  HlsInfo() {
+    valid = false;
+    tripCountMin = tripCountMax = -1;
+    latencyMin = latencyMax = -1;
+    iterationLatency = -1;
+    ii = 0;
+    brams = luts = dsps = regs = 0;
+  }
+
+  bool missedII() {
+    return valid && (ii > 1);
+  }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
 class Vertex {
   std::vector<QString> edgeIds;
 
 protected:
 
-  std::stack<QGraphicsPolygonItem*> baseItems;
+  std::stack<VertexItem*> baseItems;
   std::vector<LineSegment> lineSegments;
 
 public:
@@ -274,7 +307,7 @@ public:
   // graphics
 
   // appends QGraphicsItems representing this element to the given parent
-  virtual void appendItems(QGraphicsItem *parent, Vertex *visualTop, QVector<BasicBlock*> callStack, float scaling);
+  virtual void appendItems(CfgItem *parent, Vertex *visualTop, QVector<BasicBlock*> callStack, float scaling);
 
   virtual void appendLocalItems(int xx, int yy, Vertex *visualTop, QVector<BasicBlock*> callStack, float scaling) {
     height = yy + LINE_CLEARANCE;
@@ -286,7 +319,7 @@ public:
   }
 
   // return current baseitem
-  virtual QGraphicsPolygonItem *getBaseItem() {
+  virtual VertexItem *getBaseItem() {
     assert(baseItems.size());
     return baseItems.top();
   }
@@ -366,7 +399,7 @@ public:
     }
   }
 
-  virtual void getMeasurements(unsigned core, QVector<BasicBlock*> callStack, QVector<Measurement> *measurements) {}
+  virtual void getMeasurements(unsigned core, QVector<BasicBlock*> callStack, QVector<MeasurementSpan> *measurements) {}
 
   virtual void buildProfTable(unsigned core, std::vector<ProfLine*> &table, bool forModel = false) {}
 
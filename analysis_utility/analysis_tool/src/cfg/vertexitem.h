@@ -0,0 +1,131 @@
+/******************************************************************************
+ *
+ *  This file is part of the TULIPP Analysis Utility
+ *
+ *  Copyright 2018 Asbjørn Djupdal, NTNU, TULIPP EU Project
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *****************************************************************************/
+
+#ifndef VERTEXITEM_H
+#define VERTEXITEM_H
+
+#include <QGraphicsPolygonItem>
+#include <QStyleOptionGraphicsItem>
+#include <QFontMetricsF>
+#include <QPainter>
+
+#include "analysis_tool.h"
+#include "cfgitem.h"
+
+// Layout record for a single CFG vertex.
+// The vertex texts and the inner polygon of expanded containers are painted by
+// the vertex graphics item itself instead of being separate child items, and
+// text is skipped altogether when zoomed out too far to be readable.
+
+class VertexItem : public CfgItem {
+  QPolygonF polygonShape;
+  QBrush itemBrush;
+  QVector<QPointF> textPositions;
+  QStringList texts;
+  QPolygonF innerPolygon;
+  QFont font;
+
+public:
+  VertexItem(CfgItem *parent) : CfgItem(parent) {}
+  VertexItem(const QPolygonF &polygon, CfgItem *parent) : CfgItem(parent), polygonShape(polygon) {}
+
+  // add a line of text at the given position, returns the size of the text
+  QSizeF addText(const QString &text, QPointF pos) {
+    QFontMetricsF fm(font);
+    texts << text;
+    textPositions.push_back(pos);
+    return QSizeF(fm.width(text), fm.height());
+  }
+
+  void setInnerPolygon(const QPolygonF &polygon) {
+    innerPolygon = polygon;
+  }
+
+  void setPolygon(const QPolygonF &polygon) {
+    polygonShape = polygon;
+  }
+
+  void setBrush(const QBrush &brush) {
+    itemBrush = brush;
+  }
+
+  QRectF boundingRect() const {
+    return polygonShape.boundingRect().adjusted(-1, -1, 1, 1);
+  }
+
+  int itemType() const {
+    return VERTEX;
+  }
+  QGraphicsItem *createItem() const;
+  void updateItem(QGraphicsItem *item) const;
+
+  void paintContents(QPainter *painter, const QStyleOptionGraphicsItem *option) const {
+    if(!innerPolygon.isEmpty()) {
+      painter->setBrush(BACKGROUND_COLOR);
+      painter->drawPolygon(innerPolygon);
+    }
+
+    if(texts.size() && (option->levelOfDetailFromTransform(painter->worldTransform()) >= CFG_TEXT_MIN_LOD)) {
+      if(itemBrush.color().lightness() >= 128) {
+        painter->setPen(Qt::black);
+      } else {
+        painter->setPen(Qt::white);
+      }
+      painter->setFont(font);
+      for(int i = 0; i < texts.size(); i++) {
+        painter->drawText(QRectF(textPositions[i], QSizeF()), Qt::AlignLeft | Qt::AlignTop | Qt::TextDontClip, texts[i]);
+      }
+    }
+  }
+};
+
+// Graphics item showing a VertexItem, reused for other vertices when scrolled out of view
+class VertexGraphicsItem : public QGraphicsPolygonItem {
+  const VertexItem *record;
+
+public:
+  VertexGraphicsItem() : QGraphicsPolygonItem() {
+    record = NULL;
+  }
+
+  void setRecord(const VertexItem *record) {
+    this->record = record;
+  }
+
+  void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) {
+    QGraphicsPolygonItem::paint(painter, option, widget);
+    if(record) record->paintContents(painter, option);
+  }
+};
+
+inline QGraphicsItem *VertexItem::createItem() const {
+  return new VertexGraphicsItem();
+}
+
+inline void VertexItem::updateItem(QGraphicsItem *item) const {
+  CfgItem::updateItem(item);
+  VertexGraphicsItem *vertexItem = static_cast<VertexGraphicsItem*>(item);
+  vertexItem->setRecord(this);
+  vertexItem->setPolygon(polygonShape);
+  vertexItem->setBrush(itemBrush);
+}
+
+#endif
@@ -44,6 +44,11 @@ unsigned Config::sensor;
 unsigned Config::window;
 unsigned Config::sdsocVersion;
 QString Config::extraCompileOptions;
+QString Config::buildCacheDir;
+unsigned Config::buildCacheSize;
+QString Config::dseWorkers;
+QString Config::dseWorkerSecret;
+unsigned Config::makeJobs;
 QString Config::projectDir;
 double Config::overrideSamplePeriod;
 bool Config::overrideSamplePc;
@@ -52,3 +57,4 @@ bool Config::functionsInTable;
 bool Config::regionsInTable;
 bool Config::loopsInTable;
 bool Config::basicblocksInTable;
+bool Config::openGlGraph;
@@ -131,6 +131,11 @@ public:
   static unsigned window;
   static unsigned sdsocVersion;
   static QString extraCompileOptions;
+  static QString buildCacheDir;
+  static unsigned buildCacheSize;
+  static QString dseWorkers;
+  static QString dseWorkerSecret;
+  static unsigned makeJobs;
   static QString projectDir;
   static double overrideSamplePeriod;
   static bool overrideSamplePc;
@@ -139,6 +144,7 @@ public:
   static bool regionsInTable;
   static bool loopsInTable;
   static bool basicblocksInTable;
+  static bool openGlGraph;
 };
 
 #endif
@@ -128,6 +128,14 @@ BuildPage::BuildPage(QWidget *parent) : QWidget(parent) {
   linkerppUsLayout->addWidget(linkerppUsLabel);
   linkerppUsLayout->addWidget(linkerppUsEdit);
 
+  QLabel *makeJobsLabel = new QLabel("Parallel make jobs:");
+  makeJobsSpinBox = new QSpinBox;
+  makeJobsSpinBox->setRange(1, 256);
+  makeJobsSpinBox->setValue(Config::makeJobs);
+  QHBoxLayout *makeJobsLayout = new QHBoxLayout;
+  makeJobsLayout->addWidget(makeJobsLabel);
+  makeJobsLayout->addWidget(makeJobsSpinBox);
+
   QVBoxLayout *toolLayout = new QVBoxLayout;
   toolLayout->addLayout(cmakeLayout);
   toolLayout->addLayout(clangLayout);
@@ -142,13 +150,61 @@ BuildPage::BuildPage(QWidget *parent) : QWidget(parent) {
   toolLayout->addLayout(asUsLayout);
   toolLayout->addLayout(linkerUsLayout);
   toolLayout->addLayout(linkerppUsLayout);
+  toolLayout->addLayout(makeJobsLayout);
 
   toolGroup->setLayout(toolLayout);
 
   //---------------------------------------------------------------------------
 
+  QGroupBox *cacheGroup = new QGroupBox("Build cache");
+
+  QLabel *buildCacheDirLabel = new QLabel("Cache directory (empty to disable):");
+  buildCacheDirEdit = new QLineEdit(Config::buildCacheDir);
+  QHBoxLayout *buildCacheDirLayout = new QHBoxLayout;
+  buildCacheDirLayout->addWidget(buildCacheDirLabel);
+  buildCacheDirLayout->addWidget(buildCacheDirEdit);
+
+  QLabel *buildCacheSizeLabel = new QLabel("Cache size limit in MB (0 for no limit):");
+  buildCacheSizeSpinBox = new QSpinBox;
+  buildCacheSizeSpinBox->setRange(0, 10000000);
+  buildCacheSizeSpinBox->setValue(Config::buildCacheSize);
+  QHBoxLayout *buildCacheSizeLayout = new QHBoxLayout;
+  buildCacheSizeLayout->addWidget(buildCacheSizeLabel);
+  buildCacheSizeLayout->addWidget(buildCacheSizeSpinBox);
+
+  QVBoxLayout *cacheLayout = new QVBoxLayout;
+  cacheLayout->addLayout(buildCacheDirLayout);
+  cacheLayout->addLayout(buildCacheSizeLayout);
+  cacheGroup->setLayout(cacheLayout);
+
+  //---------------------------------------------------------------------------
+
+  QGroupBox *dseGroup = new QGroupBox("DSE workers");
+
+  QLabel *dseWorkersLabel = new QLabel("Worker addresses (comma separated, empty to build locally):");
+  dseWorkersEdit = new QLineEdit(Config::dseWorkers);
+  QHBoxLayout *dseWorkersLayout = new QHBoxLayout;
+  dseWorkersLayout->addWidget(dseWorkersLabel);
+  dseWorkersLayout->addWidget(dseWorkersEdit);
+
+  QLabel *dseWorkerSecretLabel = new QLabel("Shared secret (required for TCP workers):");
+  dseWorkerSecretEdit = new QLineEdit(Config::dseWorkerSecret);
+  dseWorkerSecretEdit->setEchoMode(QLineEdit::Password);
+  QHBoxLayout *dseWorkerSecretLayout = new QHBoxLayout;
+  dseWorkerSecretLayout->addWidget(dseWorkerSecretLabel);
+  dseWorkerSecretLayout->addWidget(dseWorkerSecretEdit);
+
+  QVBoxLayout *dseLayout = new QVBoxLayout;
+  dseLayout->addLayout(dseWorkersLayout);
+  dseLayout->addLayout(dseWorkerSecretLayout);
+  dseGroup->setLayout(dseLayout);
+
+  //---------------------------------------------------------------------------
+
   QVBoxLayout *mainLayout = new QVBoxLayout;
   mainLayout->addWidget(toolGroup);
+  mainLayout->addWidget(cacheGroup);
+  mainLayout->addWidget(dseGroup);
   mainLayout->addStretch(1);
   setLayout(mainLayout);
 }
@@ -196,9 +252,21 @@ VisualisationPage::VisualisationPage(QWidget *parent) : QWidget(parent) {
 
   //---------------------------------------------------------------------------
 
+  QGroupBox *graphGroup = new QGroupBox("Profile graph");
+
+  openGlCheckBox = new QCheckBox("Use OpenGL if available");
+  openGlCheckBox->setCheckState(Config::openGlGraph ? Qt::Checked : Qt::Unchecked);
+
+  QVBoxLayout *graphLayout = new QVBoxLayout;
+  graphLayout->addWidget(openGlCheckBox);
+  graphGroup->setLayout(graphLayout);
+
+  //---------------------------------------------------------------------------
+
   QVBoxLayout *mainLayout = new QVBoxLayout;
   mainLayout->addWidget(cfgGroup);
   mainLayout->addWidget(tableGroup);
+  mainLayout->addWidget(graphGroup);
   mainLayout->addStretch(1);
   setLayout(mainLayout);
 }
@@ -293,8 +361,14 @@ void ConfigDialog::closeEvent(QCloseEvent *e) {
   Config::asUs = buildPage->asUsEdit->text();
   Config::linkerUs = buildPage->linkerUsEdit->text();
   Config::linkerppUs = buildPage->linkerppUsEdit->text();
+  Config::buildCacheDir = buildPage->buildCacheDirEdit->text();
+  Config::buildCacheSize = buildPage->buildCacheSizeSpinBox->value();
+  Config::dseWorkers = buildPage->dseWorkersEdit->text();
+  Config::dseWorkerSecret = buildPage->dseWorkerSecretEdit->text();
+  Config::makeJobs = buildPage->makeJobsSpinBox->value();
   Config::functionsInTable = visualisationPage->functionsCheckBox->checkState() == Qt::Checked;
   Config::regionsInTable = visualisationPage->regionsCheckBox->checkState() == Qt::Checked;
   Config::loopsInTable = visualisationPage->loopsCheckBox->checkState() == Qt::Checked;
   Config::basicblocksInTable = visualisationPage->basicblocksCheckBox->checkState() == Qt::Checked;
+  Config::openGlGraph = visualisationPage->openGlCheckBox->checkState() == Qt::Checked;
 }
@@ -59,6 +59,14 @@ public:
   QLineEdit *linkerUsEdit;
   QLineEdit *linkerppUsEdit;
 
+  QSpinBox *makeJobsSpinBox;
+
+  QLineEdit *buildCacheDirEdit;
+  QSpinBox *buildCacheSizeSpinBox;
+
+  QLineEdit *dseWorkersEdit;
+  QLineEdit *dseWorkerSecretEdit;
+
   BuildPage(QWidget *parent = 0);
 };
 
@@ -75,6 +83,8 @@ public:
   QCheckBox *loopsCheckBox;
   QCheckBox *basicblocksCheckBox;
 
+  QCheckBox *openGlCheckBox;
+
   VisualisationPage(QWidget *parent = 0);
 };
 
@@ -20,13 +20,17 @@
  *****************************************************************************/
 
 #include <fstream>
+#include <QTemporaryFile>
 
 #include "dse.h"
 #include "cfg/loop.h"
+#include "cfg/function.h"
 #include "cfg/instruction.h"
 #include "dseresultdialog.h"
 #include "dsealgorithm.h"
 #include "exhaustive.h"
+#include "ga.h"
+#include "nsga2.h"
 
 unsigned Dse::loopDepth(Loop *loop) {
   unsigned depth = 1;
@@ -42,62 +46,200 @@ unsigned Dse::loopDepth(Loop *loop) {
   return depth;
 }
 
-unsigned numberOfSolutions(QVector<unsigned> loopDepths) {
-  if(!loopDepths.size()) return 0;
+void Dse::load() {
+  clear();
 
-  unsigned x = loopDepths[0] + 1;
-  for(int i = 1; i < loopDepths.size(); i++) {
-    x *= loopDepths[i] + 1;
+  if(QFile::exists(DSE_RESULTS_FILE)) {
+    if(store.open(DSE_RESULTS_FILE)) {
+      moduleId = store.getMeta("moduleId");
+      containerId = store.getMeta("containerId");
+      algorithm = store.getMeta("algorithm").toUInt();
+      fitnessChoice = store.getMeta("fitnessChoice").toUInt();
+      store.load();
+    }
+
+  } else if(QFile::exists("results.dse")) {
+    // text format of older versions, converted to the database when the DSE is run again
+    std::ifstream inputFile("results.dse");
+    inputFile >> *this;
+    inputFile.close();
   }
-  return x;
 }
 
-void Dse::dialog(Container *cont) {
-  dseAlgorithm = NULL;
+void Dse::findGenes(Container *cont) {
+  genes.clear();
 
-  // detect loops
-  loops.clear();
+  // pipelining, one gene for each outer loop telling which depth to pipeline
+  QVector<Loop*> loops;
   cont->getAllLoops(loops, QVector<BasicBlock*>());
-  QVector<unsigned> loopDepths;
   for(auto loop : loops) {
-    loopDepths.push_back(loopDepth(loop));
+    genes.push_back(DseGene(DSE_GENE_PIPELINE, loop, loopDepth(loop)));
   }
 
-  DseDialog dialog(numberOfSolutions(loopDepths));
+  // unrolling, one gene for each loop at any depth
+  QVector<Loop*> allLoops;
+  while(loops.size()) {
+    Loop *loop = loops.takeFirst();
+    if(!allLoops.contains(loop)) {
+      allLoops.push_back(loop);
+      loop->getAllLoops(loops, QVector<BasicBlock*>());
+    }
+  }
+  for(auto loop : allLoops) {
+    genes.push_back(DseGene(DSE_GENE_UNROLL, loop));
+  }
+
+  // the source tool lists functions and arrays in the source files
+  QMap<QString,QString> functionFiles;
+  QMap<QString,QStringList> calls;
+  QVector<QStringList> arrays;
+
+  Function *top = cont->getFunction();
+  QStringList files = cont->getSourceHierarchy(QVector<BasicBlock*>());
+  if(top && !files.contains(top->getSourceFilename())) files << top->getSourceFilename();
+
+  for(auto file : files) {
+    if(isSystemFile(file)) continue;
+
+    QFileInfo fileInfo(file);
+
+    QString opt;
+    if(fileInfo.suffix() == "c") {
+      opt = mainProject->cOptions + " " + mainProject->cSysInc;
+    } else if((fileInfo.suffix() == "cpp") || (fileInfo.suffix() == "cc")) {
+      opt = mainProject->cppOptions + " " + mainProject->cppSysInc;
+    } else {
+      continue;
+    }
+
+    QTemporaryFile listFile;
+    if(!listFile.open()) continue;
+
+    if(mainProject->runSourceTool(file, listFile.fileName(), QStringList() << "-list", opt)) continue;
+
+    QTextStream in(&listFile);
+    while(!in.atEnd()) {
+      QStringList tokens = in.readLine().split(' ', QString::SkipEmptyParts);
+
+      if((tokens.size() >= 3) && (tokens[0] == "function")) {
+        functionFiles[tokens[1]] = file;
+        calls[tokens[1]] = tokens.mid(3);
+
+      } else if((tokens.size() == 5) && (tokens[0] == "array")) {
+        arrays.push_back(QStringList() << file << tokens.mid(1));
+      }
+    }
+  }
+
+  // only functions called from the explored function are of interest
+  QStringList functions;
+  if(top) functions << top->name.split("::").last();
+  for(int i = 0; i < functions.size(); i++) {
+    for(auto callee : calls[functions[i]]) {
+      if(functionFiles.contains(callee) && !functions.contains(callee)) functions << callee;
+    }
+  }
+
+  for(auto array : arrays) {
+    if(functions.contains(array[1])) {
+      genes.push_back(DseGene(DSE_GENE_PARTITION, array[0], array[2], array[3], array[4].toUInt()));
+    }
+  }
+
+  for(int i = 0; i < functions.size(); i++) {
+    if(!functionFiles.contains(functions[i])) continue;
+
+    genes.push_back(DseGene(DSE_GENE_DATAFLOW, functionFiles[functions[i]], functions[i]));
+
+    // inlining the explored function itself makes no sense
+    if(i > 0) genes.push_back(DseGene(DSE_GENE_INLINE, functionFiles[functions[i]], functions[i]));
+  }
+}
+
+void Dse::dialog(Container *cont) {
+  dseAlgorithm = NULL;
+
+  QApplication::setOverrideCursor(Qt::WaitCursor);
+  findGenes(cont);
+  QApplication::restoreOverrideCursor();
+
+  DseDialog dialog(genes, objectives, constraints);
   dialog.exec();
 
-  if(dialog.shouldRun && (dialog.loopsCheckBox->checkState() == Qt::Checked)) {
+  QVector<unsigned> geneMax = dialog.getGeneMax();
+
+  if(dialog.shouldRun && (DseDialog::numberOfSolutions(geneMax) > 1)) {
     if((containerId != cont->id) || (moduleId != cont->getModule()->id)) {
       clear();
     }
 
     fitnessChoice = dialog.fitnessCombo->currentIndex();
+    objectives = dialog.getObjectives();
+    constraints = dialog.getConstraints();
     containerId = cont->id;
     moduleId = cont->getModule()->id;
     algorithm = dialog.algCombo->currentIndex();
 
-    outputFile = new std::ofstream("results.dse"); 
+    // results are committed to the database one by one, so that an interrupted DSE can be resumed
+    if(!store.open(DSE_RESULTS_FILE)) {
+      QMessageBox msgBox;
+      msgBox.setText("Can't open DSE results database");
+      msgBox.exec();
+      return;
+    }
 
-    (*outputFile) << *this << '\n';;
-    outputFile->flush();
+    store.setMeta("moduleId", moduleId);
+    store.setMeta("containerId", containerId);
+    store.setMeta("algorithm", QString::number(algorithm));
+    store.setMeta("fitnessChoice", QString::number(fitnessChoice));
+    store.save();
 
     // search for best solution
     switch(algorithm) {
-      case 0: {
-        QMessageBox msgBox;
-        msgBox.setText("GA not implemented");
-        msgBox.exec();
+      case 0:
+        dseAlgorithm = new Ga(mainProject, fitnessChoice, &dseRuns, &store, genes, geneMax,
+                              dialog.rerunFailedCheckBox->checkState() == Qt::Checked,
+                              dialog.buildJobsSpinBox->value(),
+                              dialog.populationSpinBox->value(), dialog.generationsSpinBox->value());
+        break;
+      case 2:
+        if(!objectives.size()) {
+          QMessageBox msgBox;
+          msgBox.setText("No objectives selected");
+          msgBox.exec();
+          break;
+        }
+        dseAlgorithm = new Nsga2(mainProject, &dseRuns, &store, genes, geneMax,
+                                 dialog.rerunFailedCheckBox->checkState() == Qt::Checked,
+                                 dialog.buildJobsSpinBox->value(),
+                                 dialog.populationSpinBox->value(), dialog.generationsSpinBox->value(),
+                                 objectives, constraints);
         break;
-      }
       case 1:
-        dseAlgorithm = new Exhaustive(mainProject, fitnessChoice, &dseRuns, outputFile, loops, loopDepths,
-                                      dialog.rerunFailedCheckBox->checkState() == Qt::Checked);
+        dseAlgorithm = new Exhaustive(mainProject, fitnessChoice, &dseRuns, &store, genes, geneMax,
+                                      dialog.rerunFailedCheckBox->checkState() == Qt::Checked,
+                                      dialog.buildJobsSpinBox->value());
         break;
     }
 
     if(dseAlgorithm) {
+      // NSGA-II needs measured values for all objectives, so it always builds and profiles completely
+      if(algorithm != 2) {
+        dseAlgorithm->setSurrogateKeep(dialog.surrogateSpinBox->value() / 100.0);
+        dseAlgorithm->setEarlyAbort(dialog.earlyAbortCheckBox->checkState() == Qt::Checked);
+      }
+
+      QStringList workers;
+      for(auto worker : Config::dseWorkers.split(',', QString::SkipEmptyParts)) {
+        workers << worker.trimmed();
+      }
+      dseAlgorithm->setWorkers(workers);
+
       QApplication::setOverrideCursor(Qt::WaitCursor);
-      progDialog = new QProgressDialog(QString("Running DSE..."), QString(), 0, numberOfSolutions(loopDepths), NULL);
+      unsigned maxRuns = std::min(DseDialog::numberOfSolutions(geneMax), (double)INT_MAX);
+      if(algorithm != 1) maxRuns = dialog.populationSpinBox->value() * dialog.generationsSpinBox->value();
+
+      progDialog = new QProgressDialog(QString("Running DSE..."), QString(), 0, maxRuns, NULL);
       progDialog->setWindowModality(Qt::WindowModal);
       progDialog->setMinimumDuration(0);
       progDialog->setValue(0);
@@ -115,10 +257,6 @@ void Dse::finished() {
   delete progDialog;
   progDialog = NULL;
 
-  outputFile->close();
-  delete outputFile;
-  outputFile = NULL;
-
   disconnect(&thread, SIGNAL (started()), 0, 0);
   disconnect(dseAlgorithm, SIGNAL(advance(int)), 0, 0);
   disconnect(dseAlgorithm, SIGNAL(finished()), 0, 0);
@@ -137,10 +275,11 @@ void Dse::showResults() {
     assert(mod);
     Container *cont = static_cast<Container*>(mod->getVertexById(containerId));
     assert(cont);
-    loops.clear();
-    cont->getAllLoops(loops, QVector<BasicBlock*>());
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+    findGenes(cont);
+    QApplication::restoreOverrideCursor();
 
-    DseResultDialog resultDialog(mainProject, &dseRuns, fitnessChoice, loops);
+    DseResultDialog resultDialog(mainProject, &dseRuns, fitnessChoice, objectives, constraints, genes);
     resultDialog.exec();
   } else {
     QMessageBox msgBox;
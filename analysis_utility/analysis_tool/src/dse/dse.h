@@ -27,36 +27,37 @@
 #include "project/project.h"
 #include "dserun.h"
 #include "dsealgorithm.h"
+#include "pareto.h"
 
 class Dse : public QObject {
   Q_OBJECT
 
 private:
   QVector<DseRun> dseRuns;
+  DseStore store;
   Sdsoc *mainProject;
   unsigned fitnessChoice;
+  QVector<unsigned> objectives;
+  DseConstraints constraints;
   unsigned algorithm;
   QString containerId;
   QString moduleId;
-  QVector<Loop*> loops;
+  QVector<DseGene> genes;
   Cfg *cfg;
   QProgressDialog *progDialog;
   QThread thread;
-  std::ofstream *outputFile; 
   DseAlgorithm *dseAlgorithm;
 
   unsigned loopDepth(Loop *loop);
-  double fitnessFunction(DseRun *run);
-  double testGenome(std::ostream &outStream, QVector<Loop*> loops, QVector<unsigned> genome);
-  void runAll(std::ostream &outStream, QVector<Loop*> loops, QVector<unsigned> loopDepths, int n, QVector<unsigned> genome);
-  void exhaustive(std::ostream &outStream, QVector<Loop*> loops, QVector<unsigned> loopDepths);
-  void ga(std::ostream &outStream, QVector<Loop*> loops, QVector<unsigned> loopDepths);
+  void findGenes(Container *cont);
 
 public:
-  Dse(Sdsoc *project) {
+  Dse(Sdsoc *project) : store(&dseRuns) {
     mainProject = project;
     progDialog = NULL;
     dseAlgorithm = NULL;
+    fitnessChoice = FITNESS_RUNTIME;
+    objectives << FITNESS_RUNTIME << FITNESS_LUTS;
   }
   
   ~Dse() {
@@ -75,9 +76,12 @@ public:
         delete r.profile;
       }
     }
-    dseRuns.clear();
+    store.clear();
   }
 
+  // reads results from earlier DSE sessions
+  void load();
+
   void dialog(Container *cont);
   void showResults();
 
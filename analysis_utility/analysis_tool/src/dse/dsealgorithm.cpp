@@ -20,8 +20,14 @@
  *****************************************************************************/
 
 #include <QElapsedTimer>
+#include <math.h>
+
+#include <atomic>
+#include <thread>
+#include <algorithm>
 
 #include "dsealgorithm.h"
+#include "dseworker.h"
 #include "cfg/loop.h"
 #include "unistd.h"
 
@@ -34,83 +40,238 @@ double DseAlgorithm::fitnessFunction(DseRun *run) {
   return INT_MAX;
 }
 
-QMap<QString,QStringList> DseAlgorithm::getFilesToTransform(QVector<Loop*> loops, QVector<unsigned> genome) {
+QMap<QString,QStringList> DseAlgorithm::getFilesToTransform(QVector<DseGene> genes, QVector<unsigned> genome) {
   QMap<QString,QStringList> hwFiles;
 
-  for(int i = 0; i < loops.size(); i++) {
-    for(auto l : getLoop(loops[i], genome[i])) {
-      if(!hwFiles.contains(l->sourceFilename)) {
-        hwFiles[l->sourceFilename] = QStringList();
+  // genomes from older runs may be shorter
+  for(int i = 0; (i < genes.size()) && (i < genome.size()); i++) {
+    genes[i].getTransformations(genome[i], hwFiles);
+  }
+
+  return hwFiles;
+}
+
+void DseAlgorithm::buildProject(Sdsoc *project, QMap<QString,QStringList> hwFiles) {
+  // transform source files
+  for(auto f : hwFiles.toStdMap()) {
+    QFileInfo fileInfo(f.first);
+
+    int idx = project->sources.indexOf(f.first);
+    if(idx >= 0) {
+      project->sources[idx] = fileInfo.fileName();
+    }
+
+    for(int i = 0; i < project->accelerators.size(); i++) {
+      if(project->accelerators[i].filepath == f.first) {
+        project->accelerators[i].filepath = fileInfo.fileName();
       }
-      QStringList list = hwFiles[l->sourceFilename];
-      list.push_back(QString::number(l->sourceLineNumber) + "," + QString::number(l->sourceColumn));
-      list.removeDuplicates();
-      hwFiles[l->sourceFilename] = list;
     }
+
+    QString opt;
+    if(fileInfo.suffix() == "c") {
+      opt = project->cOptions + " " + project->cSysInc;
+    } else if((fileInfo.suffix() == "cpp") || (fileInfo.suffix() == "cc")) {
+      opt = project->cppOptions + " " + project->cppSysInc;
+    }
+
+    project->runSourceTool(f.first, fileInfo.fileName(), f.second, opt);
   }
 
-  return hwFiles;
+  project->makeBin();
 }
 
-double DseAlgorithm::testGenome(std::ostream &outStream, QVector<Loop*> loops, QVector<unsigned> genome) {
-  double fitness = INT_MAX;
+double DseAlgorithm::testGenome(QVector<DseGene> genes, QVector<unsigned> genome) {
+  return testGenomes(genes, QVector<QVector<unsigned>>() << genome)[0];
+}
 
-  // see if it is already evaluated
-  for(auto r : *dseRuns) {
-    if(r.genome == genome) {
-      if(!(r.failed && rerunFailed)) {
-        return fitnessFunction(&r);
+QVector<double> DseAlgorithm::testGenomes(QVector<DseGene> genes, QVector<QVector<unsigned>> genomes) {
+  QVector<double> fitness(genomes.size(), INT_MAX);
+
+  // see which genomes are already evaluated
+  QVector<QVector<unsigned>> toTest;
+
+  for(int i = 0; i < genomes.size(); i++) {
+    bool evaluated = false;
+
+    int n = store->find(genomes[i]);
+    if(n >= 0) {
+      DseRun *r = &(*dseRuns)[n];
+      if(!(r->failed && !r->dominated && rerunFailed)) {
+        fitness[i] = fitnessFunction(r);
+        evaluated = true;
       }
     }
+
+    if(evaluated) {
+      emit advance(runCounter++);
+    } else if(!toTest.contains(genomes[i])) {
+      toTest.push_back(genomes[i]);
+    }
   }
 
-  QElapsedTimer timer;
-  timer.start();
+  QVector<double> testedFitness(toTest.size(), INT_MAX);
 
-  // create run
-  Profile *profile = new Profile;
-  Sdsoc *project = Sdsoc::copySdsoc(mainProject, profile);
+  if(surrogateKeep >= 1) {
+    buildBatch(genes, toTest, testedFitness, NULL);
 
-  // clear and set temp directory
-  QDir oldDir = QDir::current();
-  QDir dir("dse");
-  if(dir.exists()) dir.removeRecursively();
-  dir.mkpath(".");
-  QDir::setCurrent(dir.path());
+  } else {
+    // build the most promising genomes according to the surrogate model, a few at a time so
+    // that the model can learn from each batch.  The rest get the predicted fitness.
+    SurrogateModel model(geneMax);
 
-  profile->connect();
+    int budget = ceil(surrogateKeep * toTest.size());
+    QVector<int> remaining;
+    for(int n = 0; n < toTest.size(); n++) remaining.push_back(n);
 
-  DseRun dseRun(genome, project, profile);
+    while(budget > 0 && remaining.size()) {
+      bool useModel = trainSurrogate(model);
 
-  // transform source files
-  QMap<QString,QStringList> hwFiles = getFilesToTransform(loops, genome);
+      if(useModel) {
+        // optimistic estimate, favors both good and uncertain genomes
+        QVector<double> scores;
+        for(auto n : remaining) {
+          double stdDev;
+          double mean = model.predict(toTest[n], &stdDev);
+          scores.push_back(mean - stdDev);
+        }
 
-  for(auto f : hwFiles.toStdMap()) {
-    QFileInfo fileInfo(f.first);
+        QVector<int> order;
+        for(int i = 0; i < remaining.size(); i++) order.push_back(i);
+        std::sort(order.begin(), order.end(), [&scores](int a, int b) {
+            return scores[a] < scores[b];
+          });
 
-    int idx = dseRun.project->sources.indexOf(f.first);
-    if(idx >= 0) {
-      dseRun.project->sources[idx] = fileInfo.fileName();
+        QVector<int> sorted;
+        for(auto i : order) sorted.push_back(remaining[i]);
+        remaining = sorted;
+      }
+
+      int batchSize = std::min(std::min((int)buildJobs, budget), remaining.size());
+
+      QVector<QVector<unsigned>> batch;
+      for(int i = 0; i < batchSize; i++) batch.push_back(toTest[remaining[i]]);
+
+      QVector<double> batchFitness(batch.size(), INT_MAX);
+      buildBatch(genes, batch, batchFitness, useModel ? &model : NULL);
+
+      for(int i = 0; i < batchSize; i++) testedFitness[remaining[i]] = batchFitness[i];
+
+      remaining.remove(0, batchSize);
+      budget -= batchSize;
     }
 
-    for(int i = 0; i < dseRun.project->accelerators.size(); i++) {
-      if(dseRun.project->accelerators[i].filepath == f.first) {
-        dseRun.project->accelerators[i].filepath = fileInfo.fileName();
-      }
+    bool useModel = trainSurrogate(model);
+    for(auto n : remaining) {
+      if(useModel) testedFitness[n] = model.predict(toTest[n]);
+      emit advance(runCounter++);
     }
+  }
 
-    QString opt;
-    if(fileInfo.suffix() == "c") {
-      opt = dseRun.project->cOptions + " " + dseRun.project->cSysInc;
-    } else if((fileInfo.suffix() == "cpp") || (fileInfo.suffix() == "cc")) {
-      opt = dseRun.project->cppOptions + " " + dseRun.project->cppSysInc;
+  for(int i = 0; i < genomes.size(); i++) {
+    int n = toTest.indexOf(genomes[i]);
+    if(n >= 0) fitness[i] = testedFitness[n];
+  }
+
+  return fitness;
+}
+
+bool DseAlgorithm::trainSurrogate(SurrogateModel &model) {
+  QVector<QVector<unsigned>> genomes;
+  QVector<double> fitness;
+
+  for(auto r : *dseRuns) {
+    if(r.genome.size() != geneMax.size()) continue;
+
+    // failed and infeasible runs would dominate a least squares fit
+    double f = fitnessFunction(&r);
+    if(f < INT_MAX) {
+      genomes.push_back(r.genome);
+      fitness.push_back(f);
     }
+  }
 
-    dseRun.project->runSourceTool(f.first, fileInfo.fileName(), f.second, opt);
+  return model.train(genomes, fitness);
+}
+
+double DseAlgorithm::getAbortLimit() {
+  // only runtime and energy are known to grow while profiling
+  if(!earlyAbort || (fitnessChoice > FITNESS_ENERGY_6)) return 0;
+
+  QMutexLocker locker(&resultMutex);
+
+  double best = INT_MAX;
+  for(auto r : *dseRuns) {
+    double f = fitnessFunction(&r);
+    if(f < best) best = f;
   }
 
+  return best < INT_MAX ? best : 0;
+}
+
+void DseAlgorithm::buildBatch(QVector<DseGene> &genes, QVector<QVector<unsigned>> &batch,
+                              QVector<double> &fitness, SurrogateModel *model) {
+  QVector<double> predictions;
+  for(auto genome : batch) {
+    predictions.push_back(model ? model->predict(genome) : 0);
+  }
+
+  // each worker uses its own build directory
+  std::atomic<int> next(0);
+
+  std::vector<std::thread> threads;
+  unsigned numWorkers = std::min(buildJobs, (unsigned)batch.size());
+
+  for(unsigned w = 0; w < numWorkers; w++) {
+    QString buildDir = dseDir + "/" + QString::number(w);
+    QString worker = w < (unsigned)workers.size() ? workers[w] : QString();
+
+    threads.push_back(std::thread([this, &genes, &batch, &fitness, &predictions, &next, model, buildDir, worker]() {
+      int n;
+      while((n = next++) < batch.size()) {
+        fitness[n] = buildAndProfile(genes, batch[n], buildDir, worker, model != NULL, predictions[n]);
+      }
+    }));
+  }
+
+  for(auto &thread : threads) {
+    thread.join();
+  }
+}
+
+double DseAlgorithm::buildAndProfile(QVector<DseGene> genes, QVector<unsigned> genome, QString buildDir, QString worker,
+                                     bool hasPrediction, double predicted) {
+  double fitness = INT_MAX;
+
+  QElapsedTimer timer;
+  timer.start();
+
+  // clear build directory
+  QDir dir(buildDir);
+  if(dir.exists()) dir.removeRecursively();
+  dir.mkpath(".");
+
+  // create run
+  Profile *profile = new Profile;
+  Sdsoc *project;
+  {
+    QMutexLocker locker(&resultMutex);
+    project = Sdsoc::copySdsoc(mainProject, profile);
+  }
+  project->buildDir = buildDir;
+
+  profile->connect(project->buildPath("profile.db3"));
+
+  DseRun dseRun(genome, project, profile);
+
   // build
-  dseRun.project->makeBin();
+  QMap<QString,QStringList> hwFiles = getFilesToTransform(genes, genome);
+
+  bool built = false;
+  if(worker != "") {
+    built = DseWorker::build(worker, dseRun.project, hwFiles);
+    if(!built) printf("Warning: Can't build on DSE worker %s, building locally\n", worker.toUtf8().constData());
+  }
+  if(!built) buildProject(dseRun.project, hwFiles);
 
   if(dseRun.project->errorCode) {
     delete dseRun.project;
@@ -120,9 +281,21 @@ double DseAlgorithm::testGenome(std::ostream &outStream, QVector<Loop*> loops, Q
 
   } else {
     // profile
-    dseRun.project->runProfiler();
+    {
+      QMutexLocker locker(&pmuMutex);
+      dseRun.project->abortLimit = getAbortLimit();
+      dseRun.project->abortSensor = (fitnessChoice == FITNESS_RUNTIME) ? -1 : (int)(fitnessChoice - FITNESS_ENERGY_0);
+      dseRun.project->runProfiler();
+    }
 
-    if(dseRun.project->errorCode) {
+    if(dseRun.project->aborted) {
+      delete dseRun.project;
+      delete dseRun.profile;
+      dseRun.failed = true;
+      dseRun.dominated = true;
+      dseRun.time = (timer.elapsed() / (double)1000);
+
+    } else if(dseRun.project->errorCode) {
       delete dseRun.project;
       delete dseRun.profile;
       dseRun.failed = true;
@@ -136,14 +309,21 @@ double DseAlgorithm::testGenome(std::ostream &outStream, QVector<Loop*> loops, Q
     }
   }
 
-  dseRuns->push_back(dseRun);
-  outStream << true << '\n';
-  outStream << dseRun << '\n';
-  outStream.flush();
+  if(hasPrediction) {
+    dseRun.hasPrediction = true;
+    dseRun.predicted = predicted;
+    dseRun.actual = fitness;
+  }
+
+  // store result as soon as it is ready
+  {
+    QMutexLocker locker(&resultMutex);
 
-  // change back to standard dir
-  QDir::setCurrent(oldDir.path());
+    bool success = store->add(dseRun);
+    if(!success) printf("Warning: Can't store DSE result\n");
+
+    emit advance(runCounter++);
+  }
 
   return fitness;
 }
-
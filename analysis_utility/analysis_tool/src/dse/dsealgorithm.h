@@ -23,8 +23,14 @@
 #define DSEALGORITHM_H
 
 #include <QObject>
+#include <QMutex>
+#include <QDir>
+#include <QFileInfo>
 
 #include "dserun.h"
+#include "surrogate.h"
+#include "dsegene.h"
+#include "dsestore.h"
 
 #define FITNESS_RUNTIME   0
 #define FITNESS_ENERGY_0  1
@@ -45,32 +51,75 @@ class DseAlgorithm : public QObject {
 protected:
   QVector<DseRun> *dseRuns;
 
-  std::ostream *outStream;
-  QVector<Loop*> loops;
-  QVector<unsigned> loopDepths;
+  DseStore *store;
+  QVector<DseGene> genes;
+  QVector<unsigned> geneMax;
   unsigned fitnessChoice;
   Sdsoc *mainProject;
   bool rerunFailed;
+  unsigned buildJobs;
+  QString dseDir;
+  int runCounter;
+
+  // addresses of DseWorker processes, builds are done locally if empty
+  QStringList workers;
+
+  // fraction of new genomes that are built, the rest get a fitness predicted by the surrogate model
+  double surrogateKeep;
+
+  // stop profiling runs that are already worse than the best run
+  bool earlyAbort;
+
+  // the PMU is shared, so profiling runs are done one at a time
+  QMutex pmuMutex;
+  // protects dseRuns, store and runCounter
+  QMutex resultMutex;
 
   double fitnessFunction(DseRun *run);
-  double testGenome(std::ostream &outStream, QVector<Loop*> loops, QVector<unsigned> genome);
+  double testGenome(QVector<DseGene> genes, QVector<unsigned> genome);
+  QVector<double> testGenomes(QVector<DseGene> genes, QVector<QVector<unsigned>> genomes);
+  double buildAndProfile(QVector<DseGene> genes, QVector<unsigned> genome, QString buildDir, QString worker,
+                         bool hasPrediction, double predicted);
+  void buildBatch(QVector<DseGene> &genes, QVector<QVector<unsigned>> &batch,
+                  QVector<double> &fitness, SurrogateModel *model);
+  bool trainSurrogate(SurrogateModel &model);
+  double getAbortLimit();
 
 public:
-  static QMap<QString,QStringList> getFilesToTransform(QVector<Loop*> loops, QVector<unsigned> genome);
+  static QMap<QString,QStringList> getFilesToTransform(QVector<DseGene> genes, QVector<unsigned> genome);
+  static void buildProject(Sdsoc *project, QMap<QString,QStringList> hwFiles);
 
-  DseAlgorithm(Sdsoc *mainProject, unsigned fitnessChoice, QVector<DseRun> *dseRuns, std::ostream *outStream,
-               QVector<Loop*> loops, QVector<unsigned> loopDepths, bool rerunFailed) {
+  DseAlgorithm(Sdsoc *mainProject, unsigned fitnessChoice, QVector<DseRun> *dseRuns, DseStore *store,
+               QVector<DseGene> genes, QVector<unsigned> geneMax, bool rerunFailed, unsigned buildJobs) {
     this->mainProject = mainProject;
     this->fitnessChoice = fitnessChoice;
     this->dseRuns = dseRuns;
-    this->outStream = outStream;
-    this->loops = loops;
-    this->loopDepths = loopDepths;
+    this->store = store;
+    this->genes = genes;
+    this->geneMax = geneMax;
     this->rerunFailed = rerunFailed;
+    this->buildJobs = buildJobs > 0 ? buildJobs : 1;
+    dseDir = QFileInfo(mainProject->buildPath("dse")).absoluteFilePath();
+    runCounter = 1;
+    surrogateKeep = 1;
+    earlyAbort = false;
   }
   ~DseAlgorithm() {
   }
 
+  void setSurrogateKeep(double keep) {
+    surrogateKeep = keep;
+  }
+
+  void setEarlyAbort(bool abort) {
+    earlyAbort = abort;
+  }
+
+  void setWorkers(QStringList workers) {
+    this->workers = workers;
+    if(workers.size()) buildJobs = workers.size();
+  }
+
   static QString getFitnessText(unsigned x) {
     switch(x) {
       default:
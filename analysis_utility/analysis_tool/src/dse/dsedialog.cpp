@@ -21,17 +21,48 @@
 
 #include "analysis_tool.h"
 #include "dsedialog.h"
+#include "dsealgorithm.h"
 
-DseDialog::DseDialog(unsigned numberOfSolutions) {
+static QDoubleSpinBox *addPercentSpinBox(QVBoxLayout *layout, QString text, double value) {
+  QLabel *label = new QLabel(text);
+  QDoubleSpinBox *spinBox = new QDoubleSpinBox;
+  spinBox->setRange(0, 100);
+  spinBox->setSuffix("%");
+  spinBox->setValue(value);
+  QHBoxLayout *hLayout = new QHBoxLayout;
+  hLayout->addWidget(label);
+  hLayout->addWidget(spinBox);
+  layout->addLayout(hLayout);
+  return spinBox;
+}
+
+DseDialog::DseDialog(QVector<DseGene> genes, QVector<unsigned> objectives, DseConstraints constraints) {
   shouldRun = false;
+  this->genes = genes;
 
   QGroupBox *compGroup = new QGroupBox("Components to explore");
 
   loopsCheckBox = new QCheckBox("Loop pipeline level");
   loopsCheckBox->setCheckState(Qt::Checked);
+  connect(loopsCheckBox, &QCheckBox::stateChanged, this, &DseDialog::updateSolutions);
+
+  unrollCheckBox = new QCheckBox("Loop unroll factor");
+  unrollCheckBox->setCheckState(Qt::Unchecked);
+  connect(unrollCheckBox, &QCheckBox::stateChanged, this, &DseDialog::updateSolutions);
+
+  partitionCheckBox = new QCheckBox("Array partitioning");
+  partitionCheckBox->setCheckState(Qt::Unchecked);
+  connect(partitionCheckBox, &QCheckBox::stateChanged, this, &DseDialog::updateSolutions);
+
+  functionsCheckBox = new QCheckBox("Function dataflow and inlining");
+  functionsCheckBox->setCheckState(Qt::Unchecked);
+  connect(functionsCheckBox, &QCheckBox::stateChanged, this, &DseDialog::updateSolutions);
 
   QVBoxLayout *compLayout = new QVBoxLayout;
   compLayout->addWidget(loopsCheckBox);
+  compLayout->addWidget(unrollCheckBox);
+  compLayout->addWidget(partitionCheckBox);
+  compLayout->addWidget(functionsCheckBox);
   compGroup->setLayout(compLayout);
 
   ///////////////////////////////////////////////////////////////////////////////
@@ -41,13 +72,33 @@ DseDialog::DseDialog(unsigned numberOfSolutions) {
   algCombo = new QComboBox;
   algCombo->addItem("Genetic Algorithm");
   algCombo->addItem("Exhaustive");
+  algCombo->addItem("NSGA-II (multi-objective)");
   algCombo->setCurrentIndex(1);
 
-  QLabel *text = new QLabel(QString("Number of solutions: ") + QString::number(numberOfSolutions), this);
+  solutionsText = new QLabel(this);
+  updateSolutions();
+
+  QLabel *populationLabel = new QLabel("GA population:");
+  populationSpinBox = new QSpinBox;
+  populationSpinBox->setRange(3, 1000);
+  populationSpinBox->setValue(20);
+  QHBoxLayout *populationLayout = new QHBoxLayout;
+  populationLayout->addWidget(populationLabel);
+  populationLayout->addWidget(populationSpinBox);
+
+  QLabel *generationsLabel = new QLabel("GA generations:");
+  generationsSpinBox = new QSpinBox;
+  generationsSpinBox->setRange(1, 1000);
+  generationsSpinBox->setValue(10);
+  QHBoxLayout *generationsLayout = new QHBoxLayout;
+  generationsLayout->addWidget(generationsLabel);
+  generationsLayout->addWidget(generationsSpinBox);
 
   QVBoxLayout *algorithmLayout = new QVBoxLayout;
   algorithmLayout->addWidget(algCombo);
-  algorithmLayout->addWidget(text);
+  algorithmLayout->addWidget(solutionsText);
+  algorithmLayout->addLayout(populationLayout);
+  algorithmLayout->addLayout(generationsLayout);
   algorithmGroup->setLayout(algorithmLayout);
 
   ///////////////////////////////////////////////////////////////////////////////
@@ -64,13 +115,62 @@ DseDialog::DseDialog(unsigned numberOfSolutions) {
 
   ///////////////////////////////////////////////////////////////////////////////
 
+  QGroupBox *paretoGroup = new QGroupBox("Multi-objective search");
+
+  QLabel *objectivesText = new QLabel("Objectives:");
+
+  objectivesList = new QListWidget;
+  for(unsigned i = 0; i <= FITNESS_REGS; i++) {
+    QListWidgetItem *item = new QListWidgetItem(DseAlgorithm::getFitnessText(i), objectivesList);
+    item->setFlags(item->flags() | Qt::ItemIsUserCheckable);
+    item->setCheckState(objectives.contains(i) ? Qt::Checked : Qt::Unchecked);
+  }
+
+  timingCheckBox = new QCheckBox("Require timing met");
+  timingCheckBox->setCheckState(constraints.timingOk ? Qt::Checked : Qt::Unchecked);
+
+  QVBoxLayout *paretoLayout = new QVBoxLayout;
+  paretoLayout->addWidget(objectivesText);
+  paretoLayout->addWidget(objectivesList);
+  paretoLayout->addWidget(timingCheckBox);
+  maxBramsSpinBox = addPercentSpinBox(paretoLayout, "Max BRAMs:", constraints.maxBrams);
+  maxLutsSpinBox = addPercentSpinBox(paretoLayout, "Max LUTs:", constraints.maxLuts);
+  maxDspsSpinBox = addPercentSpinBox(paretoLayout, "Max DSPs:", constraints.maxDsps);
+  maxRegsSpinBox = addPercentSpinBox(paretoLayout, "Max registers:", constraints.maxRegs);
+  paretoGroup->setLayout(paretoLayout);
+
+  ///////////////////////////////////////////////////////////////////////////////
+
   QGroupBox *otherGroup = new QGroupBox("Other settings");
 
   rerunFailedCheckBox = new QCheckBox("Rerun failed individuals");
   rerunFailedCheckBox->setCheckState(Qt::Unchecked);
 
+  earlyAbortCheckBox = new QCheckBox("Stop profiling when worse than the best run");
+  earlyAbortCheckBox->setCheckState(Qt::Checked);
+
+  QLabel *buildJobsLabel = new QLabel("Parallel builds:");
+  buildJobsSpinBox = new QSpinBox;
+  buildJobsSpinBox->setRange(1, 256);
+  buildJobsSpinBox->setValue(QThread::idealThreadCount() > 0 ? QThread::idealThreadCount() : 1);
+  QHBoxLayout *buildJobsLayout = new QHBoxLayout;
+  buildJobsLayout->addWidget(buildJobsLabel);
+  buildJobsLayout->addWidget(buildJobsSpinBox);
+
+  QLabel *surrogateLabel = new QLabel("Build only the most promising (surrogate model):");
+  surrogateSpinBox = new QSpinBox;
+  surrogateSpinBox->setRange(1, 100);
+  surrogateSpinBox->setSuffix("%");
+  surrogateSpinBox->setValue(100);
+  QHBoxLayout *surrogateLayout = new QHBoxLayout;
+  surrogateLayout->addWidget(surrogateLabel);
+  surrogateLayout->addWidget(surrogateSpinBox);
+
   QVBoxLayout *otherLayout = new QVBoxLayout;
   otherLayout->addWidget(rerunFailedCheckBox);
+  otherLayout->addWidget(earlyAbortCheckBox);
+  otherLayout->addLayout(buildJobsLayout);
+  otherLayout->addLayout(surrogateLayout);
   otherGroup->setLayout(otherLayout);
 
   ///////////////////////////////////////////////////////////////////////////////
@@ -93,6 +193,7 @@ DseDialog::DseDialog(unsigned numberOfSolutions) {
   mainLayout->addWidget(compGroup);
   mainLayout->addWidget(algorithmGroup);
   mainLayout->addWidget(fitnessGroup);
+  mainLayout->addWidget(paretoGroup);
   mainLayout->addWidget(otherGroup);
   mainLayout->addLayout(buttonLayout);
   mainLayout->addStretch(1);
@@ -105,3 +206,63 @@ DseDialog::DseDialog(unsigned numberOfSolutions) {
 void DseDialog::run() {
   shouldRun = true;
 }
+
+void DseDialog::updateSolutions() {
+  solutionsText->setText(QString("Number of solutions: ") + QString::number(numberOfSolutions(getGeneMax()), 'g', 4));
+}
+
+double DseDialog::numberOfSolutions(QVector<unsigned> geneMax) {
+  if(!geneMax.size()) return 0;
+
+  double x = 1;
+  for(auto max : geneMax) {
+    x *= max + 1;
+  }
+  return x;
+}
+
+QVector<unsigned> DseDialog::getGeneMax() {
+  QVector<unsigned> geneMax;
+
+  for(auto gene : genes) {
+    bool enabled = false;
+
+    switch(gene.type) {
+      case DSE_GENE_PIPELINE:
+        enabled = loopsCheckBox->checkState() == Qt::Checked;
+        break;
+      case DSE_GENE_UNROLL:
+        enabled = unrollCheckBox->checkState() == Qt::Checked;
+        break;
+      case DSE_GENE_PARTITION:
+        enabled = partitionCheckBox->checkState() == Qt::Checked;
+        break;
+      case DSE_GENE_DATAFLOW:
+      case DSE_GENE_INLINE:
+        enabled = functionsCheckBox->checkState() == Qt::Checked;
+        break;
+    }
+
+    geneMax.push_back(enabled ? gene.getMax() : 0);
+  }
+
+  return geneMax;
+}
+
+QVector<unsigned> DseDialog::getObjectives() {
+  QVector<unsigned> objectives;
+  for(int i = 0; i < objectivesList->count(); i++) {
+    if(objectivesList->item(i)->checkState() == Qt::Checked) objectives.push_back(i);
+  }
+  return objectives;
+}
+
+DseConstraints DseDialog::getConstraints() {
+  DseConstraints constraints;
+  constraints.timingOk = timingCheckBox->checkState() == Qt::Checked;
+  constraints.maxBrams = maxBramsSpinBox->value();
+  constraints.maxLuts = maxLutsSpinBox->value();
+  constraints.maxDsps = maxDspsSpinBox->value();
+  constraints.maxRegs = maxRegsSpinBox->value();
+  return constraints;
+}
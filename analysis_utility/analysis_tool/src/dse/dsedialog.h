@@ -25,20 +25,49 @@
 #include <QtWidgets>
 #include <QDialog>
 
+#include "pareto.h"
+#include "dsegene.h"
+
 class DseDialog : public QDialog {
   Q_OBJECT
 
+private:
+  QVector<DseGene> genes;
+  QLabel *solutionsText;
+
 private slots:
   void run();
+  void updateSolutions();
 
 public:
   QCheckBox *loopsCheckBox;
+  QCheckBox *unrollCheckBox;
+  QCheckBox *partitionCheckBox;
+  QCheckBox *functionsCheckBox;
   QComboBox *fitnessCombo;
   QComboBox *algCombo;
+  QSpinBox *populationSpinBox;
+  QSpinBox *generationsSpinBox;
   bool shouldRun;
   QCheckBox *rerunFailedCheckBox;
+  QCheckBox *earlyAbortCheckBox;
+  QSpinBox *buildJobsSpinBox;
+  QSpinBox *surrogateSpinBox;
+  QListWidget *objectivesList;
+  QCheckBox *timingCheckBox;
+  QDoubleSpinBox *maxBramsSpinBox;
+  QDoubleSpinBox *maxLutsSpinBox;
+  QDoubleSpinBox *maxDspsSpinBox;
+  QDoubleSpinBox *maxRegsSpinBox;
+
+  DseDialog(QVector<DseGene> genes, QVector<unsigned> objectives, DseConstraints constraints);
+
+  static double numberOfSolutions(QVector<unsigned> geneMax);
 
-  DseDialog(unsigned numberOfSolutions);
+  // largest value of each gene, 0 for genes of components that are not explored
+  QVector<unsigned> getGeneMax();
+  QVector<unsigned> getObjectives();
+  DseConstraints getConstraints();
 };
 
 #endif
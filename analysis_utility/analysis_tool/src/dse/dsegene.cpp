@@ -0,0 +1,100 @@
+/******************************************************************************
+ *
+ *  This file is part of the TULIPP Analysis Utility
+ *
+ *  Copyright 2018 Asbjørn Djupdal, NTNU, TULIPP EU Project
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *****************************************************************************/
+
+#include <QFileInfo>
+
+#include "dsegene.h"
+#include "analysis_tool.h"
+
+static QString loopId(Loop *loop) {
+  return QString::number(loop->sourceLineNumber) + "," + QString::number(loop->sourceColumn);
+}
+
+void DseGene::getTransformations(unsigned value, QMap<QString,QStringList> &files) const {
+  if(!value) return;
+
+  QStringList options;
+
+  switch(type) {
+    case DSE_GENE_PIPELINE:
+      for(auto l : getLoop(loop, value)) {
+        QStringList list = files[l->sourceFilename];
+        list.push_back("-pipeloop=" + loopId(l));
+        list.removeDuplicates();
+        files[l->sourceFilename] = list;
+      }
+      return;
+
+    case DSE_GENE_UNROLL:
+      options << "-unrollloop=" + loopId(loop);
+      options << "-unroll=" + QString::number(getUnrollFactor(value));
+      break;
+
+    case DSE_GENE_PARTITION:
+      // the source tool pairs the array options by position, so all of them are always given
+      options << "-array=" + location;
+      options << "-dim=" + QString::number(getPartitionDim(value));
+      options << "-partition=" + getPartitionType(value);
+      options << "-factor=" + QString::number(getPartitionFactor(value));
+      break;
+
+    case DSE_GENE_DATAFLOW:
+      options << "-dataflow=" + name;
+      break;
+
+    case DSE_GENE_INLINE:
+      options << (value == 1 ? "-inline=" : "-noinline=") + name;
+      break;
+  }
+
+  files[sourceFilename] << options;
+}
+
+QString DseGene::getText(unsigned value) const {
+  if(!value) return "";
+
+  QString loopText;
+  if(loop) loopText = QFileInfo(loop->sourceFilename).fileName() + ":" + loopId(loop);
+
+  switch(type) {
+    default:
+    case DSE_GENE_PIPELINE:
+      return "PIPELINE loop " + loopText + " at depth " + QString::number(value);
+
+    case DSE_GENE_UNROLL: {
+      unsigned factor = getUnrollFactor(value);
+      return "UNROLL " + (factor ? "factor=" + QString::number(factor) + " " : QString("")) + "loop " + loopText;
+    }
+
+    case DSE_GENE_PARTITION: {
+      QString text = "ARRAY_PARTITION " + name + " " + getPartitionType(value);
+      unsigned factor = getPartitionFactor(value);
+      if(factor) text += " factor=" + QString::number(factor);
+      return text + " dim=" + QString::number(getPartitionDim(value));
+    }
+
+    case DSE_GENE_DATAFLOW:
+      return "DATAFLOW in " + name + "()";
+
+    case DSE_GENE_INLINE:
+      return QString(value == 1 ? "INLINE " : "INLINE off ") + name + "()";
+  }
+}
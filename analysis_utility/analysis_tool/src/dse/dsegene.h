@@ -0,0 +1,115 @@
+/******************************************************************************
+ *
+ *  This file is part of the TULIPP Analysis Utility
+ *
+ *  Copyright 2018 Asbjørn Djupdal, NTNU, TULIPP EU Project
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *****************************************************************************/
+
+#ifndef DSEGENE_H
+#define DSEGENE_H
+
+#include <QVector>
+#include <QMap>
+#include <QStringList>
+
+#include "cfg/loop.h"
+
+#define DSE_GENE_PIPELINE  0
+#define DSE_GENE_UNROLL    1
+#define DSE_GENE_PARTITION 2
+#define DSE_GENE_DATAFLOW  3
+#define DSE_GENE_INLINE    4
+
+// unroll factors 2, 4, 8 and complete
+#define DSE_UNROLL_CHOICES 4
+
+// complete, cyclic 2, 4, 8 and block 2, 4, 8, for each array dimension
+#define DSE_PARTITION_CHOICES 7
+
+// One gene of the DSE genome.  Genes are mixed-radix: a gene takes the values 0 to getMax(), where
+// 0 always means "no directive".
+class DseGene {
+public:
+  unsigned type;
+  Loop *loop;              // pipeline and unroll genes
+  QString sourceFilename;  // partition, dataflow and inline genes
+  QString name;            // function or array name
+  QString location;        // line,column of the array declaration
+  unsigned dims;           // array dimensions, or loop depth for pipeline genes
+
+  DseGene(unsigned type, Loop *loop, unsigned depth = 1) {
+    this->type = type;
+    this->loop = loop;
+    this->sourceFilename = loop->sourceFilename;
+    this->dims = depth;
+  }
+
+  DseGene(unsigned type, QString sourceFilename, QString name, QString location = "", unsigned dims = 1) {
+    this->type = type;
+    this->loop = NULL;
+    this->sourceFilename = sourceFilename;
+    this->name = name;
+    this->location = location;
+    this->dims = dims;
+  }
+
+  DseGene() {
+    type = DSE_GENE_PIPELINE;
+    loop = NULL;
+    dims = 1;
+  }
+
+  unsigned getMax() const {
+    switch(type) {
+      default:
+      case DSE_GENE_PIPELINE:  return dims; // loop depth
+      case DSE_GENE_UNROLL:    return DSE_UNROLL_CHOICES;
+      case DSE_GENE_PARTITION: return DSE_PARTITION_CHOICES * dims;
+      case DSE_GENE_DATAFLOW:  return 1;
+      case DSE_GENE_INLINE:    return 2;
+    }
+  }
+
+  static unsigned getUnrollFactor(unsigned value) {
+    return value < DSE_UNROLL_CHOICES ? 1 << value : 0;
+  }
+
+  static QString getPartitionType(unsigned value) {
+    unsigned choice = (value - 1) % DSE_PARTITION_CHOICES;
+    if(choice == 0) return "complete";
+    if(choice <= 3) return "cyclic";
+    return "block";
+  }
+
+  static unsigned getPartitionFactor(unsigned value) {
+    unsigned choice = (value - 1) % DSE_PARTITION_CHOICES;
+    if(choice == 0) return 0;
+    return 1 << (((choice - 1) % 3) + 1);
+  }
+
+  static unsigned getPartitionDim(unsigned value) {
+    return (value - 1) / DSE_PARTITION_CHOICES + 1;
+  }
+
+  // adds the source tool arguments for the given value to the files that must be transformed
+  void getTransformations(unsigned value, QMap<QString,QStringList> &files) const;
+
+  // human readable directive for the given value
+  QString getText(unsigned value) const;
+};
+
+#endif
@@ -33,6 +33,24 @@ double DseResultDialog::getTotalDseTime() {
   return time;
 }
 
+bool DseResultDialog::getSurrogateError(double *error) {
+  // mean relative error of the surrogate model predictions
+  double sum = 0;
+  unsigned num = 0;
+
+  for(auto dseRun : *dseRuns) {
+    if(dseRun.hasPrediction && (dseRun.actual < INT_MAX) && (dseRun.actual != 0)) {
+      sum += fabs(dseRun.predicted - dseRun.actual) / fabs(dseRun.actual);
+      num++;
+    }
+  }
+
+  if(!num) return false;
+
+  *error = sum / num;
+  return true;
+}
+
 DseRun DseResultDialog::getBestIndividual(int index, double *fitness) {
   *fitness = INT_MAX;
   DseRun r;
@@ -53,10 +71,38 @@ DseRun DseResultDialog::getBestIndividual(int index, double *fitness) {
   return r;
 }
 
+DseRun DseResultDialog::getSelectedIndividual() {
+  if(selectedRun >= 0) return (*dseRuns)[selectedRun];
+
+  double fitness;
+  return getBestIndividual(fitnessCombo->currentIndex(), &fitness);
+}
+
 void DseResultDialog::changeFitnessFunction(int index) {
   double fitness;
   DseRun best = getBestIndividual(index, &fitness);
 
+  selectedRun = -1;
+  if(frontList) frontList->clearSelection();
+
+  showIndividual(best, fitness);
+}
+
+void DseResultDialog::selectFrontMember(int row) {
+  if((row < 0) || (row >= front.size())) return;
+
+  selectedRun = front[row];
+  DseRun run = (*dseRuns)[selectedRun];
+
+  showIndividual(run, DseAlgorithm::getFitness(run.profile, run.project, fitnessCombo->currentIndex()));
+}
+
+void DseResultDialog::selectKneePoint() {
+  int knee = Pareto::getKneePoint(dseRuns, front, objectives);
+  if(knee >= 0) frontList->setCurrentRow(front.indexOf(knee));
+}
+
+void DseResultDialog::showIndividual(DseRun &best, double fitness) {
   QString messageText;
   QTextStream messageTextStream(&messageText);
 
@@ -77,6 +123,13 @@ void DseResultDialog::changeFitnessFunction(int index) {
     messageTextStream << "<tr>";
     messageTextStream << "<td>Registers:</td><td>" << best.project->getRegs() << "%</td>";
     messageTextStream << "</tr>";
+  } else if(best.dominated) {
+    messageTextStream << "<tr><td colspan=\"4\">Profiling stopped, worse than the best run</td></tr>";
+  }
+  for(int i = 0; (i < genes.size()) && (i < best.genome.size()); i++) {
+    if(best.genome[i]) {
+      messageTextStream << "<tr><td colspan=\"4\">" << genes[i].getText(best.genome[i]).toHtmlEscaped() << "</td></tr>";
+    }
   }
   messageTextStream << "</table>";
 
@@ -86,11 +139,10 @@ void DseResultDialog::changeFitnessFunction(int index) {
 void DseResultDialog::genSource() {
   QApplication::setOverrideCursor(Qt::WaitCursor);
 
-  double fitness;
-  DseRun dseRun = getBestIndividual(fitnessCombo->currentIndex(), &fitness);
+  DseRun dseRun = getSelectedIndividual();
 
   // transform source files
-  QMap<QString,QStringList> hwFiles = DseAlgorithm::getFilesToTransform(loops, dseRun.genome);
+  QMap<QString,QStringList> hwFiles = DseAlgorithm::getFilesToTransform(genes, dseRun.genome);
 
   if(!hwFiles.size()) {
     QApplication::restoreOverrideCursor();
@@ -200,8 +252,22 @@ void DseResultDialog::changeAxes(int dummy) {
     }
   }
 
+  // highlight the Pareto front
+  QScatterSeries *frontSeries = new QScatterSeries();
+  frontSeries->setMarkerShape(QScatterSeries::MarkerShapeCircle);
+  frontSeries->setMarkerSize(9.0);
+  frontSeries->setBorderColor(Qt::transparent);
+  frontSeries->setColor(NTNU_YELLOW);
+
+  for(auto i : front) {
+    DseRun *r = &(*dseRuns)[i];
+    *frontSeries << QPointF(DseAlgorithm::getFitness(r->profile, r->project, xCombo->currentIndex()),
+                            DseAlgorithm::getFitness(r->profile, r->project, yCombo->currentIndex()));
+  }
+
   chartView->chart()->removeAllSeries();
   chartView->chart()->addSeries(series);
+  chartView->chart()->addSeries(frontSeries);
   chartView->chart()->createDefaultAxes();
 
   double clearance = (maxX-minX) / 10;
@@ -219,10 +285,16 @@ void DseResultDialog::changeAxes(int dummy) {
   y->setTitleText(yText);
 }
 
-DseResultDialog::DseResultDialog(Sdsoc *mainProject, QVector<DseRun> *dseRuns, unsigned fitness, QVector<Loop*> loops) {
+DseResultDialog::DseResultDialog(Sdsoc *mainProject, QVector<DseRun> *dseRuns, unsigned fitness,
+                                 QVector<unsigned> objectives, DseConstraints constraints, QVector<DseGene> genes) {
   this->mainProject = mainProject;
   this->dseRuns = dseRuns;
-  this->loops = loops;
+  this->genes = genes;
+  this->objectives = objectives;
+
+  selectedRun = -1;
+  frontList = NULL;
+  front = Pareto::getFront(dseRuns, objectives, constraints);
 
   QGroupBox *ProcessGroup = new QGroupBox("DSE algorithm overview");
 
@@ -247,6 +319,13 @@ DseResultDialog::DseResultDialog(Sdsoc *mainProject, QVector<DseRun> *dseRuns, u
   if(min || hour || day) messageTextStream << "<td>" << QString::number(min) << "m</td>";
   messageTextStream << "<td>" << QString::number(sec) << "s</td>";
   messageTextStream << "</tr>";
+  double surrogateError;
+  if(getSurrogateError(&surrogateError)) {
+    messageTextStream << "<tr>";
+    messageTextStream << "<td>Surrogate model error:</td>";
+    messageTextStream << "<td>" << QString::number(surrogateError * 100, 'f', 1) << "%</td>";
+    messageTextStream << "</tr>";
+  }
   messageTextStream << "</table>";
   processText->setText(messageText);
 
@@ -285,6 +364,29 @@ DseResultDialog::DseResultDialog(Sdsoc *mainProject, QVector<DseRun> *dseRuns, u
 
   ///////////////////////////////////////////////////////////////////////////////
 
+  QGroupBox *paretoGroup = new QGroupBox("Pareto front");
+
+  frontList = new QListWidget;
+  for(auto i : front) {
+    QStringList values;
+    QVector<double> v = Pareto::getObjectives(&(*dseRuns)[i], objectives);
+    for(int m = 0; m < objectives.size(); m++) {
+      values << DseAlgorithm::getFitnessText(objectives[m]) + ": " + QString::number(v[m]);
+    }
+    frontList->addItem(values.join(", "));
+  }
+  connect(frontList, SIGNAL(currentRowChanged(int)), this, SLOT(selectFrontMember(int)));
+
+  QPushButton *kneeButton = new QPushButton("Select knee point");
+  connect(kneeButton, &QAbstractButton::clicked, this, &DseResultDialog::selectKneePoint);
+
+  QVBoxLayout *paretoLayout = new QVBoxLayout;
+  paretoLayout->addWidget(frontList);
+  paretoLayout->addWidget(kneeButton);
+  paretoGroup->setLayout(paretoLayout);
+
+  ///////////////////////////////////////////////////////////////////////////////
+
   QGroupBox *plotGroup = new QGroupBox("Plot");
 
   chartView = new QChartView;
@@ -333,6 +435,7 @@ DseResultDialog::DseResultDialog(Sdsoc *mainProject, QVector<DseRun> *dseRuns, u
   QVBoxLayout *mainLayout = new QVBoxLayout;
   mainLayout->addWidget(ProcessGroup);
   mainLayout->addWidget(bestGroup);
+  mainLayout->addWidget(paretoGroup);
   mainLayout->addWidget(plotGroup);
   mainLayout->addWidget(okButton);
 
@@ -39,23 +39,33 @@ private:
   Sdsoc *mainProject;
   QLabel *genomeText;
   QVector<DseRun> *dseRuns;
-  QVector<Loop*> loops;
+  QVector<DseGene> genes;
   QComboBox *fitnessCombo;
   QScatterSeries *series;
   QChartView *chartView;
   QComboBox *xCombo;
   QComboBox *yCombo;
+  QVector<unsigned> objectives;
+  QVector<int> front;
+  QListWidget *frontList;
+  int selectedRun;
 
   DseRun getBestIndividual(int index, double *fitness);
+  DseRun getSelectedIndividual();
   double getTotalDseTime();
+  bool getSurrogateError(double *error);
+  void showIndividual(DseRun &run, double fitness);
 
 private slots:
   void changeFitnessFunction(int index);
   void genSource();
   void changeAxes(int dummy);
+  void selectFrontMember(int row);
+  void selectKneePoint();
 
 public:
-  DseResultDialog(Sdsoc *mainProject, QVector<DseRun> *dseRuns, unsigned fitness, QVector<Loop*> loops);
+  DseResultDialog(Sdsoc *mainProject, QVector<DseRun> *dseRuns, unsigned fitness,
+                  QVector<unsigned> objectives, DseConstraints constraints, QVector<DseGene> genes);
 };
 
 #endif
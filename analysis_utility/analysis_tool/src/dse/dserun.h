@@ -23,6 +23,7 @@
 #define DSERUN_H
 
 #include <QVector>
+#include <sstream>
 
 #include "project/sdsoc.h"
 
@@ -34,17 +35,29 @@ public:
   Profile *profile;
   double time;
 
+  // profiling was stopped because the run was already worse than the best one
+  bool dominated;
+
+  // surrogate model prediction made before the run, and the fitness that was measured
+  bool hasPrediction;
+  double predicted;
+  double actual;
+
   DseRun() {
     failed = false;
+    dominated = false;
     project = NULL;
     profile = NULL;
+    hasPrediction = false;
   }
 
   DseRun(QVector<unsigned> genome, Sdsoc *project, Profile *profile) {
     this->failed = false;
+    this->dominated = false;
     this->genome = genome;
     this->project = project;
     this->profile = profile;
+    this->hasPrediction = false;
   }
 
 	friend std::ostream& operator<<(std::ostream &os, const DseRun &d) {
@@ -61,6 +74,14 @@ public:
       os << *d.profile << '\n';
     }
 
+    if(d.hasPrediction) {
+      os << "surrogate " << d.predicted << ' ' << d.actual << '\n';
+    }
+
+    if(d.dominated) {
+      os << "dominated\n";
+    }
+
     os << "****";
 
 		return os;
@@ -92,9 +113,18 @@ public:
       is >> *d.project >> *d.profile;
     }
 
+    d.hasPrediction = false;
+    d.dominated = false;
+
     std::string marker;
     while(marker != "****" && is.good()) {
       std::getline(is, marker);
+      if(marker.compare(0, 10, "surrogate ") == 0) {
+        std::istringstream(marker.substr(10)) >> d.predicted >> d.actual;
+        d.hasPrediction = true;
+      } else if(marker == "dominated") {
+        d.dominated = true;
+      }
     }
 
     return is;
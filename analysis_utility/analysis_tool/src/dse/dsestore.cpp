@@ -0,0 +1,207 @@
+/******************************************************************************
+ *
+ *  This file is part of the TULIPP Analysis Utility
+ *
+ *  Copyright 2018 Asbjørn Djupdal, NTNU, TULIPP EU Project
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *****************************************************************************/
+
+#include <atomic>
+#include <assert.h>
+
+#include "dsestore.h"
+
+QString DseStore::getKey(const QVector<unsigned> &genome) {
+  QStringList list;
+  for(auto g : genome) list << QString::number(g);
+  return list.join(' ');
+}
+
+QString DseStore::getConnection() {
+  // runs are added from the build threads, and a connection can only be used in the thread that opened it
+  static std::atomic<int> counter(0);
+  return QString("dse") + QString::number(counter++);
+}
+
+bool DseStore::open(QString filename) {
+  this->filename = filename;
+
+  QString connection = getConnection();
+  bool success;
+  {
+    QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", connection);
+    db.setDatabaseName(filename);
+    success = db.open();
+
+    if(success) {
+      QSqlQuery query(db);
+      success = query.exec("CREATE TABLE IF NOT EXISTS meta (key TEXT PRIMARY KEY, value TEXT)") &&
+                query.exec("CREATE TABLE IF NOT EXISTS runs (genome TEXT PRIMARY KEY, failed INT, data TEXT)");
+      db.close();
+    }
+  }
+  QSqlDatabase::removeDatabase(connection);
+
+  return success;
+}
+
+bool DseStore::load() {
+  clear();
+
+  QString connection = getConnection();
+  bool success;
+  {
+    QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", connection);
+    db.setDatabaseName(filename);
+    success = db.open();
+
+    if(success) {
+      QSqlQuery query(db);
+      query.setForwardOnly(true);
+      success = query.exec("SELECT data FROM runs ORDER BY rowid");
+
+      while(success && query.next()) {
+        std::istringstream data(query.value("data").toString().toStdString());
+
+        DseRun run;
+        data >> run;
+
+        index[run.genome] = runs->size();
+        runs->push_back(run);
+      }
+
+      db.close();
+    }
+  }
+  QSqlDatabase::removeDatabase(connection);
+
+  return success;
+}
+
+void DseStore::insert(QSqlDatabase &db, const DseRun &run) {
+  std::ostringstream data;
+  data << run;
+
+  QSqlQuery query(db);
+  query.prepare("INSERT OR REPLACE INTO runs (genome,failed,data) VALUES (:genome,:failed,:data)");
+  query.bindValue(":genome", getKey(run.genome));
+  query.bindValue(":failed", run.failed);
+  query.bindValue(":data", QString::fromStdString(data.str()));
+
+  bool success = query.exec();
+  Q_UNUSED(success);
+  assert(success);
+}
+
+bool DseStore::save() {
+  QString connection = getConnection();
+  bool success;
+  {
+    QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", connection);
+    db.setDatabaseName(filename);
+    success = db.open();
+
+    if(success) {
+      db.transaction();
+
+      QSqlQuery query(db);
+      query.exec("DELETE FROM runs");
+
+      for(auto run : *runs) {
+        insert(db, run);
+      }
+
+      success = db.commit();
+      db.close();
+    }
+  }
+  QSqlDatabase::removeDatabase(connection);
+
+  index.clear();
+  for(int i = 0; i < runs->size(); i++) {
+    index[(*runs)[i].genome] = i;
+  }
+
+  return success;
+}
+
+bool DseStore::add(const DseRun &run) {
+  int n = find(run.genome);
+
+  if(n >= 0) {
+    (*runs)[n] = run;
+  } else {
+    index[run.genome] = runs->size();
+    runs->push_back(run);
+  }
+
+  QString connection = getConnection();
+  bool success;
+  {
+    QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", connection);
+    db.setDatabaseName(filename);
+    success = db.open();
+
+    if(success) {
+      insert(db, run);
+      db.close();
+    }
+  }
+  QSqlDatabase::removeDatabase(connection);
+
+  return success;
+}
+
+QString DseStore::getMeta(QString key) {
+  QString value;
+
+  QString connection = getConnection();
+  {
+    QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", connection);
+    db.setDatabaseName(filename);
+
+    if(db.open()) {
+      QSqlQuery query(db);
+      query.prepare("SELECT value FROM meta WHERE key = :key");
+      query.bindValue(":key", key);
+      if(query.exec() && query.next()) value = query.value("value").toString();
+      db.close();
+    }
+  }
+  QSqlDatabase::removeDatabase(connection);
+
+  return value;
+}
+
+void DseStore::setMeta(QString key, QString value) {
+  QString connection = getConnection();
+  {
+    QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", connection);
+    db.setDatabaseName(filename);
+
+    if(db.open()) {
+      QSqlQuery query(db);
+      query.prepare("INSERT OR REPLACE INTO meta (key,value) VALUES (:key,:value)");
+      query.bindValue(":key", key);
+      query.bindValue(":value", value);
+      bool success = query.exec();
+      Q_UNUSED(success);
+      assert(success);
+      db.close();
+    }
+  }
+  QSqlDatabase::removeDatabase(connection);
+}
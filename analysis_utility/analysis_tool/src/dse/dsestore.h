@@ -0,0 +1,77 @@
+/******************************************************************************
+ *
+ *  This file is part of the TULIPP Analysis Utility
+ *
+ *  Copyright 2018 Asbjørn Djupdal, NTNU, TULIPP EU Project
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *****************************************************************************/
+
+#ifndef DSESTORE_H
+#define DSESTORE_H
+
+#include <QVector>
+#include <QHash>
+#include <QString>
+#include <QtSql>
+
+#include "dserun.h"
+
+#define DSE_RESULTS_FILE "dse.db3"
+
+// DSE results in an SQLite database, one row per genome.  Every run is committed as soon as it is
+// ready, so a DSE that is interrupted can be resumed without redoing the completed runs.
+class DseStore {
+
+private:
+  QVector<DseRun> *runs;
+  QHash<QVector<unsigned>,int> index;
+  QString filename;
+
+  static QString getKey(const QVector<unsigned> &genome);
+  static QString getConnection();
+  void insert(QSqlDatabase &db, const DseRun &run);
+
+public:
+  DseStore(QVector<DseRun> *runs) {
+    this->runs = runs;
+  }
+
+  bool open(QString filename);
+
+  // reads all runs from the database
+  bool load();
+
+  // writes all runs to the database, replacing its contents
+  bool save();
+
+  // adds a run, replacing an earlier run with the same genome
+  bool add(const DseRun &run);
+
+  // index of the run with the given genome, -1 if none
+  int find(const QVector<unsigned> &genome) const {
+    return index.value(genome, -1);
+  }
+
+  void clear() {
+    runs->clear();
+    index.clear();
+  }
+
+  QString getMeta(QString key);
+  void setMeta(QString key, QString value);
+};
+
+#endif
@@ -0,0 +1,467 @@
+/******************************************************************************
+ *
+ *  This file is part of the TULIPP Analysis Utility
+ *
+ *  Copyright 2018 Asbjørn Djupdal, NTNU, TULIPP EU Project
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *****************************************************************************/
+
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QHostInfo>
+#include <QMessageAuthenticationCode>
+#include <QProcessEnvironment>
+#include <QDataStream>
+#include <QDirIterator>
+#include <QRegularExpression>
+
+#include <sstream>
+
+#include "dseworker.h"
+#include "dsealgorithm.h"
+
+// files the DSE needs to profile a build, the upload scripts look for the *_init.tcl files in _sds
+static const QStringList artifactFilters = QStringList() << "*.elf" << "*.bit" << "*.xml" << "*_init.tcl";
+
+DseWorker::~DseWorker() {
+  if(project) delete project;
+  delete profile;
+}
+
+bool DseWorker::isTcpAddress(QString address, QString *host, quint16 *port) {
+  int colon = address.lastIndexOf(':');
+  if(colon < 0) return false;
+
+  bool ok;
+  unsigned p = address.mid(colon + 1).toUInt(&ok);
+  if(!ok || (p > 65535)) return false;
+
+  if(host) *host = address.left(colon);
+  if(port) *port = p;
+
+  return true;
+}
+
+bool DseWorker::resolveHost(QString host, QHostAddress *address) {
+  if(host == "") {
+    *address = QHostAddress::LocalHost;
+    return true;
+  }
+
+  if(host == "*") {
+    *address = QHostAddress::Any;
+    return true;
+  }
+
+  if(address->setAddress(host)) return true;
+
+  QHostInfo info = QHostInfo::fromName(host);
+  if((info.error() != QHostInfo::NoError) || info.addresses().isEmpty()) return false;
+
+  *address = info.addresses()[0];
+  return true;
+}
+
+QString DseWorker::getSecret() {
+  QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
+  if(env.contains("TULIPP_DSE_SECRET")) return env.value("TULIPP_DSE_SECRET");
+  return Config::dseWorkerSecret;
+}
+
+QByteArray DseWorker::authResponse(const QByteArray &role, const QByteArray &nonce) {
+  // the role is part of the MAC, so that an answer from one side can't be replayed as the other side's
+  return QMessageAuthenticationCode::hash(role + nonce, getSecret().toUtf8(), QCryptographicHash::Sha256);
+}
+
+bool DseWorker::makeNonce(QByteArray &nonce) {
+  QFile random("/dev/urandom");
+  if(!random.open(QIODevice::ReadOnly)) return false;
+  nonce = random.read(DSE_WORKER_NONCE_SIZE);
+  random.close();
+
+  return nonce.size() == DSE_WORKER_NONCE_SIZE;
+}
+
+bool DseWorker::checkResponse(const QByteArray &response, const QByteArray &expected) {
+  if(response.size() != expected.size()) return false;
+
+  // compare all bytes, so that the time taken does not tell how much of the response is right
+  char diff = 0;
+  for(int i = 0; i < expected.size(); i++) {
+    diff |= response[i] ^ expected[i];
+  }
+
+  return diff == 0;
+}
+
+bool DseWorker::authenticate(QIODevice *socket) {
+  QByteArray nonce;
+  if(!makeNonce(nonce)) return false;
+
+  // the peer is unknown until it has answered, so it gets neither a large buffer nor unlimited time
+  QByteArray response;
+  if(!sendMessage(socket, nonce) || !readMessage(socket, response, 1024, DSE_WORKER_CONNECT_TIMEOUT)) return false;
+  if(!checkResponse(response, authResponse("client", nonce))) return false;
+
+  // the DSE only trusts the results after the worker has answered its nonce
+  QByteArray clientNonce;
+  if(!readMessage(socket, clientNonce, DSE_WORKER_NONCE_SIZE, DSE_WORKER_CONNECT_TIMEOUT)) return false;
+  if(clientNonce.size() != DSE_WORKER_NONCE_SIZE) return false;
+
+  return sendMessage(socket, authResponse("worker", clientNonce));
+}
+
+bool DseWorker::authenticateWorker(QIODevice *socket) {
+  QByteArray nonce;
+  if(!readMessage(socket, nonce, DSE_WORKER_NONCE_SIZE, DSE_WORKER_CONNECT_TIMEOUT)) return false;
+  if(!sendMessage(socket, authResponse("client", nonce))) return false;
+
+  QByteArray clientNonce;
+  if(!makeNonce(clientNonce)) return false;
+
+  QByteArray response;
+  if(!sendMessage(socket, clientNonce) || !readMessage(socket, response, 1024, DSE_WORKER_CONNECT_TIMEOUT)) return false;
+
+  return checkResponse(response, authResponse("worker", clientNonce));
+}
+
+bool DseWorker::validJob(QString path, QString configType, QString extraCompileOptions) {
+  // the values end up in shell commands and makefiles, so only plain characters are accepted
+  static const QRegularExpression pathRe("^/[A-Za-z0-9_./+-]*$");
+  static const QRegularExpression configRe("^[A-Za-z0-9_.+-]*$");
+  static const QRegularExpression optionRe("^-(D|U|I|O|f|m|W|g|std=)[A-Za-z0-9_=.,/+:-]*$");
+
+  if(!pathRe.match(path).hasMatch() || !QDir(path).exists()) return false;
+  if(!configRe.match(configType).hasMatch()) return false;
+
+  for(auto option : extraCompileOptions.split(' ', QString::SkipEmptyParts)) {
+    if(!optionRe.match(option).hasMatch()) return false;
+  }
+
+  return true;
+}
+
+bool DseWorker::validHwFiles(const QMap<QString,QStringList> &hwFiles) {
+  // the transformations DseGene::getTransformations() creates
+  static const QRegularExpression transformationRe("^-(pipeloop|unrollloop|unroll|array|dim|partition|factor|dataflow|inline|noinline)=[A-Za-z0-9_.,:~]*$");
+
+  QStringList sources = project->sources;
+  for(auto acc : project->accelerators) {
+    sources << acc.filepath;
+  }
+
+  for(auto f : hwFiles.toStdMap()) {
+    if(!sources.contains(f.first)) return false;
+
+    for(auto transformation : f.second) {
+      if(!transformationRe.match(transformation).hasMatch()) return false;
+    }
+  }
+
+  return true;
+}
+
+bool DseWorker::validArtifact(QString filename) {
+  // the files are written below the build directory of the DSE, so they must stay there
+  if(filename.isEmpty() || QDir::isAbsolutePath(filename) || filename.contains('\\')) return false;
+  if(filename.split('/').contains("..") || (QDir::cleanPath(filename) != filename)) return false;
+
+  return QDir::match(artifactFilters, QFileInfo(filename).fileName());
+}
+
+bool DseWorker::sendMessage(QIODevice *socket, const QByteArray &msg) {
+  QByteArray header;
+  QDataStream out(&header, QIODevice::WriteOnly);
+  out << (quint32)msg.size();
+
+  if(socket->write(header) != header.size()) return false;
+  if(socket->write(msg) != msg.size()) return false;
+
+  while(socket->bytesToWrite()) {
+    if(!socket->waitForBytesWritten(-1)) return false;
+  }
+
+  return true;
+}
+
+bool DseWorker::readBytes(QIODevice *socket, qint64 size, QByteArray &data, int timeout) {
+  data.clear();
+
+  // builds take a long time, so there is no timeout by default.  The read fails if the other side disconnects.
+  while(data.size() < size) {
+    if(!socket->bytesAvailable() && !socket->waitForReadyRead(timeout)) return false;
+    data += socket->read(size - data.size());
+  }
+
+  return true;
+}
+
+bool DseWorker::readMessage(QIODevice *socket, QByteArray &msg, quint32 maxSize, int timeout) {
+  QByteArray header;
+  if(!readBytes(socket, sizeof(quint32), header, timeout)) return false;
+
+  quint32 size;
+  QDataStream in(header);
+  in >> size;
+
+  if(size > maxSize) return false;
+
+  return readBytes(socket, size, msg, timeout);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool DseWorker::run(QString address) {
+  QLocalServer localServer;
+  QTcpServer tcpServer;
+
+  // several workers can run in the same project directory
+  workName = "dse-worker-" + QString(address).replace(QRegularExpression("[^A-Za-z0-9_.-]"), "_");
+
+  QString host;
+  quint16 port;
+  bool tcp = isTcpAddress(address, &host, &port);
+
+  if(tcp) {
+    if(getSecret() == "") {
+      printf("A TCP worker needs a shared secret, set TULIPP_DSE_SECRET\n");
+      return false;
+    }
+
+    QHostAddress hostAddress;
+    if(!resolveHost(host, &hostAddress)) {
+      printf("Can't resolve %s\n", host.toUtf8().constData());
+      return false;
+    }
+
+    if(!tcpServer.listen(hostAddress, port)) {
+      printf("Can't listen on %s: %s\n", address.toUtf8().constData(), tcpServer.errorString().toUtf8().constData());
+      return false;
+    }
+
+  } else {
+    QLocalServer::removeServer(address);
+    localServer.setSocketOptions(QLocalServer::UserAccessOption);
+
+    if(!localServer.listen(address)) {
+      printf("Can't listen on %s: %s\n", address.toUtf8().constData(), localServer.errorString().toUtf8().constData());
+      return false;
+    }
+  }
+
+  printf("DSE worker listening on %s\n", address.toUtf8().constData());
+  fflush(stdout);
+
+  while(true) {
+    QIODevice *socket = NULL;
+
+    if(tcp) {
+      if(tcpServer.waitForNewConnection(-1)) socket = tcpServer.nextPendingConnection();
+    } else {
+      if(localServer.waitForNewConnection(-1)) socket = localServer.nextPendingConnection();
+    }
+
+    if(!socket) continue;
+
+    if(!authenticate(socket)) {
+      printf("DSE job rejected, authentication failed\n");
+      fflush(stdout);
+      socket->close();
+      delete socket;
+      continue;
+    }
+
+    QByteArray job;
+    while(readMessage(socket, job, DSE_WORKER_MAX_JOB)) {
+      QByteArray reply;
+      if(!handleJob(job, reply)) break;
+      if(!sendMessage(socket, reply)) break;
+    }
+
+    socket->close();
+    delete socket;
+  }
+
+  return true;
+}
+
+bool DseWorker::handleJob(QByteArray &job, QByteArray &reply) {
+  QDataStream in(job);
+  in.setVersion(QDataStream::Qt_5_0);
+
+  quint32 protocol;
+  in >> protocol;
+
+  if(protocol != DSE_WORKER_PROTOCOL) {
+    printf("Unsupported DSE job protocol %u\n", protocol);
+    return false;
+  }
+
+  QString path;
+  QString configType;
+  quint32 version;
+  QString extraCompileOptions;
+  QMap<QString,QStringList> hwFiles;
+
+  in >> path >> configType >> version >> extraCompileOptions >> hwFiles;
+
+  if(in.status() != QDataStream::Ok) {
+    printf("Malformed DSE job\n");
+    return false;
+  }
+
+  if(!validJob(path, configType, extraCompileOptions)) {
+    printf("DSE job rejected, invalid project or options\n");
+    return false;
+  }
+
+  // opening a project is slow, so it is only done when the DSE changes project
+  if(!project || (project->path != path) || (project->configType != configType) || (project->getVersion() != version)) {
+    if(project) delete project;
+
+    project = Sdsoc::createSdsoc(version, profile);
+
+    if(!project || !project->openProject(path, configType)) {
+      printf("Can't open project %s\n", path.toUtf8().constData());
+      if(project) delete project;
+      project = NULL;
+      return false;
+    }
+  }
+
+  if(!validHwFiles(hwFiles)) {
+    printf("DSE job rejected, invalid transformations\n");
+    return false;
+  }
+
+  Config::extraCompileOptions = extraCompileOptions;
+
+  printf("Building %s\n", path.toUtf8().constData());
+  fflush(stdout);
+
+  Sdsoc *sdsoc = Sdsoc::copySdsoc(project, profile);
+  sdsoc->buildDir = QFileInfo(project->buildPath(workName)).absoluteFilePath();
+
+  QDir dir(sdsoc->buildDir);
+  if(dir.exists()) dir.removeRecursively();
+  dir.mkpath(".");
+
+  DseAlgorithm::buildProject(sdsoc, hwFiles);
+
+  QMap<QString,QByteArray> files;
+
+  if(!sdsoc->errorCode) {
+    QDirIterator dirIt(sdsoc->buildDir, artifactFilters, QDir::Files, QDirIterator::Subdirectories);
+    while(dirIt.hasNext()) {
+      QString filename = dirIt.next();
+      QFile file(filename);
+      if(file.open(QIODevice::ReadOnly)) {
+        files[dir.relativeFilePath(filename)] = file.readAll();
+        file.close();
+      }
+    }
+  }
+
+  std::stringstream synthesis;
+  synthesis << *sdsoc;
+
+  QDataStream out(&reply, QIODevice::WriteOnly);
+  out.setVersion(QDataStream::Qt_5_0);
+  out << (qint32)sdsoc->errorCode << QString::fromStdString(synthesis.str()) << files;
+
+  delete sdsoc;
+
+  return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool DseWorker::build(QString address, Sdsoc *project, QMap<QString,QStringList> hwFiles) {
+  QLocalSocket localSocket;
+  QTcpSocket tcpSocket;
+  QIODevice *socket;
+
+  QString host;
+  quint16 port;
+
+  if(isTcpAddress(address, &host, &port)) {
+    tcpSocket.connectToHost(host == "" ? QString("localhost") : host, port);
+    if(!tcpSocket.waitForConnected(DSE_WORKER_CONNECT_TIMEOUT)) return false;
+    socket = &tcpSocket;
+
+  } else {
+    localSocket.connectToServer(address);
+    if(!localSocket.waitForConnected(DSE_WORKER_CONNECT_TIMEOUT)) return false;
+    socket = &localSocket;
+  }
+
+  QByteArray job;
+  {
+    QDataStream out(&job, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_5_0);
+    out << (quint32)DSE_WORKER_PROTOCOL << project->path << project->configType << (quint32)project->getVersion()
+        << Config::extraCompileOptions << hwFiles;
+  }
+
+  if(!authenticateWorker(socket)) {
+    printf("DSE worker %s failed authentication\n", address.toUtf8().constData());
+    socket->close();
+    return false;
+  }
+
+  QByteArray reply;
+  bool success = sendMessage(socket, job) && readMessage(socket, reply, DSE_WORKER_MAX_REPLY);
+  socket->close();
+
+  if(!success) return false;
+
+  qint32 errorCode;
+  QString synthesis;
+  QMap<QString,QByteArray> files;
+
+  QDataStream in(reply);
+  in.setVersion(QDataStream::Qt_5_0);
+  in >> errorCode >> synthesis >> files;
+
+  if(in.status() != QDataStream::Ok) return false;
+
+  for(auto filename : files.keys()) {
+    if(!validArtifact(filename)) {
+      printf("DSE worker %s sent an invalid file name\n", address.toUtf8().constData());
+      return false;
+    }
+  }
+
+  for(auto f : files.toStdMap()) {
+    QFileInfo fileInfo(project->buildPath(f.first));
+    fileInfo.dir().mkpath(".");
+
+    QFile file(fileInfo.filePath());
+    if(!file.open(QIODevice::WriteOnly)) return false;
+    file.write(f.second);
+    file.close();
+  }
+
+  std::istringstream ss(synthesis.toStdString());
+  ss >> *project;
+
+  project->errorCode = errorCode;
+  if(!errorCode) project->loadFiles();
+
+  return true;
+}
@@ -0,0 +1,98 @@
+/******************************************************************************
+ *
+ *  This file is part of the TULIPP Analysis Utility
+ *
+ *  Copyright 2018 Asbjørn Djupdal, NTNU, TULIPP EU Project
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *****************************************************************************/
+
+#ifndef DSEWORKER_H
+#define DSEWORKER_H
+
+#include <QString>
+#include <QStringList>
+#include <QMap>
+#include <QByteArray>
+#include <QIODevice>
+#include <QHostAddress>
+
+#include "project/sdsoc.h"
+#include "profile/profile.h"
+
+#define DSE_WORKER_PROTOCOL 3
+#define DSE_WORKER_CONNECT_TIMEOUT 5000
+#define DSE_WORKER_NONCE_SIZE 32
+#define DSE_WORKER_MAX_JOB (16 * 1024 * 1024)
+#define DSE_WORKER_MAX_REPLY (1024 * 1024 * 1024)
+
+// Builds DSE individuals for a DSE running in another process, possibly on another host.  The DSE
+// sends the project and the source transformations of a genome, the worker runs the source tool and
+// makeBin and sends back the synthesis results and the files needed for profiling.  Profiling is
+// always done by the DSE, on the host with the PMU.
+//
+// Workers are addressed either as host:port (TCP) or as a local socket name or path.  The worker must
+// be able to open the project with the same path as the DSE.  A TCP worker listens on the loopback
+// interface when the host is empty, on all interfaces only when the host is '*'.  Host names are
+// resolved, and the worker refuses to start if they don't resolve.
+//
+// Jobs end up in shell commands and results end up in the build directory, so every connection
+// starts with a mutual challenge: each side sends a random nonce and the other side answers with its
+// HMAC-SHA256, keyed with the shared secret from TULIPP_DSE_SECRET or the dseWorkerSecret setting.
+// TCP workers refuse to start without a secret.  Jobs are also checked before anything runs: the
+// hardware files must be sources of the project, and only known source tool transformations and plain
+// compiler flags are accepted.  The DSE only writes returned files with the expected names, below
+// the build directory.
+class DseWorker {
+
+private:
+  Profile *profile;
+  Sdsoc *project;
+  QString workName;
+
+  bool handleJob(QByteArray &job, QByteArray &reply);
+  bool authenticate(QIODevice *socket);
+  bool validHwFiles(const QMap<QString,QStringList> &hwFiles);
+
+  static bool readBytes(QIODevice *socket, qint64 size, QByteArray &data, int timeout = -1);
+  static QByteArray authResponse(const QByteArray &role, const QByteArray &nonce);
+  static bool makeNonce(QByteArray &nonce);
+  static bool checkResponse(const QByteArray &response, const QByteArray &expected);
+  static bool authenticateWorker(QIODevice *socket);
+  static bool validJob(QString path, QString configType, QString extraCompileOptions);
+  static bool validArtifact(QString filename);
+
+public:
+  DseWorker() {
+    profile = new Profile;
+    project = NULL;
+  }
+  ~DseWorker();
+
+  // serves jobs until killed, returns false if the address can't be listened on
+  bool run(QString address);
+
+  // builds the project on the worker and puts the results in the build directory of the project.
+  // Returns false if the worker can't be reached, the project is built locally instead in that case.
+  static bool build(QString address, Sdsoc *project, QMap<QString,QStringList> hwFiles);
+
+  static bool isTcpAddress(QString address, QString *host = NULL, quint16 *port = NULL);
+  static bool resolveHost(QString host, QHostAddress *address);
+  static QString getSecret();
+  static bool sendMessage(QIODevice *socket, const QByteArray &msg);
+  static bool readMessage(QIODevice *socket, QByteArray &msg, quint32 maxSize = 0xffffffff, int timeout = -1);
+};
+
+#endif
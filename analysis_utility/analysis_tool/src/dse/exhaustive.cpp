@@ -22,23 +22,27 @@
 #include "exhaustive.h"
 #include "dserun.h"
 
-void Exhaustive::runAll(std::ostream &outStream, QVector<Loop*> loops, QVector<unsigned> loopDepths, int n,
-                        QVector<unsigned> genome) {
-  if(n >= loopDepths.size()) {
-    testGenome(outStream, loops, genome);
-    emit advance(runCounter++);
+void Exhaustive::getAll(QVector<unsigned> geneMax, int n, QVector<unsigned> genome,
+                        QVector<QVector<unsigned>> &genomes) {
+  if(n >= geneMax.size()) {
+    genomes.push_back(genome);
     return;
   }
-  for(unsigned depth = 0; depth <= loopDepths[n]; depth++) {
-    genome.push_back(depth);
-    runAll(outStream, loops, loopDepths, n+1, genome);
+  for(unsigned value = 0; value <= geneMax[n]; value++) {
+    genome.push_back(value);
+    getAll(geneMax, n+1, genome, genomes);
     genome.removeLast();
   }
 }
 
 void Exhaustive::run() {
   runCounter = 1;
-  runAll(*outStream, loops, loopDepths, 0, QVector<unsigned>());
+
+  QVector<QVector<unsigned>> genomes;
+  getAll(geneMax, 0, QVector<unsigned>(), genomes);
+
+  testGenomes(genes, genomes);
+
   emit finished();
 }
 
@@ -29,14 +29,12 @@
 class Exhaustive : public DseAlgorithm {
 
 private:
-  int runCounter;
-
-  void runAll(std::ostream &outStream, QVector<Loop*> loops, QVector<unsigned> loopDepths, int n, QVector<unsigned> genome);
+  void getAll(QVector<unsigned> geneMax, int n, QVector<unsigned> genome, QVector<QVector<unsigned>> &genomes);
 
 public:
-  Exhaustive(Sdsoc *mainProject, unsigned fitnessChoice, QVector<DseRun> *dseRuns, std::ostream *outStream,
-             QVector<Loop*> loops, QVector<unsigned> loopDepths, bool rerunFailed) :
-    DseAlgorithm(mainProject, fitnessChoice, dseRuns, outStream, loops, loopDepths, rerunFailed) {}
+  Exhaustive(Sdsoc *mainProject, unsigned fitnessChoice, QVector<DseRun> *dseRuns, DseStore *store,
+             QVector<DseGene> genes, QVector<unsigned> geneMax, bool rerunFailed, unsigned buildJobs) :
+    DseAlgorithm(mainProject, fitnessChoice, dseRuns, store, genes, geneMax, rerunFailed, buildJobs) {}
   ~Exhaustive() {
   }
 
@@ -0,0 +1,150 @@
+/******************************************************************************
+ *
+ *  This file is part of the TULIPP Analysis Utility
+ *
+ *  Copyright 2018 Asbjørn Djupdal, NTNU, TULIPP EU Project
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *****************************************************************************/
+
+#include <algorithm>
+
+#include "ga.h"
+#include "dserun.h"
+
+QVector<unsigned> Ga::randomGenome() {
+  QVector<unsigned> genome;
+  for(auto max : geneMax) {
+    std::uniform_int_distribution<unsigned> gene(0, max);
+    genome.push_back(gene(rng));
+  }
+  return genome;
+}
+
+QVector<unsigned> Ga::tournament(QVector<QVector<unsigned>> &population, QVector<double> &fitness) {
+  std::uniform_int_distribution<int> pick(0, population.size()-1);
+
+  int best = pick(rng);
+  for(int i = 1; i < GA_TOURNAMENT_SIZE; i++) {
+    int contender = pick(rng);
+    if(fitness[contender] < fitness[best]) best = contender;
+  }
+
+  return population[best];
+}
+
+QVector<unsigned> Ga::crossover(QVector<unsigned> &a, QVector<unsigned> &b) {
+  // uniform crossover
+  std::bernoulli_distribution fromA(0.5);
+
+  QVector<unsigned> child;
+  for(int i = 0; i < a.size(); i++) {
+    child.push_back(fromA(rng) ? a[i] : b[i]);
+  }
+  return child;
+}
+
+void Ga::mutate(QVector<unsigned> &genome) {
+  // on average one gene is changed, genes of components that are not explored are fixed
+  int freeGenes = 0;
+  for(auto max : geneMax) {
+    if(max) freeGenes++;
+  }
+  if(!freeGenes) return;
+
+  std::bernoulli_distribution mutateGene(1.0 / freeGenes);
+
+  for(int i = 0; i < genome.size(); i++) {
+    if(geneMax[i] && mutateGene(rng)) {
+      std::uniform_int_distribution<unsigned> gene(0, geneMax[i]-1);
+      unsigned g = gene(rng);
+      if(g >= genome[i]) g++;
+      genome[i] = g;
+    }
+  }
+}
+
+void Ga::run() {
+  runCounter = 1;
+
+  if(!geneMax.size()) {
+    emit finished();
+    return;
+  }
+
+  QVector<QVector<unsigned>> population;
+
+  // when resuming, start with the best genomes from earlier runs
+  {
+    QVector<DseRun> previousRuns;
+    for(auto r : *dseRuns) {
+      if(!r.failed && (r.genome.size() == geneMax.size()) && (fitnessFunction(&r) < INT_MAX)) {
+        previousRuns.push_back(r);
+      }
+    }
+
+    std::sort(previousRuns.begin(), previousRuns.end(), [this](DseRun &a, DseRun &b) {
+        return fitnessFunction(&a) < fitnessFunction(&b);
+      });
+
+    for(auto r : previousRuns) {
+      if((unsigned)population.size() >= populationSize / 2) break;
+      if(!population.contains(r.genome)) population.push_back(r.genome);
+    }
+  }
+
+  while((unsigned)population.size() < populationSize) {
+    population.push_back(randomGenome());
+  }
+
+  for(unsigned generation = 0; generation < generations; generation++) {
+    QVector<double> fitness = testGenomes(genes, population);
+
+    if(generation == generations-1) break;
+
+    // elitism
+    QVector<int> order;
+    for(int i = 0; i < population.size(); i++) order.push_back(i);
+    std::sort(order.begin(), order.end(), [&fitness](int a, int b) {
+        return fitness[a] < fitness[b];
+      });
+
+    QVector<QVector<unsigned>> nextPopulation;
+    for(unsigned i = 0; i < GA_ELITES; i++) {
+      nextPopulation.push_back(population[order[i]]);
+    }
+
+    // offspring
+    std::bernoulli_distribution doCrossover(GA_CROSSOVER_RATE);
+
+    while((unsigned)nextPopulation.size() < populationSize) {
+      QVector<unsigned> parent1 = tournament(population, fitness);
+      QVector<unsigned> child = parent1;
+
+      if(doCrossover(rng)) {
+        QVector<unsigned> parent2 = tournament(population, fitness);
+        child = crossover(parent1, parent2);
+      }
+
+      mutate(child);
+
+      nextPopulation.push_back(child);
+    }
+
+    population = nextPopulation;
+  }
+
+  emit finished();
+}
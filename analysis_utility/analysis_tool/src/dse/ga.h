@@ -0,0 +1,62 @@
+/******************************************************************************
+ *
+ *  This file is part of the TULIPP Analysis Utility
+ *
+ *  Copyright 2018 Asbjørn Djupdal, NTNU, TULIPP EU Project
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *****************************************************************************/
+
+#ifndef GA_H
+#define GA_H
+
+#include <QObject>
+#include <random>
+
+#include "dsealgorithm.h"
+
+#define GA_TOURNAMENT_SIZE 2
+#define GA_ELITES 2
+#define GA_CROSSOVER_RATE 0.9
+
+class Ga : public DseAlgorithm {
+
+protected:
+  unsigned populationSize;
+  unsigned generations;
+  std::mt19937 rng;
+
+  QVector<unsigned> randomGenome();
+  QVector<unsigned> tournament(QVector<QVector<unsigned>> &population, QVector<double> &fitness);
+  QVector<unsigned> crossover(QVector<unsigned> &a, QVector<unsigned> &b);
+  void mutate(QVector<unsigned> &genome);
+
+public:
+  Ga(Sdsoc *mainProject, unsigned fitnessChoice, QVector<DseRun> *dseRuns, DseStore *store,
+     QVector<DseGene> genes, QVector<unsigned> geneMax, bool rerunFailed, unsigned buildJobs,
+     unsigned populationSize, unsigned generations) :
+    DseAlgorithm(mainProject, fitnessChoice, dseRuns, store, genes, geneMax, rerunFailed, buildJobs),
+    rng(std::random_device()()) {
+    this->populationSize = populationSize > GA_ELITES ? populationSize : GA_ELITES + 1;
+    this->generations = generations;
+  }
+  ~Ga() {
+  }
+
+public slots:
+  void run();
+};
+
+#endif
@@ -0,0 +1,178 @@
+/******************************************************************************
+ *
+ *  This file is part of the TULIPP Analysis Utility
+ *
+ *  Copyright 2018 Asbjørn Djupdal, NTNU, TULIPP EU Project
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *****************************************************************************/
+
+#include <algorithm>
+
+#include "nsga2.h"
+#include "dserun.h"
+
+void Nsga2::evaluate(QVector<QVector<unsigned>> &population,
+                     QVector<QVector<double>> &values, QVector<double> &violations) {
+  testGenomes(genes, population);
+
+  values.clear();
+  violations.clear();
+
+  for(auto genome : population) {
+    int n = store->find(genome);
+    if(n < 0) {
+      // no run was recorded for this genome, rank it as a failed run
+      values.push_back(QVector<double>(objectives.size(), INT_MAX));
+      violations.push_back(INT_MAX);
+      continue;
+    }
+
+    DseRun *run = &(*dseRuns)[n];
+
+    values.push_back(Pareto::getObjectives(run, objectives));
+    violations.push_back(constraints.violation(run));
+  }
+}
+
+void Nsga2::rank(QVector<QVector<double>> &values, QVector<double> &violations,
+                 QVector<int> &ranks, QVector<double> &distances) {
+  ranks = QVector<int>(values.size(), 0);
+  distances = QVector<double>(values.size(), 0);
+
+  QVector<QVector<int>> fronts = Pareto::sortFronts(values, violations);
+
+  for(int r = 0; r < fronts.size(); r++) {
+    QVector<double> d = Pareto::crowdingDistances(values, fronts[r]);
+    for(int i = 0; i < fronts[r].size(); i++) {
+      ranks[fronts[r][i]] = r;
+      distances[fronts[r][i]] = d[i];
+    }
+  }
+}
+
+QVector<unsigned> Nsga2::tournament(QVector<QVector<unsigned>> &population, QVector<int> &ranks, QVector<double> &distances) {
+  std::uniform_int_distribution<int> pick(0, population.size()-1);
+
+  int best = pick(rng);
+  for(int i = 1; i < GA_TOURNAMENT_SIZE; i++) {
+    int contender = pick(rng);
+    if((ranks[contender] < ranks[best]) ||
+       ((ranks[contender] == ranks[best]) && (distances[contender] > distances[best]))) {
+      best = contender;
+    }
+  }
+
+  return population[best];
+}
+
+void Nsga2::run() {
+  runCounter = 1;
+
+  if(!geneMax.size() || !objectives.size()) {
+    emit finished();
+    return;
+  }
+
+  QVector<QVector<unsigned>> population;
+
+  // when resuming, start with the Pareto front of earlier runs
+  for(auto i : Pareto::getFront(dseRuns, objectives, constraints)) {
+    if((unsigned)population.size() >= populationSize / 2) break;
+    QVector<unsigned> genome = (*dseRuns)[i].genome;
+    if((genome.size() == geneMax.size()) && !population.contains(genome)) population.push_back(genome);
+  }
+
+  while((unsigned)population.size() < populationSize) {
+    population.push_back(randomGenome());
+  }
+
+  QVector<QVector<double>> values;
+  QVector<double> violations;
+  evaluate(population, values, violations);
+
+  for(unsigned generation = 1; generation < generations; generation++) {
+    QVector<int> ranks;
+    QVector<double> distances;
+    rank(values, violations, ranks, distances);
+
+    // offspring
+    std::bernoulli_distribution doCrossover(GA_CROSSOVER_RATE);
+
+    QVector<QVector<unsigned>> offspring;
+    while((unsigned)offspring.size() < populationSize) {
+      QVector<unsigned> parent1 = tournament(population, ranks, distances);
+      QVector<unsigned> child = parent1;
+
+      if(doCrossover(rng)) {
+        QVector<unsigned> parent2 = tournament(population, ranks, distances);
+        child = crossover(parent1, parent2);
+      }
+
+      mutate(child);
+
+      offspring.push_back(child);
+    }
+
+    QVector<QVector<double>> offspringValues;
+    QVector<double> offspringViolations;
+    evaluate(offspring, offspringValues, offspringViolations);
+
+    // combine parents and offspring, without duplicate genomes
+    QVector<QVector<unsigned>> combined = population;
+    QVector<QVector<double>> combinedValues = values;
+    QVector<double> combinedViolations = violations;
+
+    for(int i = 0; i < offspring.size(); i++) {
+      if(!combined.contains(offspring[i])) {
+        combined.push_back(offspring[i]);
+        combinedValues.push_back(offspringValues[i]);
+        combinedViolations.push_back(offspringViolations[i]);
+      }
+    }
+
+    // select the next population front by front, the last front by crowding distance
+    population.clear();
+    values.clear();
+    violations.clear();
+
+    for(auto front : Pareto::sortFronts(combinedValues, combinedViolations)) {
+      if((unsigned)population.size() >= populationSize) break;
+
+      if((unsigned)(population.size() + front.size()) > populationSize) {
+        QVector<double> d = Pareto::crowdingDistances(combinedValues, front);
+
+        QVector<int> order;
+        for(int i = 0; i < front.size(); i++) order.push_back(i);
+        std::sort(order.begin(), order.end(), [&d](int a, int b) {
+            return d[a] > d[b];
+          });
+
+        QVector<int> sortedFront;
+        for(auto i : order) sortedFront.push_back(front[i]);
+        front = sortedFront;
+      }
+
+      for(auto i : front) {
+        if((unsigned)population.size() >= populationSize) break;
+        population.push_back(combined[i]);
+        values.push_back(combinedValues[i]);
+        violations.push_back(combinedViolations[i]);
+      }
+    }
+  }
+
+  emit finished();
+}
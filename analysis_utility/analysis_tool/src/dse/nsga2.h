@@ -0,0 +1,59 @@
+/******************************************************************************
+ *
+ *  This file is part of the TULIPP Analysis Utility
+ *
+ *  Copyright 2018 Asbjørn Djupdal, NTNU, TULIPP EU Project
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *****************************************************************************/
+
+#ifndef NSGA2_H
+#define NSGA2_H
+
+#include <QObject>
+
+#include "ga.h"
+#include "pareto.h"
+
+class Nsga2 : public Ga {
+
+private:
+  QVector<unsigned> objectives;
+  DseConstraints constraints;
+
+  void evaluate(QVector<QVector<unsigned>> &population,
+                QVector<QVector<double>> &values, QVector<double> &violations);
+  void rank(QVector<QVector<double>> &values, QVector<double> &violations,
+            QVector<int> &ranks, QVector<double> &distances);
+  QVector<unsigned> tournament(QVector<QVector<unsigned>> &population, QVector<int> &ranks, QVector<double> &distances);
+
+public:
+  Nsga2(Sdsoc *mainProject, QVector<DseRun> *dseRuns, DseStore *store,
+        QVector<DseGene> genes, QVector<unsigned> geneMax, bool rerunFailed, unsigned buildJobs,
+        unsigned populationSize, unsigned generations,
+        QVector<unsigned> objectives, DseConstraints constraints) :
+    Ga(mainProject, objectives.size() ? objectives[0] : FITNESS_RUNTIME, dseRuns, store, genes, geneMax,
+       rerunFailed, buildJobs, populationSize, generations) {
+    this->objectives = objectives;
+    this->constraints = constraints;
+  }
+  ~Nsga2() {
+  }
+
+public slots:
+  void run();
+};
+
+#endif
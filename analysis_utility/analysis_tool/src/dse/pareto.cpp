@@ -0,0 +1,198 @@
+/******************************************************************************
+ *
+ *  This file is part of the TULIPP Analysis Utility
+ *
+ *  Copyright 2018 Asbjørn Djupdal, NTNU, TULIPP EU Project
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *****************************************************************************/
+
+#include <algorithm>
+#include <math.h>
+
+#include "pareto.h"
+#include "dsealgorithm.h"
+
+double DseConstraints::violation(DseRun *run) const {
+  if(run->failed) return INT_MAX;
+
+  double v = 0;
+
+  if(timingOk && !run->project->getTimingOk()) v += 100;
+  if(run->project->getBrams() > maxBrams) v += run->project->getBrams() - maxBrams;
+  if(run->project->getLuts() > maxLuts) v += run->project->getLuts() - maxLuts;
+  if(run->project->getDsps() > maxDsps) v += run->project->getDsps() - maxDsps;
+  if(run->project->getRegs() > maxRegs) v += run->project->getRegs() - maxRegs;
+
+  return v;
+}
+
+QVector<double> Pareto::getObjectives(DseRun *run, const QVector<unsigned> &objectives) {
+  QVector<double> values;
+  for(auto objective : objectives) {
+    if(run->failed) values.push_back(INT_MAX);
+    else values.push_back(DseAlgorithm::getFitness(run->profile, run->project, objective));
+  }
+  return values;
+}
+
+bool Pareto::dominates(const QVector<double> &a, const QVector<double> &b) {
+  bool better = false;
+  for(int i = 0; i < a.size(); i++) {
+    if(a[i] > b[i]) return false;
+    if(a[i] < b[i]) better = true;
+  }
+  return better;
+}
+
+bool Pareto::constrainedDominates(const QVector<double> &a, double violationA,
+                                  const QVector<double> &b, double violationB) {
+  if((violationA == 0) && (violationB > 0)) return true;
+  if(violationA > 0) return (violationB > 0) && (violationA < violationB);
+  return (violationB == 0) && dominates(a, b);
+}
+
+QVector<QVector<int>> Pareto::sortFronts(const QVector<QVector<double>> &values, const QVector<double> &violations) {
+  int n = values.size();
+
+  QVector<QVector<int>> dominatedBy(n);
+  QVector<int> dominationCount(n, 0);
+  QVector<QVector<int>> fronts;
+
+  QVector<int> front;
+  for(int p = 0; p < n; p++) {
+    for(int q = 0; q < n; q++) {
+      if(p == q) continue;
+      if(constrainedDominates(values[p], violations[p], values[q], violations[q])) {
+        dominatedBy[p].push_back(q);
+      } else if(constrainedDominates(values[q], violations[q], values[p], violations[p])) {
+        dominationCount[p]++;
+      }
+    }
+    if(dominationCount[p] == 0) front.push_back(p);
+  }
+
+  while(front.size()) {
+    fronts.push_back(front);
+
+    QVector<int> next;
+    for(auto p : front) {
+      for(auto q : dominatedBy[p]) {
+        if(--dominationCount[q] == 0) next.push_back(q);
+      }
+    }
+    front = next;
+  }
+
+  return fronts;
+}
+
+QVector<double> Pareto::crowdingDistances(const QVector<QVector<double>> &values, const QVector<int> &front) {
+  QVector<double> distances(front.size(), 0);
+  if(!front.size()) return distances;
+
+  int numObjectives = values[front[0]].size();
+
+  for(int m = 0; m < numObjectives; m++) {
+    QVector<int> order;
+    for(int i = 0; i < front.size(); i++) order.push_back(i);
+
+    std::sort(order.begin(), order.end(), [&values, &front, m](int a, int b) {
+        return values[front[a]][m] < values[front[b]][m];
+      });
+
+    double minValue = values[front[order.first()]][m];
+    double maxValue = values[front[order.last()]][m];
+
+    distances[order.first()] = INFINITY;
+    distances[order.last()] = INFINITY;
+
+    if(maxValue == minValue) continue;
+
+    for(int i = 1; i < order.size()-1; i++) {
+      distances[order[i]] += (values[front[order[i+1]]][m] - values[front[order[i-1]]][m]) / (maxValue - minValue);
+    }
+  }
+
+  return distances;
+}
+
+QVector<int> Pareto::getFront(QVector<DseRun> *runs, const QVector<unsigned> &objectives,
+                              const DseConstraints &constraints) {
+  QVector<int> feasible;
+  QVector<QVector<double>> values;
+
+  for(int i = 0; i < runs->size(); i++) {
+    DseRun *run = &(*runs)[i];
+    if(constraints.violation(run) == 0) {
+      feasible.push_back(i);
+      values.push_back(getObjectives(run, objectives));
+    }
+  }
+
+  QVector<int> front;
+  for(int p = 0; p < feasible.size(); p++) {
+    bool dominated = false;
+    bool duplicate = false;
+    for(int q = 0; q < feasible.size(); q++) {
+      if(dominates(values[q], values[p])) {
+        dominated = true;
+        break;
+      }
+      // keep only one of several runs with identical objectives
+      if((q < p) && (values[q] == values[p])) duplicate = true;
+    }
+    if(!dominated && !duplicate) front.push_back(feasible[p]);
+  }
+
+  return front;
+}
+
+int Pareto::getKneePoint(QVector<DseRun> *runs, const QVector<int> &front, const QVector<unsigned> &objectives) {
+  if(!front.size()) return -1;
+
+  QVector<QVector<double>> values;
+  for(auto i : front) {
+    values.push_back(getObjectives(&(*runs)[i], objectives));
+  }
+
+  QVector<double> minValues = values[0];
+  QVector<double> maxValues = values[0];
+  for(auto v : values) {
+    for(int m = 0; m < v.size(); m++) {
+      if(v[m] < minValues[m]) minValues[m] = v[m];
+      if(v[m] > maxValues[m]) maxValues[m] = v[m];
+    }
+  }
+
+  int knee = front[0];
+  double kneeDistance = INFINITY;
+
+  for(int i = 0; i < values.size(); i++) {
+    double distance = 0;
+    for(int m = 0; m < values[i].size(); m++) {
+      if(maxValues[m] > minValues[m]) {
+        double normalized = (values[i][m] - minValues[m]) / (maxValues[m] - minValues[m]);
+        distance += normalized * normalized;
+      }
+    }
+    if(distance < kneeDistance) {
+      kneeDistance = distance;
+      knee = front[i];
+    }
+  }
+
+  return knee;
+}
@@ -0,0 +1,73 @@
+/******************************************************************************
+ *
+ *  This file is part of the TULIPP Analysis Utility
+ *
+ *  Copyright 2018 Asbjørn Djupdal, NTNU, TULIPP EU Project
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *****************************************************************************/
+
+#ifndef PARETO_H
+#define PARETO_H
+
+#include <QVector>
+
+#include "dserun.h"
+
+class DseConstraints {
+public:
+  bool timingOk;
+  double maxBrams;
+  double maxLuts;
+  double maxDsps;
+  double maxRegs;
+
+  DseConstraints() {
+    timingOk = true;
+    maxBrams = 100;
+    maxLuts = 100;
+    maxDsps = 100;
+    maxRegs = 100;
+  }
+
+  // 0 if all constraints are met, otherwise a measure of how much they are violated
+  double violation(DseRun *run) const;
+};
+
+class Pareto {
+public:
+  static QVector<double> getObjectives(DseRun *run, const QVector<unsigned> &objectives);
+
+  // true if a is no worse than b in all objectives and better in at least one
+  static bool dominates(const QVector<double> &a, const QVector<double> &b);
+
+  // feasible solutions dominate infeasible ones, infeasible ones are compared by violation
+  static bool constrainedDominates(const QVector<double> &a, double violationA,
+                                   const QVector<double> &b, double violationB);
+
+  // NSGA-II non-dominated sorting, returns the fronts in rank order
+  static QVector<QVector<int>> sortFronts(const QVector<QVector<double>> &values, const QVector<double> &violations);
+
+  static QVector<double> crowdingDistances(const QVector<QVector<double>> &values, const QVector<int> &front);
+
+  // indices of the feasible, non-dominated runs
+  static QVector<int> getFront(QVector<DseRun> *runs, const QVector<unsigned> &objectives,
+                               const DseConstraints &constraints);
+
+  // the front member closest to the ideal point when all objectives are normalized, -1 for an empty front
+  static int getKneePoint(QVector<DseRun> *runs, const QVector<int> &front, const QVector<unsigned> &objectives);
+};
+
+#endif
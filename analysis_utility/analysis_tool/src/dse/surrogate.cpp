@@ -0,0 +1,149 @@
+/******************************************************************************
+ *
+ *  This file is part of the TULIPP Analysis Utility
+ *
+ *  Copyright 2018 Asbjørn Djupdal, NTNU, TULIPP EU Project
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *****************************************************************************/
+
+#include <math.h>
+#include <algorithm>
+
+#include "surrogate.h"
+
+SurrogateModel::SurrogateModel(QVector<unsigned> geneMax) {
+  this->geneMax = geneMax;
+
+  // bias, plus one indicator for each non-zero value of each gene
+  numFeatures = 1;
+  for(auto max : geneMax) numFeatures += max;
+
+  noiseVariance = 0;
+  trained = false;
+}
+
+QVector<double> SurrogateModel::getFeatures(const QVector<unsigned> &genome) {
+  QVector<double> features(numFeatures, 0);
+
+  features[0] = 1;
+
+  unsigned offset = 1;
+  for(int i = 0; i < geneMax.size(); i++) {
+    if(genome[i] > 0) features[offset + genome[i] - 1] = 1;
+    offset += geneMax[i];
+  }
+
+  return features;
+}
+
+bool SurrogateModel::train(const QVector<QVector<unsigned>> &genomes, const QVector<double> &fitness) {
+  trained = false;
+
+  int n = genomes.size();
+  if(n < SURROGATE_MIN_RUNS) return false;
+
+  unsigned p = numFeatures;
+
+  // A = X'X + ridge*I, b = X'y
+  QVector<QVector<double>> a(p, QVector<double>(p, 0));
+  QVector<double> b(p, 0);
+
+  for(int k = 0; k < n; k++) {
+    QVector<double> x = getFeatures(genomes[k]);
+    for(unsigned i = 0; i < p; i++) {
+      if(x[i] == 0) continue;
+      b[i] += x[i] * fitness[k];
+      for(unsigned j = 0; j < p; j++) {
+        a[i][j] += x[i] * x[j];
+      }
+    }
+  }
+  for(unsigned i = 0; i < p; i++) a[i][i] += SURROGATE_RIDGE;
+
+  // invert A with Gauss-Jordan elimination
+  covariance = QVector<QVector<double>>(p, QVector<double>(p, 0));
+  for(unsigned i = 0; i < p; i++) covariance[i][i] = 1;
+
+  for(unsigned col = 0; col < p; col++) {
+    unsigned pivot = col;
+    for(unsigned row = col+1; row < p; row++) {
+      if(fabs(a[row][col]) > fabs(a[pivot][col])) pivot = row;
+    }
+    if(fabs(a[pivot][col]) < 1e-12) return false;
+
+    std::swap(a[col], a[pivot]);
+    std::swap(covariance[col], covariance[pivot]);
+
+    double scale = a[col][col];
+    for(unsigned j = 0; j < p; j++) {
+      a[col][j] /= scale;
+      covariance[col][j] /= scale;
+    }
+
+    for(unsigned row = 0; row < p; row++) {
+      if((row == col) || (a[row][col] == 0)) continue;
+      double factor = a[row][col];
+      for(unsigned j = 0; j < p; j++) {
+        a[row][j] -= factor * a[col][j];
+        covariance[row][j] -= factor * covariance[col][j];
+      }
+    }
+  }
+
+  weights = QVector<double>(p, 0);
+  for(unsigned i = 0; i < p; i++) {
+    for(unsigned j = 0; j < p; j++) {
+      weights[i] += covariance[i][j] * b[j];
+    }
+  }
+
+  trained = true;
+
+  // residual variance
+  double sse = 0;
+  for(int k = 0; k < n; k++) {
+    double e = predict(genomes[k]) - fitness[k];
+    sse += e * e;
+  }
+  noiseVariance = sse / (n > (int)p ? n - p : 1);
+
+  return true;
+}
+
+double SurrogateModel::predict(const QVector<unsigned> &genome, double *stdDev) {
+  if(!trained) {
+    if(stdDev) *stdDev = INFINITY;
+    return 0;
+  }
+
+  QVector<double> x = getFeatures(genome);
+
+  double mean = 0;
+  for(unsigned i = 0; i < numFeatures; i++) mean += weights[i] * x[i];
+
+  if(stdDev) {
+    double v = 0;
+    for(unsigned i = 0; i < numFeatures; i++) {
+      if(x[i] == 0) continue;
+      for(unsigned j = 0; j < numFeatures; j++) {
+        v += x[i] * covariance[i][j] * x[j];
+      }
+    }
+    *stdDev = sqrt(noiseVariance * (1 + v));
+  }
+
+  return mean;
+}
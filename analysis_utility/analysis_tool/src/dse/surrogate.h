@@ -19,29 +19,37 @@
  *
  *****************************************************************************/
 
-#ifndef TEXTITEM_H
-#define TEXTITEM_H
+#ifndef SURROGATE_H
+#define SURROGATE_H
 
-#include <QGraphicsTextItem>
-#include <QPainter>
+#include <QVector>
 
-class TextItem : public QGraphicsSimpleTextItem {
+// ridge regularization of the regression
+#define SURROGATE_RIDGE 0.1
+
+// number of successful runs needed before the model is used
+#define SURROGATE_MIN_RUNS 5
+
+// Bayesian linear regression on the value of each gene.
+// Predicts fitness with an uncertainty for genomes that are not yet built.
+class SurrogateModel {
+
+private:
+  QVector<unsigned> geneMax;
+  unsigned numFeatures;
+  QVector<double> weights;
+  QVector<QVector<double>> covariance;
+  double noiseVariance;
+  bool trained;
+
+  QVector<double> getFeatures(const QVector<unsigned> &genome);
 
 public:
-  TextItem(const QString &text, QGraphicsPolygonItem *parent) : QGraphicsSimpleTextItem(text, parent) {
-    if(parent->brush().color().lightness() >= 128) {
-      setBrush(QBrush(Qt::black));
-    } else {
-      setBrush(QBrush(Qt::white));
-    }
-  }
-
-  void paint(QPainter *painter, const QStyleOptionGraphicsItem *o, QWidget *w) {
-    //painter->setPen(Qt::NoPen);
-    //painter->setBrush(poly->brush());
-    //painter->drawRect(boundingRect());
-    QGraphicsSimpleTextItem::paint(painter, o, w); 
-  }   
+  SurrogateModel(QVector<unsigned> geneMax);
+
+  bool train(const QVector<QVector<unsigned>> &genomes, const QVector<double> &fitness);
+  bool isTrained() { return trained; }
+  double predict(const QVector<unsigned> &genome, double *stdDev = NULL);
 };
 
 #endif
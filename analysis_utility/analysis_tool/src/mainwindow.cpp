@@ -537,6 +537,11 @@ void MainWindow::closeEvent(QCloseEvent *event) {
   settings.setValue("asUsPath", Config::asUs);
   settings.setValue("linkerUsPath", Config::linkerUs);
   settings.setValue("linkerppUsPath", Config::linkerppUs);
+  settings.setValue("buildCacheDir", Config::buildCacheDir);
+  settings.setValue("buildCacheSize", Config::buildCacheSize);
+  settings.setValue("dseWorkers", Config::dseWorkers);
+  settings.setValue("dseWorkerSecret", Config::dseWorkerSecret);
+  settings.setValue("makeJobs", Config::makeJobs);
   settings.setValue("core", Config::core);
   settings.setValue("sensor", Config::sensor);
   settings.setValue("window", Config::window);
@@ -544,6 +549,7 @@ void MainWindow::closeEvent(QCloseEvent *event) {
   settings.setValue("regionsInTable", Config::regionsInTable);
   settings.setValue("loopsInTable", Config::loopsInTable);
   settings.setValue("basicblocksInTable", Config::basicblocksInTable);
+  settings.setValue("openGlGraph", Config::openGlGraph);
 
   QMainWindow::closeEvent(event);
 }
@@ -663,6 +669,7 @@ void MainWindow::hwEvent() {
 void MainWindow::configDialog() {
   ConfigDialog dialog;
   dialog.exec();
+  graphView->setOpenGl(Config::openGlGraph);
   if(Config::sdsocVersion) buildProjectMenu();
   if(analysis->project) loadFiles();
 }
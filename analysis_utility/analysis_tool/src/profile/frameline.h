@@ -27,33 +27,43 @@
 
 #include "profile.h"
 
-class FrameLine : public QGraphicsItem {
+// all frame lines of the profile graph, drawn as one batch of rectangles
+class FrameLines : public QGraphicsItem {
 
-  int64_t timeStart;
-  int64_t timeEnd;
+  QVector<QRect> frames;
+  QRect bounds;
   unsigned lineHeight;
   unsigned lineDepth;
   QColor color;
 
 public:
-  FrameLine(int64_t timeStart, int64_t timeEnd, unsigned lineHeight, unsigned lineDepth, QColor color, QGraphicsItem *parent = NULL) : QGraphicsItem(parent) {
-    this->timeStart = timeStart;
-    this->timeEnd = timeEnd;
+  FrameLines(unsigned lineHeight, unsigned lineDepth, QColor color, QGraphicsItem *parent = NULL) : QGraphicsItem(parent) {
     this->lineHeight = lineHeight;
     this->lineDepth = lineDepth;
     this->color = color;
   }
 
-  ~FrameLine() {}
+  ~FrameLines() {}
+
+  // frames should be added before the item is added to the scene
+  void addFrameLine(int64_t timeStart, int64_t timeEnd) {
+    QRect frame(timeStart, -(int)lineHeight, timeEnd - timeStart, lineHeight + lineDepth);
+    frames.push_back(frame);
+
+    if(!bounds.contains(frame)) {
+      prepareGeometryChange();
+      bounds = bounds.united(frame);
+    }
+  }
 
   QRectF boundingRect() const {
-    return QRectF(timeStart, -(int)lineHeight, timeEnd - timeStart, lineHeight + lineDepth);
+    return bounds;
   }
 
   void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) {
     painter->setPen(QPen(color));
     painter->setBrush(QBrush(color, Qt::SolidPattern));
-    painter->drawRect(timeStart, -(int)lineHeight, timeEnd - timeStart, lineHeight + lineDepth);
+    painter->drawRects(frames);
   }
 
 };
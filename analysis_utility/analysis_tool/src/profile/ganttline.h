@@ -24,18 +24,24 @@
 
 #include <QGraphicsScene>
 #include <QtWidgets>
+#include <algorithm>
 
 #include "profile.h"
 
 #define GANT_TEXT_SPACING 10
 
+// number of level-of-detail lists kept per gantt line
+#define GANTT_LEVELS 16
+
 class GanttLine : public QGraphicsItem {
 
   QString id;
   unsigned textWidth;
   unsigned textHeight;
   unsigned maxTime;
-  QVector<QPoint> lines;
+  // level 0 holds the segments with touching segments joined,
+  // level n has segments closer than 2^n joined
+  QVector<QVector<QPoint>> levels;
   QFont font;
   QColor color;
 
@@ -47,6 +53,10 @@ public:
 
     maxTime = 0;
 
+    levels.resize(1);
+
+    setFlag(QGraphicsItem::ItemUsesExtendedStyleOption);
+
     QFontMetrics fm(font);
     textWidth = fm.width(id);
     textHeight = fm.height();
@@ -54,8 +64,16 @@ public:
 
   ~GanttLine() {}
 
+  // segments must be added in time order
   void addLine(unsigned start, unsigned stop) {
-    lines.push_back(QPoint(start, stop));
+    QVector<QPoint> &lines = levels[0];
+    if(lines.size() && ((int)start <= lines.back().y())) {
+      if((int)stop > lines.back().y()) lines.back().setY(stop);
+    } else {
+      lines.push_back(QPoint(start, stop));
+    }
+    levels.resize(1);
+
     if(stop > maxTime) {
       maxTime = stop;
       prepareGeometryChange();
@@ -73,9 +91,56 @@ public:
 
     painter->drawText((int)(-textWidth-GANT_TEXT_SPACING), 0, id);
 
-    for(auto line : lines) {
-      painter->drawRect((int)line.x(), 0, (int)(line.y() - line.x()), (int)-(textHeight)/2);
+    // pick the coarsest level where all joined gaps are below one pixel
+    qreal lod = option->levelOfDetailFromTransform(painter->worldTransform());
+    qreal pixel = lod > 0 ? 1 / lod : 1;
+    unsigned level = 0;
+    while(((level+1) < GANTT_LEVELS) && ((qreal)(1 << (level+1)) <= pixel)) level++;
+
+    const QVector<QPoint> &lines = getLevel(level);
+
+    // only paint segments inside the exposed area, and join what is still closer than a pixel
+    qreal left = option->exposedRect.left();
+    qreal right = option->exposedRect.right();
+
+    auto it = std::lower_bound(lines.begin(), lines.end(), left,
+                               [](const QPoint &line, qreal x) { return line.y() < x; });
+
+    bool inSegment = false;
+    QPoint segment;
+    for(; (it != lines.end()) && (it->x() <= right); ++it) {
+      if(inSegment && ((it->x() - segment.y()) < pixel)) {
+        segment.setY(it->y());
+      } else {
+        if(inSegment) drawSegment(painter, segment);
+        segment = *it;
+        inSegment = true;
+      }
+    }
+    if(inSegment) drawSegment(painter, segment);
+  }
+
+private:
+  void drawSegment(QPainter *painter, QPoint line) {
+    painter->drawRect((int)line.x(), 0, (int)(line.y() - line.x()), (int)-(textHeight)/2);
+  }
+
+  const QVector<QPoint> &getLevel(unsigned level) {
+    while((unsigned)levels.size() <= level) {
+      const QVector<QPoint> &finer = levels.back();
+      int gap = 1 << levels.size();
+
+      QVector<QPoint> coarser;
+      for(auto line : finer) {
+        if(coarser.size() && ((line.x() - coarser.back().y()) < gap)) {
+          coarser.back().setY(line.y());
+        } else {
+          coarser.push_back(line);
+        }
+      }
+      levels.push_back(coarser);
     }
+    return levels[level];
   }
 
 };
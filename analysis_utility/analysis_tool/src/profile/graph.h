@@ -24,6 +24,7 @@
 
 #include <QGraphicsScene>
 #include <QtWidgets>
+#include <algorithm>
 
 #include "profile.h"
 
@@ -33,6 +34,8 @@
 
 class Graph : public QGraphicsItem {
   QVector<QPoint> points;
+  // decimated polyline, at most four points per time unit (first, min, max, last)
+  QPolygon polyline;
   unsigned textWidth;
   unsigned textHeight;
   QFont font;
@@ -71,11 +74,15 @@ public:
     if(w1 > w2) textWidth = w1;
     else textWidth = w2;
     textHeight = fm.height();
+
+    setFlag(QGraphicsItem::ItemUsesExtendedStyleOption);
   }
   ~Graph() {}
 
+  // points must be added in time order
   void addPoint(int64_t time, unsigned value) {
     points.push_back(QPoint(time, value));
+    polyline.clear();
   }
 
   QRectF boundingRect() const {
@@ -91,7 +98,10 @@ public:
 
     QFontMetrics fm(font);
 
+    // the view does not save the painter state between items
+    painter->setFont(font);
     painter->setPen(QPen(NTNU_BLUE));
+    painter->setBrush(Qt::NoBrush);
 
     painter->drawLine(0, 0, 0, -highPower);
     painter->drawLine(0, 0, highTime, 0);
@@ -103,10 +113,47 @@ public:
     painter->drawText((int)highTime - fm.width(highTimeText), textHeight, highTimeText);
 
     painter->setPen(QPen(FOREGROUND_COLOR));
-    QPoint prevPoint = QPoint(0,0);
-    for(auto point : points) {
-      painter->drawLine(QPoint(prevPoint.x(), -prevPoint.y()), QPoint(point.x(), -point.y()));
-      prevPoint = point;
+
+    if(polyline.isEmpty() && !points.isEmpty()) decimate();
+
+    // only draw the part of the polyline inside the exposed area
+    qreal left = option->exposedRect.left();
+    qreal right = option->exposedRect.right();
+
+    auto first = std::lower_bound(polyline.begin(), polyline.end(), left,
+                                  [](const QPoint &point, qreal x) { return point.x() < x; });
+    auto last = std::upper_bound(first, polyline.end(), right,
+                                 [](qreal x, const QPoint &point) { return x < point.x(); });
+    if(first != polyline.begin()) --first;
+    if(last != polyline.end()) ++last;
+
+    if((last - first) > 1) painter->drawPolyline(&*first, last - first);
+  }
+
+private:
+  void decimate() {
+    polyline.push_back(QPoint(0, 0));
+
+    auto it = points.begin();
+    while(it != points.end()) {
+      int x = it->x();
+      QPoint firstPoint = *it;
+      QPoint minPoint = *it;
+      QPoint maxPoint = *it;
+      QPoint lastPoint = *it;
+
+      for(++it; (it != points.end()) && (it->x() == x); ++it) {
+        if(it->y() < minPoint.y()) minPoint = *it;
+        if(it->y() > maxPoint.y()) maxPoint = *it;
+        lastPoint = *it;
+      }
+
+      polyline.push_back(QPoint(x, -firstPoint.y()));
+      if(minPoint.y() != maxPoint.y()) {
+        polyline.push_back(QPoint(x, -minPoint.y()));
+        polyline.push_back(QPoint(x, -maxPoint.y()));
+      }
+      if(-lastPoint.y() != polyline.back().y()) polyline.push_back(QPoint(x, -lastPoint.y()));
     }
   }
 
@@ -30,28 +30,43 @@ GraphScene::GraphScene(QObject *parent) : QGraphicsScene(parent) {
   scaleFactorPower = 200;
   profile = NULL;
   graph = NULL;
+  frameLines = NULL;
   minPowerIncrement = 0;
   maxPowerIncrement = 0;
 }
 
-void GraphScene::addGanttLineSegments(int line, QVector<Measurement> *measurements) {
-  int64_t startTime = -1;
-  int64_t lastTime = -1;
-  uint64_t lastSeq = -2;
-  for(auto measurement : *measurements) {
-    int64_t time = measurement.time;
-    uint64_t seq = measurement.sequence;
-    if(seq != lastSeq+1) {
-      if(startTime != (int64_t)~0) {
-        addGanttLineSegment(line, startTime, lastTime);
+void GraphScene::addGanttLineSegments(int line, const QVector<MeasurementSpan> &measurements) {
+  // find runs of consecutive measurement indices within each span
+  std::vector<std::pair<unsigned,unsigned>> runs;
+  for(auto span : measurements) {
+    unsigned firstRun = runs.size();
+    for(auto index : span) {
+      if((runs.size() > firstRun) && (runs.back().second+1 == index)) {
+        runs.back().second = index;
+      } else {
+        runs.push_back(std::make_pair(index, index));
       }
-      startTime = time;
     }
-    lastTime = time;
-    lastSeq = seq;
   }
-  if(measurements->size()) {
-    addGanttLineSegment(line, startTime, lastTime);
+
+  // join runs from different spans that follow each other
+  std::sort(runs.begin(), runs.end());
+
+  bool inRun = false;
+  std::pair<unsigned,unsigned> current;
+  for(auto run : runs) {
+    if(inRun && (run.first == current.second+1)) {
+      current.second = run.second;
+    } else {
+      if(inRun) {
+        addGanttLineSegment(line, profile->measurements.getTime(current.first), profile->measurements.getTime(current.second));
+      }
+      current = run;
+      inRun = true;
+    }
+  }
+  if(inRun) {
+    addGanttLineSegment(line, profile->measurements.getTime(current.first), profile->measurements.getTime(current.second));
   }
 }
 
@@ -64,8 +79,6 @@ void GraphScene::drawProfile(unsigned core, unsigned sensor, Cfg *cfg, Profile *
   this->cfg = cfg;
   this->profile = profile;
 
-  QVector<Measurement> *measurements = new QVector<Measurement>;
-
   if(profile) {
     QSqlDatabase db = QSqlDatabase::database(profile->dbConnection);
     QSqlQuery query(db);
@@ -116,6 +129,8 @@ void GraphScene::drawProfile(unsigned core, unsigned sensor, Cfg *cfg, Profile *
 
         MovingAverage ma(Config::window);
 
+        profile->measurements.clear();
+
         if(query.next()) {
           ma.initialize(query.value("power" + QString::number(sensor+1)).toDouble());
         
@@ -134,12 +149,12 @@ void GraphScene::drawProfile(unsigned core, unsigned sensor, Cfg *cfg, Profile *
 
             addPoint(time, avg);
 
-            measurements->push_back(Measurement(time, core, bb));
+            profile->measurements.add(time, core, bb);
           
           } while(query.next());
         }
 
-        profile->setMeasurements(measurements);
+        profile->measurements.finalize();
 
         unsigned ganttSize = 0;
 
@@ -151,14 +166,14 @@ void GraphScene::drawProfile(unsigned core, unsigned sensor, Cfg *cfg, Profile *
         for(auto profLine : table) {
           if(!profLine->vertex) {
             int l = addGanttLine("Unknown", FOREGROUND_COLOR);
-            addGanttLineSegments(l, profLine->getMeasurements());
+            addGanttLineSegments(l, profLine->measurements);
       
           } else {
             Vertex *vertex = profLine->vertex;
 
-            if(vertex->isVisibleInGantt() && (profLine->measurements.size() > 0)) {
+            if(vertex->isVisibleInGantt() && profLine->numMeasurements()) {
               int l = addGanttLine(vertex->getGanttName(), vertex->getColor());
-              addGanttLineSegments(l, profLine->getMeasurements());
+              addGanttLineSegments(l, profLine->measurements);
               ganttSize = GANTT_SPACING + (l+1) * LINE_SPACING;
             }
           }
@@ -170,11 +185,18 @@ void GraphScene::drawProfile(unsigned core, unsigned sensor, Cfg *cfg, Profile *
 
         query.exec(queryString);
 
+        // the frames are added before the item is in the scene, so that the scene is not told about
+        // every geometry change
+        frameLines = new FrameLines(scaleFactorPower, ganttSize, NTNU_YELLOW);
+        frameLines->setPos(0, GRAPH_SIZE-GANTT_SPACING);
+
         while(query.next()) {
           int64_t time = query.value("time").toLongLong();
           int64_t delay = query.value("delay").toLongLong();
-          addFrameLine(time, time + delay, ganttSize, NTNU_YELLOW);
+          addFrameLine(time, time + delay);
         }
+
+        addItem(frameLines);
       }
     }
   }
@@ -209,10 +231,8 @@ void GraphScene::addPoint(int64_t time, double value) {
   graph->addPoint(scaleTime(time), scalePower(value));
 }
 
-void GraphScene::addFrameLine(int64_t timeStart, int64_t timeEnd, unsigned depth, QColor color) {
-  FrameLine *line = new FrameLine(scaleTime(timeStart), scaleTime(timeEnd), scaleFactorPower, depth, color);
-  line->setPos(0, GRAPH_SIZE-GANTT_SPACING);
-  addItem(line);
+void GraphScene::addFrameLine(int64_t timeStart, int64_t timeEnd) {
+  frameLines->addFrameLine(scaleTime(timeStart), scaleTime(timeEnd));
 }
 
 int64_t GraphScene::scaleTime(int64_t time) {
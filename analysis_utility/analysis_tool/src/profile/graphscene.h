@@ -88,18 +88,19 @@ class GraphScene : public QGraphicsScene {
 
 private:
   Graph *graph;
+  FrameLines *frameLines;
   QVector<GanttLine*> ganttLines;
   unsigned currentCore;
   unsigned currentSensor;
   Cfg *cfg;
 
-  void addGanttLineSegments(int line, QVector<Measurement> *measurements);
+  void addGanttLineSegments(int line, const QVector<MeasurementSpan> &measurements);
   int64_t scaleTime(int64_t time);
   double scalePower(double power);
   int addGanttLine(QString id, QColor color);
   void addGanttLineSegment(unsigned lineNum, int64_t start, int64_t stop);
   void addPoint(int64_t time, double value);
-  void addFrameLine(int64_t timeStart, int64_t timeEnd, unsigned depth, QColor color);
+  void addFrameLine(int64_t timeStart, int64_t timeEnd);
 
 public:
   int64_t minTime;
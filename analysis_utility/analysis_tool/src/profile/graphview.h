@@ -28,6 +28,8 @@
 #include <QMouseEvent>
 #include <QScrollBar>
 #include <QApplication>
+#include <QOpenGLWidget>
+#include <QOpenGLContext>
 
 #include "graphscene.h"
 
@@ -100,6 +102,29 @@ public:
   GraphView(GraphScene *scene) : QGraphicsView(scene) {
     this->scene = scene;
     setBackgroundBrush(QBrush(BACKGROUND_COLOR, Qt::SolidPattern));
+    setOptimizationFlags(QGraphicsView::DontSavePainterState | QGraphicsView::DontAdjustForAntialiasing);
+    setOpenGl(Config::openGlGraph);
+  }
+
+  // render through an OpenGL viewport, or the default software rasterizer if
+  // OpenGL is disabled or no context can be created on this machine
+  void setOpenGl(bool enable) {
+    bool useOpenGl = false;
+
+    if(enable) {
+      QOpenGLContext context;
+      useOpenGl = context.create();
+    }
+
+    if(useOpenGl == (qobject_cast<QOpenGLWidget*>(viewport()) != NULL)) return;
+
+    if(useOpenGl) {
+      setViewport(new QOpenGLWidget);
+      setViewportUpdateMode(QGraphicsView::FullViewportUpdate);
+    } else {
+      setViewport(new QWidget);
+      setViewportUpdateMode(QGraphicsView::MinimalViewportUpdate);
+    }
   }
 
 public slots:
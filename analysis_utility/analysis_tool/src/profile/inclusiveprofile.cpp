@@ -0,0 +1,343 @@
+/******************************************************************************
+ *
+ *  This file is part of the TULIPP Analysis Utility
+ *
+ *  Copyright 2018 Asbjørn Djupdal, NTNU, TULIPP EU Project
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *****************************************************************************/
+
+#include <algorithm>
+#include <QHash>
+#include <QtSql>
+
+#include "inclusiveprofile.h"
+#include "profile.h"
+#include "cfg/cfg.h"
+#include "cfg/module.h"
+#include "cfg/function.h"
+#include "cfg/basicblock.h"
+#include "cfg/instruction.h"
+#include "cfg/loop.h"
+
+InclusiveProfile::InclusiveProfile(Profile *profile, Cfg *cfg, unsigned core) {
+  this->cfg = cfg;
+
+  for(auto child : cfg->children) {
+    Module *module = static_cast<Module*>(child);
+    for(auto modChild : module->children) {
+      Function *func = static_cast<Function*>(modChild);
+      collectBasicBlocks(func, funcBbs[func]);
+    }
+  }
+
+  loadExclusive(profile, core);
+  buildCallGraph();
+  findSccs();
+  evaluate();
+}
+
+void InclusiveProfile::collectBasicBlocks(Container *container, std::vector<BasicBlock*> &bbs) {
+  for(auto child : container->children) {
+    BasicBlock *bb = dynamic_cast<BasicBlock*>(child);
+    if(bb) {
+      bbs.push_back(bb);
+    } else {
+      Container *cont = dynamic_cast<Container*>(child);
+      if(cont) collectBasicBlocks(cont, bbs);
+    }
+  }
+}
+
+void InclusiveProfile::loadExclusive(Profile *profile, unsigned core) {
+  QSqlDatabase db = QSqlDatabase::database(profile->dbConnection);
+  QSqlQuery query(db);
+
+  query.exec("SELECT fromid,selfid,num FROM arc");
+
+  while(query.next()) {
+    int fromid = query.value("fromid").toInt();
+    int selfid = query.value("selfid").toInt();
+    uint64_t num = query.value("num").toULongLong();
+
+    callsTo[selfid] += num;
+    arcCalls[std::make_pair(fromid, selfid)] += num;
+  }
+
+  QString queryString =
+    QString() +
+    "SELECT id,module,function,basicblock,runtime,energy1,energy2,energy3,energy4,energy5,energy6,energy7,runtimeFrame,energyFrame1,energyFrame2,energyFrame3,energyFrame4,energyFrame5,energyFrame6,energyFrame7,loopcount" +
+    " FROM location" +
+    " WHERE core = " + QString::number(core);
+
+  query.exec(queryString);
+
+  while(query.next()) {
+    QString moduleId = query.value("module").toString();
+    BasicBlock *bb = NULL;
+
+    if(moduleId == cfg->externalMod->id) {
+      Function *func = cfg->externalMod->getFunctionById(query.value("function").toString());
+      if(func && funcBbs[func].size()) bb = funcBbs[func][0];
+
+    } else {
+      Module *mod = cfg->getModuleById(moduleId);
+      if(mod) bb = mod->getBasicBlockById(query.value("basicblock").toString());
+    }
+
+    if(!bb || (exclusiveBb.find(bb) != exclusiveBb.end())) continue;
+
+    ProfData data;
+
+    data.runtime = query.value("runtime").toDouble();
+    data.runtimeFrame = query.value("runtimeFrame").toDouble();
+    for(unsigned i = 0; i < Pmu::MAX_SENSORS; i++) {
+      data.energy[i] = query.value("energy" + QString::number(i+1)).toDouble();
+      data.energyFrame[i] = query.value("energyFrame" + QString::number(i+1)).toDouble();
+    }
+
+    int id = query.value("id").toInt();
+    bbToId[bb] = id;
+
+    auto it = callsTo.find(id);
+    if(it != callsTo.end()) data.count = it->second;
+
+    exclusiveBb[bb] = data;
+
+    uint64_t loopCount = query.value("loopcount").toULongLong();
+    if(loopCount) {
+      Vertex *loop = bb->parent;
+      while(!loop->isLoop()) {
+        loop = loop->parent;
+        if(!loop) break;
+      }
+
+      if(loop) (static_cast<Loop*>(loop))->count = loopCount;
+      else {
+        printf("Cant find loop:\n");
+        printf("  Mod %s\n", bb->getModule()->id.toUtf8().constData());
+        printf("  Func %s\n", bb->getFunction()->id.toUtf8().constData());
+        printf("  Bb: %s\n", bb->id.toUtf8().constData());
+      }
+    }
+  }
+}
+
+void InclusiveProfile::buildCallGraph() {
+  // function lookup tables, same search order as Module::getFunctionById() followed by Cfg::getFunctionById()
+  QHash<Module*,QHash<QString,Function*>> moduleFunctions;
+  QHash<QString,Function*> globalFunctions;
+
+  for(auto child : cfg->children) {
+    Module *module = static_cast<Module*>(child);
+    for(auto modChild : module->children) {
+      Function *func = static_cast<Function*>(modChild);
+      if(!moduleFunctions[module].contains(func->id)) moduleFunctions[module][func->id] = func;
+      if((module != cfg->externalMod) && !globalFunctions.contains(func->id)) globalFunctions[func->id] = func;
+    }
+  }
+
+  for(auto &it : funcBbs) {
+    for(auto bb : it.second) {
+      for(auto child : bb->children) {
+        Instruction *instr = dynamic_cast<Instruction*>(child);
+        if(instr && (instr->name == INSTR_ID_CALL)) {
+          Function *func = moduleFunctions[bb->getModule()].value(instr->target, NULL);
+          if(!func) {
+            func = globalFunctions.value(instr->target, NULL);
+          }
+          if(func) {
+            double ratio;
+            if((func->callers == 1) && (func->caller.contains(bb))) {
+              ratio = 1;
+            } else {
+              ratio = getArcRatio(bb, func);
+            }
+            callSites[bb].push_back(CallSite(func, ratio));
+          }
+        }
+      }
+    }
+  }
+}
+
+void InclusiveProfile::findSccs() {
+  std::unordered_map<Function*,int> index;
+  std::unordered_map<Function*,int> lowLink;
+  std::unordered_map<Function*,bool> onStack;
+  std::vector<Function*> stack;
+  int nextIndex = 0;
+
+  for(auto child : cfg->children) {
+    Module *module = static_cast<Module*>(child);
+    for(auto modChild : module->children) {
+      Function *func = static_cast<Function*>(modChild);
+      if(index.find(func) == index.end()) {
+        strongConnect(func, index, lowLink, stack, onStack, nextIndex);
+      }
+    }
+  }
+}
+
+/* Tarjan's algorithm, SCCs are found in reverse topological order */
+void InclusiveProfile::strongConnect(Function *func, std::unordered_map<Function*,int> &index, std::unordered_map<Function*,int> &lowLink,
+                                     std::vector<Function*> &stack, std::unordered_map<Function*,bool> &onStack, int &nextIndex) {
+  index[func] = nextIndex;
+  lowLink[func] = nextIndex;
+  nextIndex++;
+  stack.push_back(func);
+  onStack[func] = true;
+
+  for(auto bb : funcBbs[func]) {
+    auto sites = callSites.find(bb);
+    if(sites == callSites.end()) continue;
+
+    for(auto &site : sites->second) {
+      Function *callee = site.func;
+      if(index.find(callee) == index.end()) {
+        strongConnect(callee, index, lowLink, stack, onStack, nextIndex);
+        lowLink[func] = std::min(lowLink[func], lowLink[callee]);
+      } else if(onStack[callee]) {
+        lowLink[func] = std::min(lowLink[func], index[callee]);
+      }
+    }
+  }
+
+  if(lowLink[func] == index[func]) {
+    std::vector<Function*> scc;
+    Function *member;
+    do {
+      member = stack.back();
+      stack.pop_back();
+      onStack[member] = false;
+      funcToScc[member] = sccs.size();
+      scc.push_back(member);
+    } while(member != func);
+    sccs.push_back(scc);
+  }
+}
+
+/* callees outside the SCC are already evaluated, so the base data of all members only depends on earlier SCCs */
+void InclusiveProfile::evaluateScc(unsigned scc) {
+  std::unordered_map<BasicBlock*,ProfData> baseBb;
+  std::unordered_map<Function*,ProfData> baseFunc;
+
+  for(auto func : sccs[scc]) {
+    ProfData funcData;
+
+    for(auto bb : funcBbs[func]) {
+      ProfData bbData;
+
+      auto excl = exclusiveBb.find(bb);
+      if(excl != exclusiveBb.end()) bbData = excl->second;
+
+      auto sites = callSites.find(bb);
+      if(sites != callSites.end()) {
+        for(auto &site : sites->second) {
+          if(funcToScc[site.func] != scc) bbData.add(inclusiveFunc[site.func], site.ratio);
+        }
+      }
+
+      baseBb[bb] = bbData;
+
+      funcData.add(bbData);
+      funcData.count += bbData.count;
+    }
+
+    baseFunc[func] = funcData;
+  }
+
+  /* calls inside the SCC add the base data of the callee, so every call is visited once */
+  for(auto func : sccs[scc]) {
+    ProfData funcData;
+
+    for(auto bb : funcBbs[func]) {
+      ProfData bbData = baseBb[bb];
+
+      auto sites = callSites.find(bb);
+      if(sites != callSites.end()) {
+        for(auto &site : sites->second) {
+          if(funcToScc[site.func] == scc) bbData.add(baseFunc[site.func], site.ratio);
+        }
+      }
+
+      inclusiveBb[bb] = bbData;
+
+      funcData.add(bbData);
+      funcData.count += bbData.count;
+    }
+
+    inclusiveFunc[func] = funcData;
+  }
+}
+
+void InclusiveProfile::evaluate() {
+  for(unsigned scc = 0; scc < sccs.size(); scc++) {
+    evaluateScc(scc);
+  }
+}
+
+void InclusiveProfile::getProfData(BasicBlock *bb, double *runtime, double *energy, double *runtimeFrame, double *energyFrame, uint64_t *count) {
+  ProfData data;
+
+  auto it = inclusiveBb.find(bb);
+  if(it != inclusiveBb.end()) data = it->second;
+
+  *runtime = data.runtime;
+  *runtimeFrame = data.runtimeFrame;
+  for(unsigned i = 0; i < Pmu::MAX_SENSORS; i++) {
+    energy[i] = data.energy[i];
+    energyFrame[i] = data.energyFrame[i];
+  }
+  *count = data.count;
+}
+
+void InclusiveProfile::getProfData(Function *func, double *runtime, double *energy, double *runtimeFrame, double *energyFrame, uint64_t *count) {
+  ProfData data;
+
+  auto it = inclusiveFunc.find(func);
+  if(it != inclusiveFunc.end()) data = it->second;
+
+  *runtime = data.runtime;
+  *runtimeFrame = data.runtimeFrame;
+  for(unsigned i = 0; i < Pmu::MAX_SENSORS; i++) {
+    energy[i] = data.energy[i];
+    energyFrame[i] = data.energyFrame[i];
+  }
+  *count = data.count;
+}
+
+double InclusiveProfile::getArcRatio(BasicBlock *bb, Function *func) {
+  int fromid = 0;
+  int selfid = 0;
+
+  auto fromIt = bbToId.find(bb);
+  if(fromIt != bbToId.end()) fromid = fromIt->second;
+
+  auto selfIt = bbToId.find(func->getFirstBb());
+  if(selfIt != bbToId.end()) selfid = selfIt->second;
+
+  uint64_t totalCalls = 0;
+  auto totalIt = callsTo.find(selfid);
+  if(totalIt != callsTo.end()) totalCalls = totalIt->second;
+
+  if(!totalCalls) return 0;
+
+  uint64_t calls = 0;
+  auto callsIt = arcCalls.find(std::make_pair(fromid, selfid));
+  if(callsIt != arcCalls.end()) calls = callsIt->second;
+
+  return (double)calls / (double)totalCalls;
+}
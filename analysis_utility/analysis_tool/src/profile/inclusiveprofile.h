@@ -0,0 +1,133 @@
+/******************************************************************************
+ *
+ *  This file is part of the TULIPP Analysis Utility
+ *
+ *  Copyright 2018 Asbjørn Djupdal, NTNU, TULIPP EU Project
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *****************************************************************************/
+
+#ifndef INCLUSIVEPROFILE_H
+#define INCLUSIVEPROFILE_H
+
+#include <map>
+#include <vector>
+#include <unordered_map>
+
+#include <QString>
+
+#include "project/pmu.h"
+
+class Vertex;
+class Container;
+class BasicBlock;
+class Function;
+class Cfg;
+class Profile;
+
+///////////////////////////////////////////////////////////////////////////////
+
+class ProfData {
+public:
+  double runtime;
+  double energy[Pmu::MAX_SENSORS];
+  double runtimeFrame;
+  double energyFrame[Pmu::MAX_SENSORS];
+  uint64_t count;
+
+  ProfData() {
+    runtime = 0;
+    runtimeFrame = 0;
+    for(unsigned i = 0; i < Pmu::MAX_SENSORS; i++) {
+      energy[i] = 0;
+      energyFrame[i] = 0;
+    }
+    count = 0;
+  }
+
+  // adds scaled runtime and energy of other, count is exclusive and not added
+  void add(const ProfData &other, double ratio = 1) {
+    runtime += other.runtime * ratio;
+    runtimeFrame += other.runtimeFrame * ratio;
+    for(unsigned i = 0; i < Pmu::MAX_SENSORS; i++) {
+      energy[i] += other.energy[i] * ratio;
+      energyFrame[i] += other.energyFrame[i] * ratio;
+    }
+  }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// Inclusive (callees included) profile data for all basic blocks and functions
+// of one core.
+//
+// Exclusive data and call arcs are read from the profile DB in one pass.  The
+// call graph is condensed into strongly connected components which are
+// evaluated bottom-up, so every function is evaluated once.  Calls are weighted
+// with the fraction of the callee's calls that come from the calling basic
+// block.  A component is evaluated as a unit: recursive calls inside it add the
+// callee's own data and its calls out of the component, but are not followed
+// further, so the cost is linear in the number of call sites.
+
+class InclusiveProfile {
+
+  class CallSite {
+  public:
+    Function *func;
+    double ratio;
+
+    CallSite(Function *func, double ratio) {
+      this->func = func;
+      this->ratio = ratio;
+    }
+  };
+
+  Cfg *cfg;
+
+  std::unordered_map<BasicBlock*,ProfData> exclusiveBb;
+  std::unordered_map<BasicBlock*,ProfData> inclusiveBb;
+  std::unordered_map<Function*,ProfData> inclusiveFunc;
+
+  std::unordered_map<BasicBlock*,int> bbToId;
+  std::map<int,uint64_t> callsTo;
+  std::map<std::pair<int,int>,uint64_t> arcCalls;
+
+  std::unordered_map<Function*,std::vector<BasicBlock*>> funcBbs;
+  std::unordered_map<BasicBlock*,std::vector<CallSite>> callSites;
+
+  // strongly connected components, callees before callers
+  std::unordered_map<Function*,unsigned> funcToScc;
+  std::vector<std::vector<Function*>> sccs;
+
+  void loadExclusive(Profile *profile, unsigned core);
+  void buildCallGraph();
+  void findSccs();
+  void strongConnect(Function *func, std::unordered_map<Function*,int> &index, std::unordered_map<Function*,int> &lowLink,
+                     std::vector<Function*> &stack, std::unordered_map<Function*,bool> &onStack, int &nextIndex);
+  void evaluateScc(unsigned scc);
+  void evaluate();
+
+  void collectBasicBlocks(Container *container, std::vector<BasicBlock*> &bbs);
+
+public:
+  InclusiveProfile(Profile *profile, Cfg *cfg, unsigned core);
+
+  void getProfData(BasicBlock *bb, double *runtime, double *energy, double *runtimeFrame, double *energyFrame, uint64_t *count);
+  void getProfData(Function *func, double *runtime, double *energy, double *runtimeFrame, double *energyFrame, uint64_t *count);
+
+  // fraction of the calls to func that come from bb
+  double getArcRatio(BasicBlock *bb, Function *func);
+};
+
+#endif
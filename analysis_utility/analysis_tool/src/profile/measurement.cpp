@@ -19,12 +19,75 @@
  *
  *****************************************************************************/
 
+#include <algorithm>
+
 #include "measurement.h"
-#include "cfg/basicblock.h"
-#include "cfg/function.h"
-#include "cfg/cfg.h"
 
-#include <QDataStream>
+void MeasurementStore::clear() {
+  times.clear();
+  cores.clear();
+  bbIndices.clear();
+  bbs.clear();
+  bbToIndex.clear();
+  for(unsigned core = 0; core < Pmu::MAX_CORES; core++) {
+    indicesPerBb[core].clear();
+  }
+}
+
+void MeasurementStore::add(quint64 time, unsigned core, BasicBlock *bb) {
+  unsigned bbIndex;
+
+  auto it = bbToIndex.find(bb);
+  if(it == bbToIndex.end()) {
+    bbIndex = bbs.size();
+    bbs.push_back(bb);
+    bbToIndex[bb] = bbIndex;
+  } else {
+    bbIndex = it->second;
+  }
+
+  times.push_back(time);
+  cores.push_back(core);
+  bbIndices.push_back(bbIndex);
+}
+
+void MeasurementStore::finalize() {
+  if(!std::is_sorted(times.begin(), times.end())) {
+    std::vector<unsigned> order(times.size());
+    for(unsigned i = 0; i < order.size(); i++) order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [this](unsigned a, unsigned b) { return times[a] < times[b]; });
+
+    std::vector<quint64> sortedTimes(times.size());
+    std::vector<unsigned char> sortedCores(cores.size());
+    std::vector<unsigned> sortedBbIndices(bbIndices.size());
+
+    for(unsigned i = 0; i < order.size(); i++) {
+      sortedTimes[i] = times[order[i]];
+      sortedCores[i] = cores[order[i]];
+      sortedBbIndices[i] = bbIndices[order[i]];
+    }
+
+    times.swap(sortedTimes);
+    cores.swap(sortedCores);
+    bbIndices.swap(sortedBbIndices);
+  }
+
+  for(unsigned core = 0; core < Pmu::MAX_CORES; core++) {
+    indicesPerBb[core].clear();
+    indicesPerBb[core].resize(bbs.size());
+  }
+
+  for(unsigned i = 0; i < times.size(); i++) {
+    indicesPerBb[cores[i]][bbIndices[i]].push_back(i);
+  }
+}
 
-unsigned Measurement::counter[Pmu::MAX_CORES] = {0};
+MeasurementSpan MeasurementStore::getMeasurements(unsigned core, BasicBlock *bb) const {
+  auto it = bbToIndex.find(bb);
+  if((it == bbToIndex.end()) || (it->second >= indicesPerBb[core].size())) {
+    return MeasurementSpan();
+  }
 
+  const std::vector<unsigned> &indices = indicesPerBb[core][it->second];
+  return MeasurementSpan(indices.data(), indices.data() + indices.size());
+}
@@ -22,6 +22,9 @@
 #ifndef MEASUREMENT_H
 #define MEASUREMENT_H
 
+#include <vector>
+#include <unordered_map>
+
 #include <QVector>
 #include <QFile>
 
@@ -29,28 +32,71 @@
 #include "project/pmu.h"
 
 class BasicBlock;
-class Cfg;
-class Function;
 
-class Measurement {
+// A list of measurement indices owned by a MeasurementStore
+class MeasurementSpan {
+  const unsigned *first;
+  const unsigned *last;
+
+public:
+  MeasurementSpan() {
+    first = NULL;
+    last = NULL;
+  }
+
+  MeasurementSpan(const unsigned *first, const unsigned *last) {
+    this->first = first;
+    this->last = last;
+  }
+
+  const unsigned *begin() const {
+    return first;
+  }
+  const unsigned *end() const {
+    return last;
+  }
+  unsigned size() const {
+    return last - first;
+  }
+};
+
+// All measurements of a profile, as a struct of arrays sorted on time.
+// Measurements are referenced by index, and the indices of each basic block
+// are available as spans that stay valid until the store is cleared.
+class MeasurementStore {
+  std::vector<quint64> times;
+  std::vector<unsigned char> cores;
+  std::vector<unsigned> bbIndices;
+
+  std::vector<BasicBlock*> bbs;
+  std::unordered_map<BasicBlock*,unsigned> bbToIndex;
+
+  std::vector<std::vector<unsigned>> indicesPerBb[Pmu::MAX_CORES];
+
 public:
-  quint32 sequence;
-  quint64 time;
+  void clear();
 
-  unsigned core;
-  BasicBlock *bb;
+  // add a measurement, finalize() must be called after the last one
+  void add(quint64 time, unsigned core, BasicBlock *bb);
 
-  static unsigned counter[Pmu::MAX_CORES];
+  // sort on time and build the per basic block index lists
+  void finalize();
 
-  Measurement() {}
+  unsigned size() const {
+    return times.size();
+  }
 
-  Measurement(uint64_t time, unsigned core, BasicBlock *bb) {
-    this->time = time;
-    this->core = core;
-    this->bb = bb;
-    sequence = Measurement::counter[core]++;
+  quint64 getTime(unsigned index) const {
+    return times[index];
+  }
+  unsigned getCore(unsigned index) const {
+    return cores[index];
+  }
+  BasicBlock *getBb(unsigned index) const {
+    return bbs[bbIndices[index]];
   }
 
+  MeasurementSpan getMeasurements(unsigned core, BasicBlock *bb) const;
 };
 
 #endif
@@ -24,10 +24,17 @@
 #include <QTreeView>
 #include <QMainWindow>
 
+#include <atomic>
+
 #include "profile.h"
+#include "cfg/cfg.h"
 #include "cfg/loop.h"
 
 Profile::Profile() {
+  for(unsigned core = 0; core < Pmu::MAX_CORES; core++) {
+    inclusiveProfile[core] = NULL;
+    inclusiveCfg[core] = 0;
+  }
 }
 
 Profile::~Profile() {
@@ -35,12 +42,12 @@ Profile::~Profile() {
   disconnect();
 }
 
-void Profile::connect() {
-  static int dbCounter = 0;
+void Profile::connect(QString dbFilename) {
+  static std::atomic<int> dbCounter(0);
   dbConnection = QString("profile") + QString("%1").arg(dbCounter++);
 
   QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", dbConnection);
-  db.setDatabaseName("profile.db3");
+  db.setDatabaseName(dbFilename);
 
   bool success = db.open();
 
@@ -99,6 +106,8 @@ void Profile::disconnect() {
 }
 
 void Profile::update() {
+  clearInclusiveProfiles();
+
   QSqlDatabase db = QSqlDatabase::database(dbConnection);
 
   QSqlQuery query(db);
@@ -126,25 +135,6 @@ void Profile::update() {
   }
 }
 
-void Profile::addMeasurement(Measurement measurement) {
-  measurements.push_back(measurement);
-
-  unsigned core = measurement.core;
-  BasicBlock *bb = measurement.bb;
-  std::vector<Measurement> *mments = NULL;
-
-  auto it = measurementsPerBb[core].find(bb);
-
-  if(it == measurementsPerBb[core].end()) {
-    mments = new std::vector<Measurement>();
-    measurementsPerBb[core][bb] = mments;
-  } else {
-    mments = it->second;
-  }
-
-  mments->push_back(measurement);
-}
-
 void Profile::clean() {
   clear();
 
@@ -158,172 +148,35 @@ void Profile::clean() {
   query.exec("DELETE FROM meta");
 }
 
-void Profile::setMeasurements(QVector<Measurement> *measurements) {
-  for(unsigned core = 0; core < Pmu::MAX_CORES; core++) {
-    measurementsPerBb[core].clear();
+InclusiveProfile *Profile::getInclusiveProfile(unsigned core, Cfg *cfg) {
+  // the cached profile holds pointers into the cfg it was built from
+  if(inclusiveProfile[core] && (inclusiveCfg[core] != cfg->serial)) {
+    delete inclusiveProfile[core];
+    inclusiveProfile[core] = NULL;
   }
-  this->measurements.clear();
-  // for(int i = 1; i < measurements->size(); i++) {
-  //   auto measurement = (*measurements)[i];
-  //   addMeasurement(measurement);
-  // }
-  for(auto m : *measurements) {
-    addMeasurement(m);
+  if(!inclusiveProfile[core]) {
+    inclusiveProfile[core] = new InclusiveProfile(this, cfg, core);
+    inclusiveCfg[core] = cfg->serial;
   }
+  return inclusiveProfile[core];
 }
 
-void Profile::getProfData(unsigned core, BasicBlock *bb,
-                          double *runtime, double *energy, double *runtimeFrame, double *energyFrame, uint64_t *count) {
-  QSqlDatabase db = QSqlDatabase::database(dbConnection);
-  QSqlQuery query(db);
-  QString queryString;
-
-  if(bb->getTop()->externalMod == bb->getModule()) {
-    queryString =
-      QString() +
-      "SELECT id,runtime,energy1,energy2,energy3,energy4,energy5,energy6,energy7,runtimeFrame,energyFrame1,energyFrame2,energyFrame3,energyFrame4,energyFrame5,energyFrame6,energyFrame7,loopcount" +
-      " FROM location" +
-      " WHERE core = " + QString::number(core) +
-      " AND module = \"" + bb->getTop()->externalMod->id +
-      "\" AND function = \"" + bb->getFunction()->id + "\"";
-
-  } else {
-    queryString =
-      QString() +
-      "SELECT id,runtime,energy1,energy2,energy3,energy4,energy5,energy6,energy7,runtimeFrame,energyFrame1,energyFrame2,energyFrame3,energyFrame4,energyFrame5,energyFrame6,energyFrame7,loopcount" +
-      " FROM location" +
-      " WHERE core = " + QString::number(core) +
-      " AND module = \"" + bb->getModule()->id +
-      "\" AND basicblock = \"" + bb->id + "\"";
-  }
-
-  query.exec(queryString);
-
-  if(query.next()) {
-    *runtime = query.value("runtime").toDouble();
-    energy[0] = query.value("energy1").toDouble();
-    energy[1] = query.value("energy2").toDouble();
-    energy[2] = query.value("energy3").toDouble();
-    energy[3] = query.value("energy4").toDouble();
-    energy[4] = query.value("energy5").toDouble();
-    energy[5] = query.value("energy6").toDouble();
-    energy[6] = query.value("energy7").toDouble();
-
-    *runtimeFrame = query.value("runtimeFrame").toDouble();
-    energyFrame[0] = query.value("energyFrame1").toDouble();
-    energyFrame[1] = query.value("energyFrame2").toDouble();
-    energyFrame[2] = query.value("energyFrame3").toDouble();
-    energyFrame[3] = query.value("energyFrame4").toDouble();
-    energyFrame[4] = query.value("energyFrame5").toDouble();
-    energyFrame[5] = query.value("energyFrame6").toDouble();
-    energyFrame[6] = query.value("energyFrame7").toDouble();
-
-    int id = query.value("id").toInt();
-
-    QSqlQuery countQuery(db);
-    countQuery.exec("SELECT sum(num) FROM arc WHERE selfid = " + QString::number(id));
-    if(countQuery.next()) {
-      *count = countQuery.value(0).toInt();
-    } else {
-      *count = 0; // todo
-    }
-
-    // TODO: should possibly be somewhere else
-    uint64_t loopCount = query.value("loopcount").toULongLong();
-    if(loopCount) {
-      Vertex *loop = bb->parent;
-      while(!loop->isLoop()) {
-        loop = loop->parent;
-        if(!loop) break;
-      }
-
-      if(loop) (static_cast<Loop*>(loop))->count = loopCount;
-      else {
-        printf("Cant find loop:\n");
-        printf("  Mod %s\n", bb->getModule()->id.toUtf8().constData());
-        printf("  Func %s\n", bb->getFunction()->id.toUtf8().constData());
-        printf("  Bb: %s\n", bb->id.toUtf8().constData());
-      }
-    }
-
-  } else {
-    *runtime = 0;
-    *runtimeFrame = 0;
-    for(int i = 0; i < LYNSYN_SENSORS; i++) {
-      energy[i] = 0;
-      energyFrame[i] = 0;
-    }
-    *count = 0;
-  }
-}
-
-int Profile::getId(unsigned core, BasicBlock *bb) {
-  QSqlDatabase db = QSqlDatabase::database(dbConnection);
-  QSqlQuery query(db);
-  QString queryString;
-
-  if(bb->getTop()->externalMod == bb->getModule()) {
-    queryString =
-      QString() +
-      "SELECT id FROM location" +
-      " WHERE core = " + QString::number(core) +
-      " AND module = \"" + bb->getTop()->externalMod->id +
-      "\" AND function = \"" + bb->getFunction()->id + "\"";
-
-  } else {
-    queryString =
-      QString() +
-      "SELECT id FROM location" +
-      " WHERE core = " + QString::number(core) +
-      " AND module = \"" + bb->getModule()->id +
-      "\" AND basicblock = \"" + bb->id + "\"";
-  }
-
-  query.exec(queryString);
-
-  if(query.next()) {
-    return query.value(0).toInt();
-  } else {
-    return 0;
+void Profile::clearInclusiveProfiles() {
+  for(unsigned core = 0; core < Pmu::MAX_CORES; core++) {
+    delete inclusiveProfile[core];
+    inclusiveProfile[core] = NULL;
+    inclusiveCfg[core] = 0;
   }
 }
 
 double Profile::getArcRatio(unsigned core, BasicBlock *bb, Function *func) {
-  int fromid = getId(core, bb);
-  int selfid = getId(core, func->getFirstBb());
-
-  QSqlDatabase db = QSqlDatabase::database(dbConnection);
-  QSqlQuery query(db);
-  query.exec("SELECT sum(num) FROM arc WHERE selfid = " + QString::number(selfid));
-
-  int totalCalls = 0;
-  if(query.next()) {
-    totalCalls = query.value(0).toInt();
-  }
-
-  if(!totalCalls) return 0;
-
-  query.exec("SELECT sum(num) FROM arc WHERE fromid = " + QString::number(fromid) + " AND selfid = " + QString::number(selfid));
-
-  int calls = 0;
-  if(query.next()) {
-    calls = query.value(0).toInt();
-  }
-
-  return (double)calls / (double)totalCalls;
+  return getInclusiveProfile(core, bb->getTop())->getArcRatio(bb, func);
 }
 
-void Profile::getMeasurements(unsigned core, BasicBlock *bb, QVector<Measurement> *measurements) {
-  std::vector<Measurement> *mments;
-  auto it = measurementsPerBb[core].find(bb);
-  if(it == measurementsPerBb[core].end()) {
-    return;
-  } else {
-    mments = it->second;
-  }
-
-  for(auto m : *mments) {
-    measurements->push_back(m);
+void Profile::getMeasurements(unsigned core, BasicBlock *bb, QVector<MeasurementSpan> *measurements) {
+  MeasurementSpan span = this->measurements.getMeasurements(core, bb);
+  if(span.size()) {
+    measurements->push_back(span);
   }
 }
 
@@ -356,12 +209,9 @@ void Profile::addExternalFunctions(Cfg *cfg) {
 }
 
 void Profile::clear() {
-  for(unsigned core = 0; core < Pmu::MAX_CORES; core++) {
-    for(auto const &it : measurementsPerBb[core]) {
-      delete it.second;
-    }
-    measurementsPerBb[core].clear();
-  }
+  clearInclusiveProfiles();
+
+  measurements.clear();
 }
 
 double Profile::getMinPower(unsigned sensor) {
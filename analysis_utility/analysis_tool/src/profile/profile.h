@@ -32,6 +32,7 @@
 #include "cfg/module.h"
 #include "cfg/basicblock.h"
 #include "measurement.h"
+#include "inclusiveprofile.h"
 
 class Profile {
 
@@ -40,26 +41,27 @@ private:
   double runtime;
   double energy[Pmu::MAX_SENSORS];
 
-  void addMeasurement(Measurement measurement);
-  int getId(unsigned core, BasicBlock *bb);
+  InclusiveProfile *inclusiveProfile[Pmu::MAX_CORES];
+  unsigned inclusiveCfg[Pmu::MAX_CORES];
+
 
 public:
   QString dbConnection;
 
-  std::map<BasicBlock*, std::vector<Measurement>*> measurementsPerBb[Pmu::MAX_CORES];
-  QVector<Measurement> measurements;
+  MeasurementStore measurements;
 
   Profile();
   virtual ~Profile();
 
-  void connect();
+  void connect(QString dbFilename = "profile.db3");
   void disconnect();
   void update();
 
-  void setMeasurements(QVector<Measurement> *measurements);
-  void getProfData(unsigned core, BasicBlock *bb,
-                   double *runtime, double *energy, double *runtimeFrame, double *energyFrame, uint64_t *count);
-  void getMeasurements(unsigned core, BasicBlock *bb, QVector<Measurement> *measurements);
+  void getMeasurements(unsigned core, BasicBlock *bb, QVector<MeasurementSpan> *measurements);
+
+  // inclusive profile data for the given core and cfg, built on first use
+  InclusiveProfile *getInclusiveProfile(unsigned core, Cfg *cfg);
+  void clearInclusiveProfiles();
 
   double getArcRatio(unsigned core, BasicBlock *bb, Function *func);
 
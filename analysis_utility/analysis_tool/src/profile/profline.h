@@ -28,10 +28,6 @@ class Vertex;
 
 class ProfLine {
 
-  static bool lessThan(const Measurement &e1, const Measurement &e2) {
-    return e1.time < e2.time;
-  }
-
 public:
   Vertex *vertex;
   double runtime;
@@ -40,7 +36,7 @@ public:
   double runtimeFrame;
   double powerFrame[Pmu::MAX_SENSORS];
   double energyFrame[Pmu::MAX_SENSORS];
-  QVector<Measurement> measurements;
+  QVector<MeasurementSpan> measurements;
 
   ProfLine() {}
 
@@ -58,9 +54,12 @@ public:
     }
   }
 
-  QVector<Measurement> *getMeasurements() {
-    qSort(measurements.begin(), measurements.end(), lessThan);
-    return &measurements;
+  unsigned numMeasurements() const {
+    unsigned num = 0;
+    for(auto span : measurements) {
+      num += span.size();
+    }
+    return num;
   }
 
 };
@@ -52,7 +52,7 @@ public:
   }
   bool operator() (ProfLine *i, ProfLine *j) {
     if(column == -1) {
-      return i->measurements.size() > j->measurements.size();
+      return i->numMeasurements() > j->numMeasurements();
     }
 
     if(order == Qt::AscendingOrder) {
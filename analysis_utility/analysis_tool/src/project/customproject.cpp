@@ -33,6 +33,7 @@ bool CustomProject::openProject(QString path) {
   opened = true;
 
   QDir::setCurrent(path);
+  buildDir = fileInfo.absolutePath();
 
   loadProjectFile();
 
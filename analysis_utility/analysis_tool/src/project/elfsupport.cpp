@@ -19,6 +19,13 @@
  *
  *****************************************************************************/
 
+#include <elf.h>
+#include <string.h>
+
+#include <algorithm>
+
+#include <QFile>
+
 #include "elfsupport.h"
 
 static char *readLine(char *s, int size, FILE *stream) {
@@ -36,6 +43,117 @@ static char *readLine(char *s, int size, FILE *stream) {
   return ret;
 }
 
+template<class Ehdr, class Shdr, class Sym, class Word>
+static void readBbMap(const uchar *data, uint64_t size, std::vector<BbMapEntry> &entries) {
+  const Ehdr *ehdr = (const Ehdr*)data;
+
+  if((ehdr->e_shoff == 0) || (ehdr->e_shstrndx >= ehdr->e_shnum)) return;
+  if(ehdr->e_shoff + ehdr->e_shnum * sizeof(Shdr) > size) return;
+
+  // thumb addresses have bit 0 set
+  uint64_t mask = (ehdr->e_machine == EM_ARM) ? ~1ull : ~0ull;
+
+  const Shdr *sections = (const Shdr*)(data + ehdr->e_shoff);
+  const Shdr *names = &sections[ehdr->e_shstrndx];
+
+  const Shdr *bbmap = NULL;
+  const Shdr *bbstr = NULL;
+  const Shdr *symtab = NULL;
+
+  for(unsigned i = 0; i < ehdr->e_shnum; i++) {
+    if((sections[i].sh_type == SHT_NOBITS) || (sections[i].sh_offset + sections[i].sh_size > size)) continue;
+    if(sections[i].sh_name >= names->sh_size) continue;
+
+    const char *name = (const char*)data + names->sh_offset + sections[i].sh_name;
+
+    if(!strcmp(name, ".tulipp_bbmap")) bbmap = &sections[i];
+    else if(!strcmp(name, ".tulipp_bbstr")) bbstr = &sections[i];
+    else if(sections[i].sh_type == SHT_SYMTAB) symtab = &sections[i];
+  }
+
+  if(!bbmap || !bbstr) return;
+
+  // function extents, the last range in a function ends at the end of the function
+  std::vector<std::pair<uint64_t,uint64_t>> functions;
+  if(symtab) {
+    const Sym *symbols = (const Sym*)(data + symtab->sh_offset);
+    for(unsigned i = 0; i < symtab->sh_size / sizeof(Sym); i++) {
+      if(((symbols[i].st_info & 0xf) == STT_FUNC) && symbols[i].st_size) {
+        uint64_t start = symbols[i].st_value & mask;
+        functions.push_back(std::make_pair(start, start + symbols[i].st_size));
+      }
+    }
+    std::sort(functions.begin(), functions.end());
+  }
+
+  // records are { address, module ID string offset, BB ID }
+  std::vector<BbMapEntry> map;
+
+  for(uint64_t offset = 0; offset + 3 * sizeof(Word) <= bbmap->sh_size; offset += 3 * sizeof(Word)) {
+    Word record[3];
+    memcpy(record, data + bbmap->sh_offset + offset, sizeof(record));
+
+    if(record[1] >= bbstr->sh_size) continue;
+    const char *moduleId = (const char*)data + bbstr->sh_offset + record[1];
+
+    BbMapEntry entry;
+    entry.start = record[0] & mask;
+    entry.end = ~0ull;
+    entry.moduleId = QString::fromUtf8(moduleId, strnlen(moduleId, bbstr->sh_size - record[1]));
+    entry.bbId = record[2];
+
+    map.push_back(entry);
+  }
+
+  std::stable_sort(map.begin(), map.end());
+
+  // a range ends where the next one starts, or at the end of its function
+  for(unsigned i = 0; i < map.size(); i++) {
+    if(i + 1 < map.size()) map[i].end = map[i+1].start;
+
+    auto func = std::upper_bound(functions.begin(), functions.end(), std::make_pair(map[i].start, (uint64_t)~0ull));
+    if(func != functions.begin()) {
+      func--;
+      if((map[i].start < func->second) && (func->second < map[i].end)) map[i].end = func->second;
+    }
+  }
+
+  entries.insert(entries.end(), map.begin(), map.end());
+}
+
+void ElfSupport::loadBbMap(QString elfFile) {
+  QFile file(elfFile);
+  if(!file.open(QIODevice::ReadOnly)) return;
+
+  uint64_t size = file.size();
+  uchar *data = file.map(0, size);
+  if(!data) return;
+
+  if((size >= EI_NIDENT) && !memcmp(data, ELFMAG, SELFMAG)) {
+    if((data[EI_CLASS] == ELFCLASS64) && (size >= sizeof(Elf64_Ehdr))) {
+      readBbMap<Elf64_Ehdr, Elf64_Shdr, Elf64_Sym, uint64_t>(data, size, bbMap);
+    } else if((data[EI_CLASS] == ELFCLASS32) && (size >= sizeof(Elf32_Ehdr))) {
+      readBbMap<Elf32_Ehdr, Elf32_Shdr, Elf32_Sym, uint32_t>(data, size, bbMap);
+    }
+  }
+
+  file.unmap(data);
+
+  std::stable_sort(bbMap.begin(), bbMap.end());
+}
+
+const BbMapEntry *ElfSupport::findBb(uint64_t pc) {
+  BbMapEntry key;
+  key.start = pc;
+
+  auto it = std::upper_bound(bbMap.begin(), bbMap.end(), key);
+  if(it == bbMap.begin()) return NULL;
+
+  it--;
+  if(pc >= it->end) return NULL;
+
+  return &(*it);
+}
 
 void ElfSupport::setPc(uint64_t pc) {
   if(prevPc != pc) {
@@ -121,15 +239,33 @@ uint64_t ElfSupport::getLineNumber(uint64_t pc) {
 }
 
 bool ElfSupport::isBb(uint64_t pc) {
+  if(bbMap.size()) return findBb(pc) != NULL;
+
+  // binaries without BB map have the BB IDs in the debug info, in files named @<module>
   setPc(pc);
   return addr2line.filename[0] == '@';
 }
 
 QString ElfSupport::getModuleId(uint64_t pc) {
+  if(bbMap.size()) {
+    const BbMapEntry *entry = findBb(pc);
+    return entry ? entry->moduleId : "";
+  }
+
   setPc(pc);
   return addr2line.filename.right(addr2line.filename.size()-1);
 }
 
+unsigned ElfSupport::getBbId(uint64_t pc) {
+  if(bbMap.size()) {
+    const BbMapEntry *entry = findBb(pc);
+    return entry ? entry->bbId : 0;
+  }
+
+  setPc(pc);
+  return addr2line.lineNumber;
+}
+
 uint64_t ElfSupport::lookupSymbol(QString symbol) {
   FILE *fp;
   char buf[1024];
@@ -26,6 +26,7 @@
 #include <QStringList>
 
 #include <map>
+#include <vector>
 #include <sstream>
 
 class Addr2Line {
@@ -50,6 +51,18 @@ public:
   }
 };
 
+class BbMapEntry {
+public:
+  uint64_t start;
+  uint64_t end;
+  QString moduleId;
+  unsigned bbId;
+
+  bool operator<(const BbMapEntry &other) const {
+    return start < other.start;
+  }
+};
+
 class ElfSupport {
 
 private:
@@ -60,7 +73,12 @@ private:
 
   Addr2Line addr2line;
 
+  // address ranges of the BBs, from the .tulipp_bbmap section.  Sorted by start address
+  std::vector<BbMapEntry> bbMap;
+
   void setPc(uint64_t pc);
+  void loadBbMap(QString elfFile);
+  const BbMapEntry *findBb(uint64_t pc);
 
 public:
   ElfSupport() {
@@ -69,6 +87,7 @@ public:
   void addElf(QString elfFile) {
     if(elfFile.trimmed() != "") {
       elfFiles.push_back(elfFile);
+      loadBbMap(elfFile);
     }
   }
 
@@ -79,6 +98,7 @@ public:
   uint64_t getLineNumber(uint64_t pc);
   bool isBb(uint64_t pc);
   QString getModuleId(uint64_t pc);
+  unsigned getBbId(uint64_t pc);
 
   // get symbol value
   uint64_t lookupSymbol(QString symbol);
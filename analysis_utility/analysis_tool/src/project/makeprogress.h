@@ -0,0 +1,63 @@
+/******************************************************************************
+ *
+ *  This file is part of the TULIPP Analysis Utility
+ *
+ *  Copyright 2018 Asbjørn Djupdal, NTNU, TULIPP EU Project
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *****************************************************************************/
+
+#ifndef MAKEPROGRESS_H
+#define MAKEPROGRESS_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QRegularExpression>
+
+// Finds the targets make starts, in the lines it prints.  A target only matches as a whole word
+// of the line, so that foo.o does not match foo.o.d or libfoo.o
+class MakeProgress {
+
+private:
+  QStringList targets;
+  QVector<QRegularExpression> expressions;
+
+public:
+  MakeProgress(QStringList targets) {
+    this->targets = targets;
+    for(auto target : targets) {
+      expressions.push_back(QRegularExpression("(^|[\\s/'])" + QRegularExpression::escape(target) + "($|[\\s'])"));
+    }
+  }
+
+  // the targets started in this line, each target is only returned the first time
+  QStringList match(QString line) {
+    QStringList started;
+
+    for(int i = 0; i < targets.size(); i++) {
+      if(expressions[i].match(line).hasMatch()) {
+        started << targets[i];
+        targets.removeAt(i);
+        expressions.removeAt(i);
+        i--;
+      }
+    }
+
+    return started;
+  }
+};
+
+#endif
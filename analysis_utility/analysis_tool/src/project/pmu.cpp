@@ -43,8 +43,9 @@ uint32_t acceptedFirmwares[] = {
 
 ///////////////////////////////////////////////////////////////////////////////
 
-DBStorer::DBStorer(uint8_t swVersion) {
+DBStorer::DBStorer(uint8_t swVersion, QString dbFilename) {
   this->swVersion = swVersion;
+  this->dbFilename = dbFilename;
 }
 
 DBStorer::~DBStorer() {
@@ -52,7 +53,7 @@ DBStorer::~DBStorer() {
 
 void DBStorer::initTransaction() {
   QSqlDatabase threadDb = QSqlDatabase::addDatabase("QSQLITE", "thread");
-  threadDb.setDatabaseName("profile.db3");
+  threadDb.setDatabaseName(dbFilename);
   bool success = threadDb.open();
   if(!success) {
     QSqlError error = threadDb.lastError();
@@ -211,7 +212,8 @@ bool Pmu::init() {
        (initReply.swVersion != SW_VERSION_1_1) &&
        (initReply.swVersion != SW_VERSION_1_3) &&
        (initReply.swVersion != SW_VERSION_1_4) &&
-       (initReply.swVersion != SW_VERSION_1_5)) {
+       (initReply.swVersion != SW_VERSION_1_5) &&
+       (initReply.swVersion != SW_VERSION_1_6)) {
       printf("Unsupported Lynsyn SW Version: %x\n", initReply.swVersion);
       return false;
     }
@@ -317,9 +319,10 @@ bool Pmu::collectSamples(bool useFrame, bool useStartBp,
                          uint64_t frameAddr, bool startAtBp, unsigned stopAt, bool samplePc, bool samplingModeGpio,
                          int64_t samplePeriod, uint64_t startAddr, uint64_t stopAddr, 
                          uint64_t *samples, int64_t *minTime, int64_t *maxTime, double *minPower, double *maxPower,
-                         double *runtime, double *energy) {
+                         double *runtime, double *energy, QString dbFilename,
+                         double abortLimit, int abortSensor, bool *aborted) {
 
-  DBStorer *dbStorer = new DBStorer(swVersion);
+  DBStorer *dbStorer = new DBStorer(swVersion, dbFilename);
 
   dbStorer->moveToThread(&dbThread);
 
@@ -441,6 +444,12 @@ bool Pmu::collectSamples(bool useFrame, bool useStartBp,
 
   int64_t lastTime = -1;
 
+  // sampling is stopped early when the runtime (abortSensor -1) or the energy of abortSensor
+  // exceeds abortLimit.  Both only grow, so the final value is known to be worse.
+  bool stopSent = false;
+  if(aborted) *aborted = false;
+  if(swVersion < SW_VERSION_1_6) abortLimit = 0;
+
   while(!done) {
     counter++;
     if(swVersion <= SW_VERSION_1_1) {
@@ -507,6 +516,21 @@ bool Pmu::collectSamples(bool useFrame, bool useStartBp,
         Sample *s = new Sample(timeSinceLast, *sample, power);
 
         emit storeRawSample(s);
+
+        if((abortLimit > 0) && !stopSent) {
+          double partial = (abortSensor < 0) ? cyclesToSeconds(sample->time - *minTime) : energy[abortSensor];
+
+          if(partial > abortLimit) {
+            printf("Limit exceeded, stopping\n");
+
+            struct RequestPacket req;
+            req.cmd = USB_CMD_STOP_SAMPLING;
+            sendBytes((uint8_t*)&req, sizeof(struct RequestPacket));
+
+            stopSent = true;
+            if(aborted) *aborted = true;
+          }
+        }
       }
 
       sample++;
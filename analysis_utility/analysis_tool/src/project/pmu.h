@@ -39,8 +39,6 @@
 #define LYNSYN_SENSORS 7
 #define LYNSYN_FREQ 48000000
 
-class Measurement;
-
 ///////////////////////////////////////////////////////////////////////////////
 
 class Sample {
@@ -66,9 +64,10 @@ class DBStorer : public QObject {
 private:
   QSqlQuery *query;
   uint8_t swVersion;
+  QString dbFilename;
 
 public:
-  DBStorer(uint8_t swVersion);
+  DBStorer(uint8_t swVersion, QString dbFilename);
   ~DBStorer();
 
 public slots:
@@ -134,7 +133,8 @@ public:
                       uint64_t frameAddr, bool startAtBp, unsigned stopAt, bool samplePc, bool samplingModeGpio,
                       int64_t samplePeriod, uint64_t startAddr, uint64_t stopAddr, 
                       uint64_t *samples, int64_t *minTime, int64_t *maxTime, double *minPower, double *maxPower,
-                      double *runtime, double *energy);
+                      double *runtime, double *energy, QString dbFilename = "profile.db3",
+                      double abortLimit = 0, int abortSensor = -1, bool *aborted = NULL);
 
   unsigned numSensors() { return LYNSYN_SENSORS; }
   unsigned numCores() { return LYNSYN_MAX_CORES; }
@@ -23,6 +23,9 @@
 #include <math.h>
 #include <unistd.h>
 #include <inttypes.h>
+#include <string.h>
+
+#include <atomic>
 
 #include <QApplication>
 #include <QTextStream>
@@ -30,11 +33,19 @@
 #include <QProgressDialog>
 #include <QSettings>
 #include <QInputDialog>
+#include <QProcess>
+#include <QStandardPaths>
+#include <QRegularExpression>
+#include <QDirIterator>
 
 #include "analysis_tool.h"
 #include "project.h"
 #include "pmu.h"
 #include "location.h"
+#include "makeprogress.h"
+
+// file versions written by libtulipp
+#include "profformat.h"
 
 struct gmonhdr {
  uint64_t lpc; /* base pc address of sample buffer */
@@ -53,6 +64,138 @@ struct rawarc {
  int64_t raw_count;
 };
 
+// LEB128 decoding for the compact file versions
+static uint64_t readVarint(const uint8_t *&pos, const uint8_t *end) {
+  uint64_t value = 0;
+  unsigned shift = 0;
+  while(pos < end) {
+    uint8_t byte = *pos++;
+    if(shift < 64) value |= (uint64_t)(byte & 0x7f) << shift;
+    if(!(byte & 0x80)) break;
+    shift += 7;
+  }
+  return value;
+}
+
+static int64_t readSigned(const uint8_t *&pos, const uint8_t *end) {
+  uint64_t value = readVarint(pos, end);
+  return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+}
+
+static double readDouble(const uint8_t *&pos, const uint8_t *end) {
+  double value = 0;
+  if(end - pos >= (ptrdiff_t)sizeof(double)) {
+    memcpy(&value, pos, sizeof(double));
+    pos += sizeof(double);
+  } else {
+    pos = end;
+  }
+  return value;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// build cache
+
+QString Project::toolFingerprint() {
+  // changes when any of the build tools is replaced
+  QStringList tools;
+  tools << Config::clang << Config::clangpp << Config::opt << Config::llc << Config::llvm_ir_parser
+        << Config::as << Config::asUs << Config::linker << Config::linkerpp << Config::linkerUs << Config::linkerppUs
+        << "sdscc" << "sds++";
+
+  QStringList fingerprint;
+  for(auto tool : tools) {
+    QString executable = QStandardPaths::findExecutable(tool.split(' ')[0]);
+    QFileInfo info(executable);
+    fingerprint << tool + ":" + QString::number(info.size()) + ":" + QString::number(info.lastModified().toMSecsSinceEpoch());
+  }
+
+  return fingerprint.join(',');
+}
+
+void Project::writeCacheVariable(QFile &makefile) {
+  makefile.write((QString("TULIPP_CACHE = ") + Config::buildCacheDir + "\n\n").toUtf8());
+}
+
+QString Project::cachedRecipe(QString command, QString outputs, QString hashInput) {
+  if(Config::buildCacheDir == "") {
+    return QString("\t") + command + "\n\n";
+  }
+
+  // the cache entry is named by the hash of the inputs, the command and the tools.
+  // Entries are created under a temporary name and renamed, so that concurrent builds can share the cache
+  QString quotedCommand = command;
+  quotedCommand.replace("'", "'\\''");
+
+  // a hit touches .done, so that trimBuildCache() evicts the least recently used entries first.
+  // If the entry is evicted while it is copied, the command is run instead
+  QString recipe;
+  recipe += "\t@key=$$( { " + hashInput + "; echo '" + quotedCommand + "'; echo '" + toolFingerprint() + "'; } | sha1sum | cut -d' ' -f1 ); \\\n";
+  recipe += "\tdir=$(TULIPP_CACHE)/$$key; \\\n";
+  recipe += "\tif [ -f $$dir/.done ] && cp -R $$dir/data/. . 2> /dev/null; then \\\n";
+  recipe += "\t  echo 'Using cached " + outputs + "'; \\\n";
+  recipe += "\t  touch $$dir/.done 2> /dev/null || true; \\\n";
+  recipe += "\telse \\\n";
+  recipe += "\t  echo '" + quotedCommand + "'; \\\n";
+  recipe += "\t  " + command + " || exit 1; \\\n";
+  recipe += "\t  tmp=$$dir.$$$$; \\\n";
+  recipe += "\t  mkdir -p $$tmp/data; \\\n";
+  recipe += "\t  for f in " + outputs + "; do if [ -e $$f ]; then cp -R --parents $$f $$tmp/data; fi; done; \\\n";
+  recipe += "\t  touch $$tmp/.done; \\\n";
+  recipe += "\t  mv -T $$tmp $$dir 2> /dev/null || rm -rf $$tmp; \\\n";
+  recipe += "\tfi\n\n";
+
+  return recipe;
+}
+
+void Project::trimBuildCache() {
+  if((Config::buildCacheDir == "") || !Config::buildCacheSize) return;
+
+  QDir cacheDir(Config::buildCacheDir);
+  if(!cacheDir.exists()) return;
+
+  // complete entries, oldest use first.  Entries being written or evicted have a '.' in their name,
+  // they are left alone unless they were abandoned by a build that died
+  QMultiMap<qint64,QString> entries;
+  qint64 totalSize = 0;
+  QMap<QString,qint64> entrySize;
+
+  for(auto info : cacheDir.entryInfoList(QDir::Dirs | QDir::NoDotAndDotDot)) {
+    if(info.fileName().contains('.')) {
+      if(info.lastModified().secsTo(QDateTime::currentDateTime()) > 24 * 60 * 60) {
+        QDir(info.filePath()).removeRecursively();
+      }
+      continue;
+    }
+
+    QFileInfo done(info.filePath() + "/.done");
+    if(!done.exists()) continue;
+
+    qint64 size = 0;
+    QDirIterator it(info.filePath(), QDir::Files | QDir::Hidden | QDir::System, QDirIterator::Subdirectories);
+    while(it.hasNext()) {
+      it.next();
+      size += it.fileInfo().size();
+    }
+
+    entries.insert(done.lastModified().toMSecsSinceEpoch(), info.filePath());
+    entrySize[info.filePath()] = size;
+    totalSize += size;
+  }
+
+  qint64 limit = (qint64)Config::buildCacheSize * 1024 * 1024;
+
+  for(auto it = entries.begin(); (it != entries.end()) && (totalSize > limit); it++) {
+    // rename first, so that a concurrent build never sees a partially removed entry as complete
+    static std::atomic<unsigned> evictions(0);
+    QString evicted = it.value() + ".evict" + QString::number(QCoreApplication::applicationPid()) + "_" + QString::number(evictions++);
+    if(QDir().rename(it.value(), evicted)) {
+      QDir(evicted).removeRecursively();
+    }
+    totalSize -= entrySize[it.value()];
+  }
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // makefile creation
 
@@ -73,7 +216,7 @@ void Project::writeTulippCompileRule(QString compiler, QFile &makefile, QString
     as = Config::asUs;
   }
 
-  // .ll
+  // .bc, bitcode is used between the tools since it is much faster to read and write than textual IR
   {
     QStringList options;
 
@@ -89,28 +232,30 @@ void Project::writeTulippCompileRule(QString compiler, QFile &makefile, QString
     }
     options << clangTarget;
 
-    makefile.write((fileInfo.completeBaseName() + ".ll : " + path + "\n").toUtf8());
-    makefile.write((QString("\t") + compiler + " " + options.join(' ') + " -g -emit-llvm -S $<\n\n").toUtf8());
-  }
+    // the .d file lists the included headers, so that make rebuilds when a header changes
+    QString depFile = fileInfo.completeBaseName() + ".d";
 
-  // .xml
-  {
-    makefile.write((fileInfo.completeBaseName() + ".xml : " + fileInfo.completeBaseName() + ".ll\n").toUtf8());
-    makefile.write((QString("\t") + Config::llvm_ir_parser + " $< -xml $@\n\n").toUtf8());
+    makefile.write((fileInfo.completeBaseName() + ".bc : " + path + "\n").toUtf8());
+    // the preprocessed source is hashed, so that changes in included headers are detected.
+    // With -g the object records the build directory, so that is hashed too
+    makefile.write(cachedRecipe(compiler + " " + options.join(' ') + " -MMD -MP -MF " + depFile + " -g -emit-llvm -c $< -o $@",
+                                "$@ " + depFile,
+                                compiler + " " + options.join(' ') + " -E $<; pwd").toUtf8());
   }
 
-  // _2.ll
+  // .xml and _2.bc, made by the same llvm_ir_parser run
   {
-    if(instrument) {
-      makefile.write((fileInfo.completeBaseName() + "_instrumented_2.ll : " + fileInfo.completeBaseName() + ".ll\n").toUtf8());
-      makefile.write((QString("\t") + Config::llvm_ir_parser + " $< -ll $@ --instrument\n\n").toUtf8());
-    } else {
-      makefile.write((fileInfo.completeBaseName() + "_2.ll : " + fileInfo.completeBaseName() + ".ll\n").toUtf8());
-      makefile.write((QString("\t") + Config::llvm_ir_parser + " $< -ll $@\n\n").toUtf8());
-    }
+    QString xml = fileInfo.completeBaseName() + ".xml";
+    QString ir2 = fileInfo.completeBaseName() + (instrument ? "_instrumented_2.bc" : "_2.bc");
+
+    makefile.write((ir2 + " : " + fileInfo.completeBaseName() + ".bc\n").toUtf8());
+    makefile.write(cachedRecipe(Config::llvm_ir_parser + " $< -all " + xml + " $@" + (instrument ? " --instrument" : "") + (instrument && loopCounters ? " --loop-counters" : ""),
+                                xml + " $@").toUtf8());
+
+    makefile.write((xml + " : " + ir2 + " ;\n\n").toUtf8());
   }
 
-  // _3.ll
+  // _3.bc
   {
     QStringList options;
     if(cppOptLevel >= 0) {
@@ -120,12 +265,14 @@ void Project::writeTulippCompileRule(QString compiler, QFile &makefile, QString
     }
 
     if(instrument) {
-      makefile.write((fileInfo.completeBaseName() + "_instrumented_3.ll : " + fileInfo.completeBaseName() + "_instrumented_2.ll\n").toUtf8());
+      makefile.write((fileInfo.completeBaseName() + "_instrumented_3.bc : " + fileInfo.completeBaseName() + "_instrumented_2.bc\n").toUtf8());
     } else {
-      makefile.write((fileInfo.completeBaseName() + "_3.ll : " + fileInfo.completeBaseName() + "_2.ll\n").toUtf8());
+      makefile.write((fileInfo.completeBaseName() + "_3.bc : " + fileInfo.completeBaseName() + "_2.bc\n").toUtf8());
     }
 
-    makefile.write((QString("\t") + Config::opt + " " + options.join(' ') + " $< -o $@\n\n").toUtf8());
+    // the BB map is inserted after optimization
+    makefile.write(cachedRecipe(Config::opt + " " + options.join(' ') + " $< -o - | " + Config::llvm_ir_parser + " - -bbmap $@",
+                                "$@").toUtf8());
   }
 
   // .s
@@ -139,12 +286,12 @@ void Project::writeTulippCompileRule(QString compiler, QFile &makefile, QString
     options << QString(llcTarget).split(' ');
 
     if(instrument) {
-      makefile.write((fileInfo.completeBaseName() + "_instrumented.s : " + fileInfo.completeBaseName() + "_instrumented_3.ll\n").toUtf8());
+      makefile.write((fileInfo.completeBaseName() + "_instrumented.s : " + fileInfo.completeBaseName() + "_instrumented_3.bc\n").toUtf8());
     } else {
-      makefile.write((fileInfo.completeBaseName() + ".s : " + fileInfo.completeBaseName() + "_3.ll\n").toUtf8());
+      makefile.write((fileInfo.completeBaseName() + ".s : " + fileInfo.completeBaseName() + "_3.bc\n").toUtf8());
     }
 
-    makefile.write((QString("\t") + Config::llc + " " + options.join(' ') + " $< -o $@\n\n").toUtf8());
+    makefile.write(cachedRecipe(Config::llc + " " + options.join(' ') + " $< -o $@", "$@").toUtf8());
   }
 
   // .o
@@ -166,7 +313,7 @@ void Project::writeTulippCompileRule(QString compiler, QFile &makefile, QString
       makefile.write((fileInfo.completeBaseName() + ".o : " + fileInfo.completeBaseName() + ".s\n").toUtf8());
     }
 
-    makefile.write((QString("\t") + as + " " + options.join(' ') + " $< -o $@\n\n").toUtf8());
+    makefile.write(cachedRecipe(as + " " + options.join(' ') + " $< -o $@", "$@").toUtf8());
   }
 
   makefile.write(QString("###############################################################################\n\n").toUtf8());
@@ -175,7 +322,7 @@ void Project::writeTulippCompileRule(QString compiler, QFile &makefile, QString
 bool Project::createXmlMakefile() {
   QStringList xmlFiles;
 
-  QFile makefile("Makefile");
+  QFile makefile(buildPath("Makefile"));
   bool success = makefile.open(QIODevice::WriteOnly);
   if(!success) {
     QMessageBox msgBox;
@@ -188,13 +335,15 @@ bool Project::createXmlMakefile() {
   makefile.write(QString("# Autogenerated Makefile for TULIPP Analysis Tool #\n").toUtf8());
   makefile.write(QString("###################################################\n\n").toUtf8());
 
+  writeCacheVariable(makefile);
+
   makefile.write(QString(".PHONY : clean\n").toUtf8());
   makefile.write(QString("clean :\n").toUtf8());
-  makefile.write(QString("\trm -rf *.ll *.xml *.s *.o *.elf *.bit sd_card _sds __tulipp__.* __tulipp_test__.* .Xil\n\n").toUtf8());
+  makefile.write(QString("\trm -rf *.ll *.bc *.d *.xml *.s *.o *.elf *.bit sd_card _sds __tulipp__.* __tulipp_test__.* .Xil\n\n").toUtf8());
 
   makefile.write(QString(".PHONY : cleanbin\n").toUtf8());
   makefile.write(QString("cleanbin :\n").toUtf8());
-  makefile.write(QString("\trm -rf *_2.ll *_3.ll *.s *.o *.elf __tulipp__.* __tulipp_test__.*\n\n").toUtf8());
+  makefile.write(QString("\trm -rf *_2.ll *_3.ll *_2.bc *_3.bc *.s *.o *.elf __tulipp__.* __tulipp_test__.*\n\n").toUtf8());
 
   makefile.write(QString("###############################################################################\n\n").toUtf8());
 
@@ -214,6 +363,8 @@ bool Project::createXmlMakefile() {
 
   makefile.write(QString("###############################################################################\n\n").toUtf8());
 
+  writeDependencyIncludes(makefile);
+
   makefile.close();
 
   return true;
@@ -222,16 +373,92 @@ bool Project::createXmlMakefile() {
 void Project::writeCleanRule(QFile &makefile) {
   makefile.write(QString(".PHONY : clean\n").toUtf8());
   makefile.write(QString("clean :\n").toUtf8());
-  makefile.write(QString("\trm -rf *.ll *.xml *.s *.o *.elf *.bit sd_card _sds __tulipp__.* __tulipp_test__.* .Xil\n\n").toUtf8());
+  makefile.write(QString("\trm -rf *.ll *.bc *.d *.xml *.s *.o *.elf *.bit sd_card _sds __tulipp__.* __tulipp_test__.* .Xil\n\n").toUtf8());
 
   makefile.write(QString("###############################################################################\n\n").toUtf8());
 }
 
+void Project::writeDependencyIncludes(QFile &makefile) {
+  makefile.write(QString("-include $(wildcard *.d)\n\n").toUtf8());
+}
+
+int Project::runCommand(QString command) {
+  // runs in the build directory without changing the working directory of the tool itself
+  QProcess process;
+  process.setProcessChannelMode(QProcess::ForwardedChannels);
+  if(buildDir != "") process.setWorkingDirectory(buildDir);
+
+  process.start("/bin/sh", QStringList() << "-c" << command);
+  if(!process.waitForFinished(-1)) return -1;
+
+  if(process.exitStatus() != QProcess::NormalExit) return -1;
+  return process.exitCode();
+}
+
+int Project::runMake(QString target, QStringList progressTargets, int firstStep) {
+  // make runs its own jobserver, so the job count is shared with any sub-makes.
+  // Progress is reported each time make starts on one of the given targets
+  QProcess process;
+  process.setProcessChannelMode(QProcess::MergedChannels);
+  if(buildDir != "") process.setWorkingDirectory(buildDir);
+
+  unsigned jobs = Config::makeJobs > 0 ? Config::makeJobs : 1;
+
+  process.start("/bin/sh", QStringList() << "-c" << "make -j" + QString::number(jobs) + " " + target);
+  if(!process.waitForStarted(-1)) return -1;
+
+  int step = firstStep;
+  MakeProgress progress(progressTargets);
+
+  bool running = true;
+  while(running) {
+    running = process.waitForReadyRead(-1);
+
+    while(process.canReadLine() || (!running && process.bytesAvailable())) {
+      QString line = QString::fromUtf8(process.readLine());
+
+      printf("%s", line.toUtf8().constData());
+      fflush(stdout);
+
+      for(auto target : progress.match(line)) {
+        emit advance(step++, "Building " + target);
+      }
+    }
+  }
+
+  process.waitForFinished(-1);
+
+  if(process.exitStatus() != QProcess::NormalExit) return -1;
+  return process.exitCode();
+}
+
+QStringList Project::sourceTargets(QString suffix) {
+  QStringList targets;
+
+  for(auto source : sources) {
+    QFileInfo info(source);
+    if((info.suffix() == "c") || (info.suffix() == "cpp") || (info.suffix() == "cc")) {
+      targets << info.completeBaseName() + suffix;
+    }
+  }
+  targets.removeDuplicates();
+
+  return targets;
+}
+
+QStringList Project::binaryTargets() {
+  QStringList targets = sourceTargets(instrument ? "_instrumented.o" : ".o");
+  targets << elfFilename();
+  return targets;
+}
+
 bool Project::createMakefile(QFile &makefile) {
   makefile.write(QString("###################################################\n").toUtf8());
   makefile.write(QString("# Autogenerated Makefile for TULIPP Analysis Tool #\n").toUtf8());
   makefile.write(QString("###################################################\n\n").toUtf8());
 
+  writeCacheVariable(makefile);
+
   makefile.write(QString(".PHONY : binary\n").toUtf8());
   makefile.write((QString("binary : ") + elfFilename() + "\n\n").toUtf8());
 
@@ -239,6 +466,8 @@ bool Project::createMakefile(QFile &makefile) {
 
   writeCleanRule(makefile);
 
+  writeDependencyIncludes(makefile);
+
   return true;
 }
 
@@ -248,7 +477,7 @@ bool Project::createMakefile(QFile &makefile) {
 bool Project::cmake() {
   emit advance(0, "Running CMake");
 
-  errorCode = system((Config::cmake + " " + cmakeArgs).toUtf8().constData());
+  errorCode = runCommand(Config::cmake + " " + cmakeArgs);
 
   if(errorCode) {
     emit finished(errorCode, "CMake failed");
@@ -262,7 +491,7 @@ bool Project::cmake() {
 bool Project::make() {
   emit advance(0, "Building");
 
-  errorCode = system(QString("make").toUtf8().constData());
+  errorCode = runCommand("make");
 
   if(errorCode) {
     emit finished(errorCode, "Make failed");
@@ -277,7 +506,7 @@ bool Project::makeXml() {
   emit advance(0, "Building XML");
 
   bool created = createXmlMakefile();
-  if(created) errorCode = system(QString("make xml").toUtf8().constData());
+  if(created) errorCode = runMake("xml", sourceTargets(".xml"), 1);
   else errorCode = 1;
 
   if(!created || errorCode) {
@@ -290,10 +519,12 @@ bool Project::makeXml() {
 }
 
 bool Project::makeBin() {
+  trimBuildCache();
+
   emit advance(0, "Building XML");
 
   bool created = createXmlMakefile();
-  if(created) errorCode = system(QString("make xml").toUtf8().constData());
+  if(created) errorCode = runMake("xml", sourceTargets(".xml"), 1);
   else errorCode = 1;
 
   if(!created || errorCode) {
@@ -303,10 +534,10 @@ bool Project::makeBin() {
 
   loadFiles();
 
-  emit advance(1, "Building binary");
+  emit advance(xmlBuildSteps(), "Building binary");
 
   created = createMakefile();
-  if(created) errorCode = system(QString("make binary").toUtf8().constData());
+  if(created) errorCode = runMake("binary", binaryTargets(), xmlBuildSteps() + 1);
   else errorCode = 1;
 
   if(!created || errorCode) {
@@ -321,7 +552,7 @@ bool Project::makeBin() {
 bool Project::clean() {
   if(opened) {
     createXmlMakefile();
-    errorCode = system("make clean");
+    errorCode = runCommand("make clean");
   }
   return true;
 }
@@ -329,7 +560,7 @@ bool Project::clean() {
 bool Project::cleanBin() {
   if(opened) {
     createXmlMakefile();
-    errorCode = system("make cleanbin");
+    errorCode = runCommand("make cleanbin");
   }
   return true;
 }
@@ -367,6 +598,7 @@ void Project::loadProjectFile() {
 
   customElfFile = settings.value("customElfFile", "").toString();
   instrument = settings.value("instrument", false).toBool();
+  loopCounters = settings.value("loopCounters", false).toBool();
   cmakeArgs = settings.value("cmakeArgs", "..").toString();
 
   if(!isSdSocProject()) {
@@ -420,6 +652,7 @@ void Project::saveProjectFile() {
   settings.setValue("frameFunc", frameFunc);
 
   settings.setValue("instrument", instrument);
+  settings.setValue("loopCounters", loopCounters);
   settings.setValue("cmakeArgs", cmakeArgs);
 
   settings.setValue("sources", sources);
@@ -433,7 +666,7 @@ void Project::saveProjectFile() {
 ///////////////////////////////////////////////////////////////////////////////
 // transform source
 
-int Project::runSourceTool(QString inputFilename, QString outputFilename, QStringList loopsToPipeline, QString opt) {
+int Project::runSourceTool(QString inputFilename, QString outputFilename, QStringList transformations, QString opt) {
   QStringList options;
 
   options << inputFilename;
@@ -446,15 +679,13 @@ int Project::runSourceTool(QString inputFilename, QString outputFilename, QStrin
     }
   }
 
-  for(auto l : loopsToPipeline) {
-    options << QString("-pipeloop=") + l;
-  }
+  options << transformations;
 
   options << QString("-output " + outputFilename);
 
   options << QString("--");
 
-  return system((Config::tulipp_source_tool + " " + options.join(' ')).toUtf8().constData());
+  return runCommand(Config::tulipp_source_tool + " " + options.join(' '));
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -464,7 +695,7 @@ void Project::loadFiles() {
   if(cfg) delete cfg;
   cfg = new Cfg();
 
-  QDir dir(".");
+  QDir dir(buildPath("."));
   dir.setFilter(QDir::Files);
 
   // read system XML files
@@ -581,6 +812,7 @@ void Project::copy(Project *p) {
   frameFunc = p->frameFunc;
 
   instrument = p->instrument;
+  loopCounters = p->loopCounters;
   createBbInfo = p->createBbInfo;
 
   // settings from either sdsoc project or user
@@ -601,6 +833,10 @@ void Project::copy(Project *p) {
   
   customElfFile = p->customElfFile;
 
+  abortLimit = 0;
+  abortSensor = -1;
+  aborted = false;
+
   cfg = NULL;
 }
 
@@ -616,6 +852,10 @@ void Project::close() {
   opened = false;
   isCpp = false;
   path = "";
+  buildDir = "";
+  abortLimit = 0;
+  abortSensor = -1;
+  aborted = false;
   clear();
 }
 
@@ -659,7 +899,7 @@ Location *Project::getLocation(unsigned core, uint64_t pc, ElfSupport *elfSuppor
 
   if(elfSupport->isBb(pc)) {
     Module *mod = cfg->getModuleById(elfSupport->getModuleId(pc));
-    if(mod) bb = mod->getBasicBlockById(QString::number(elfSupport->getLineNumber(pc)));
+    if(mod) bb = mod->getBasicBlockById(QString::number(elfSupport->getBbId(pc)));
 
   }
 
@@ -781,42 +1021,101 @@ bool Project::parseGProfFile(QString gprofFileName, QString elfFileName) {
     return false;
   }
 
+  struct gmonhdr hdr;
+  file.read((char*)&hdr, sizeof(struct gmonhdr));
+
+  if((hdr.version != GMONVERSION) && (hdr.version != GMONVERSION_COMPACT)) {
+    QMessageBox msgBox;
+    msgBox.setText("Unsupported gmon file version");
+    msgBox.exec();
+    return false;
+  }
+
   bool success = query.exec("DELETE FROM arc");
   Q_UNUSED(success);
   assert(success);
 
-  std::map<BasicBlock*,Location*> locations;
-
   db.transaction();
 
-  struct gmonhdr hdr;
-  file.read((char*)&hdr, sizeof(struct gmonhdr));
-
   unsigned core = hdr.core;
 
   if(core == (unsigned)~0) {
     core = QInputDialog::getInt(NULL, "Enter core", "Core that produced the data file:", 0, 0, LYNSYN_MAX_CORES-1);
   }
 
-  getLocations(core, &locations);
+  std::vector<std::pair<uint64_t,uint64_t>> loops;
+  std::vector<std::pair<unsigned,struct rawarc>> arcs;
+
+  if(hdr.version == GMONVERSION_COMPACT) {
+    QByteArray data = file.readAll();
+    const uint8_t *pos = (const uint8_t*)data.constData();
+    const uint8_t *end = pos + data.size();
+
+    uint64_t pc = hdr.lpc;
+    for(int i = 0; i < hdr.loops; i++) {
+      pc += readSigned(pos, end);
+      uint64_t count = readVarint(pos, end);
+      loops.push_back(std::make_pair(pc, count));
+    }
+
+    // one group of arcs per core, ended by an arc with count 0.  The core is unknown (~0) under HIPPEROS
+    while(pos < end) {
+      unsigned arcCore = readVarint(pos, end);
+      if(arcCore == (unsigned)~0) arcCore = core;
 
-  for(int i = 0; i < hdr.loops; i++) {
-    uint64_t pc;
-    uint64_t count;
+      if(arcCore >= LYNSYN_MAX_CORES) {
+        printf("Warning: Arcs of unknown core %u\n", arcCore);
+      }
 
-    file.read((char*)&pc, sizeof(uint64_t));
-    file.read((char*)&count, sizeof(uint64_t));
+      uint64_t frompc = hdr.lpc;
+      while(pos < end) {
+        struct rawarc arc;
+        frompc += readSigned(pos, end);
+        arc.raw_frompc = frompc;
+        arc.raw_selfpc = hdr.lpc + readSigned(pos, end);
+        arc.raw_count = readVarint(pos, end);
+        if(arc.raw_count == 0) break;
+        if(arcCore < LYNSYN_MAX_CORES) arcs.push_back(std::make_pair(arcCore, arc));
+      }
+    }
+  } else {
+    for(int i = 0; i < hdr.loops; i++) {
+      uint64_t pc;
+      uint64_t count;
 
-    Location *loop = getLocation(core, pc, &elfSupport, &locations);
-    loop->loopCount = count;
+      file.read((char*)&pc, sizeof(uint64_t));
+      file.read((char*)&count, sizeof(uint64_t));
+      loops.push_back(std::make_pair(pc, count));
+    }
+
+    while(!file.atEnd()) {
+      struct rawarc arc;
+      file.read((char*)&arc, sizeof(struct rawarc));
+      arcs.push_back(std::make_pair(core, arc));
+    }
   }
 
-  while(!file.atEnd()) {
-    struct rawarc arc;
-    file.read((char*)&arc, sizeof(struct rawarc));
+  // locations of each core with loops or arcs in the file.  All are read from the database before any
+  // new location is made, since reading them resets the location IDs
+  std::map<unsigned,std::map<BasicBlock*,Location*>> locations;
+  getLocations(core, &locations[core]);
+  for(auto coreArc : arcs) {
+    if(locations.find(coreArc.first) == locations.end()) {
+      getLocations(coreArc.first, &locations[coreArc.first]);
+    }
+  }
 
-    Location *from = getLocation(core, arc.raw_frompc-4, &elfSupport, &locations);
-    Location *self = getLocation(core, arc.raw_selfpc, &elfSupport, &locations);
+  for(auto loopCount : loops) {
+    Location *loop = getLocation(core, loopCount.first, &elfSupport, &locations[core]);
+    loop->loopCount = loopCount.second;
+  }
+
+  for(auto coreArc : arcs) {
+    unsigned arcCore = coreArc.first;
+    struct rawarc &arc = coreArc.second;
+
+    Location *from = getLocation(arcCore, arc.raw_frompc-4, &elfSupport, &locations[arcCore]);
+    Location *self = getLocation(arcCore, arc.raw_selfpc, &elfSupport, &locations[arcCore]);
 
     if(!from->bb->containsFunctionCall(self->bb->getFunction())) {
       printf("Warning: Can't find arc %s:%s:%s - %s\n",
@@ -829,61 +1128,63 @@ bool Project::parseGProfFile(QString gprofFileName, QString elfFileName) {
     self->addCaller(from->id, arc.raw_count);
   }
 
-  for(auto location : locations) {
-    if(!location.second->inDb) {
-      QSqlQuery query(db);
-
-      query.prepare("INSERT INTO location (id,core,basicblock,function,module,runtime,energy1,energy2,energy3,energy4,energy5,energy6,energy7,loopcount) "
-                    "VALUES (:id,:core,:basicblock,:function,:module,:runtime,:energy1,:energy2,:energy3,:energy4,:energy5,:energy6,:energy7,:loopcount)");
-
-      query.bindValue(":id", location.second->id);
-      query.bindValue(":core", core);
-      query.bindValue(":basicblock", location.second->bbId);
-      query.bindValue(":function", location.second->funcId);
-      query.bindValue(":module", location.second->moduleId);
-      query.bindValue(":runtime", location.second->runtime);
-      query.bindValue(":energy1", location.second->energy[0]);
-      query.bindValue(":energy2", location.second->energy[1]);
-      query.bindValue(":energy3", location.second->energy[2]);
-      query.bindValue(":energy4", location.second->energy[3]);
-      query.bindValue(":energy5", location.second->energy[4]);
-      query.bindValue(":energy6", location.second->energy[5]);
-      query.bindValue(":energy7", location.second->energy[6]);
-      query.bindValue(":loopcount", (qulonglong)location.second->loopCount);
-
-      bool success = query.exec();
-      Q_UNUSED(success);
-      assert(success);
-    } else {
-      QSqlQuery query(db);
+  for(auto coreIt : locations) {
+    for(auto location : coreIt.second) {
+      if(!location.second->inDb) {
+        QSqlQuery query(db);
 
-      query.prepare("UPDATE location SET loopcount=:loopcount WHERE id=:id");
+        query.prepare("INSERT INTO location (id,core,basicblock,function,module,runtime,energy1,energy2,energy3,energy4,energy5,energy6,energy7,loopcount) "
+                      "VALUES (:id,:core,:basicblock,:function,:module,:runtime,:energy1,:energy2,:energy3,:energy4,:energy5,:energy6,:energy7,:loopcount)");
 
-      query.bindValue(":loopcount", (qulonglong)location.second->loopCount);
-      query.bindValue(":id", location.second->id);
+        query.bindValue(":id", location.second->id);
+        query.bindValue(":core", coreIt.first);
+        query.bindValue(":basicblock", location.second->bbId);
+        query.bindValue(":function", location.second->funcId);
+        query.bindValue(":module", location.second->moduleId);
+        query.bindValue(":runtime", location.second->runtime);
+        query.bindValue(":energy1", location.second->energy[0]);
+        query.bindValue(":energy2", location.second->energy[1]);
+        query.bindValue(":energy3", location.second->energy[2]);
+        query.bindValue(":energy4", location.second->energy[3]);
+        query.bindValue(":energy5", location.second->energy[4]);
+        query.bindValue(":energy6", location.second->energy[5]);
+        query.bindValue(":energy7", location.second->energy[6]);
+        query.bindValue(":loopcount", (qulonglong)location.second->loopCount);
 
-      bool success = query.exec();
-      Q_UNUSED(success);
-      assert(success);
-    }
+        bool success = query.exec();
+        Q_UNUSED(success);
+        assert(success);
+      } else {
+        QSqlQuery query(db);
 
-    for(auto it : location.second->callers) {
-      QSqlQuery arcQuery(db);
-      int caller = it.first;
-      int count =  it.second;
+        query.prepare("UPDATE location SET loopcount=:loopcount WHERE id=:id");
 
-      arcQuery.prepare("INSERT INTO arc (fromid,selfid,num) VALUES (:fromid,:selfid,:num)");
+        query.bindValue(":loopcount", (qulonglong)location.second->loopCount);
+        query.bindValue(":id", location.second->id);
 
-      arcQuery.bindValue(":fromid", caller);
-      arcQuery.bindValue(":selfid", location.second->id);
-      arcQuery.bindValue(":num", count);
+        bool success = query.exec();
+        Q_UNUSED(success);
+        assert(success);
+      }
 
-      bool success = arcQuery.exec();
-      Q_UNUSED(success);
-      assert(success);
-    }
+      for(auto it : location.second->callers) {
+        QSqlQuery arcQuery(db);
+        int caller = it.first;
+        int count =  it.second;
 
-    delete location.second;
+        arcQuery.prepare("INSERT INTO arc (fromid,selfid,num) VALUES (:fromid,:selfid,:num)");
+
+        arcQuery.bindValue(":fromid", caller);
+        arcQuery.bindValue(":selfid", location.second->id);
+        arcQuery.bindValue(":num", count);
+
+        bool success = arcQuery.exec();
+        Q_UNUSED(success);
+        assert(success);
+      }
+
+      delete location.second;
+    }
   }
 
   db.commit();
@@ -896,7 +1197,7 @@ bool Project::parseProfFile(QString fileName) {
   QSqlQuery query(db);
 
   ElfSupport elfSupport;
-  if(isSdSocProject()) elfSupport.addElf(elfFilename());
+  if(isSdSocProject()) elfSupport.addElf(buildPath(elfFilename()));
   for(auto ef : customElfFile.split(',')) {
     elfSupport.addElf(ef);
   }
@@ -909,6 +1210,21 @@ bool Project::parseProfFile(QString fileName) {
     return false;
   }
 
+  // the compact version starts with a magic byte, the original with the core number
+  uint8_t magic = 0;
+  uint8_t version = 0;
+  file.peek((char*)&magic, sizeof(uint8_t));
+  if(magic == PROFMAGIC) {
+    file.read((char*)&magic, sizeof(uint8_t));
+    file.read((char*)&version, sizeof(uint8_t));
+    if(version != PROFVERSION) {
+      QMessageBox msgBox;
+      msgBox.setText("Unsupported profile file version");
+      msgBox.exec();
+      return false;
+    }
+  }
+
   profile->clean();
 
   std::map<BasicBlock*,Location*> locations;
@@ -969,14 +1285,30 @@ bool Project::parseProfFile(QString fileName) {
   double totalRuntime = 0;
   double totalEnergy[LYNSYN_SENSORS] = {0, 0, 0, 0, 0, 0, 0};
 
+  QByteArray data;
+  const uint8_t *pos = NULL;
+  const uint8_t *end = NULL;
+  if(version) {
+    data = file.readAll();
+    pos = (const uint8_t*)data.constData();
+    end = pos + data.size();
+  }
+
+  uint64_t pc = 0;
+
   for(uint32_t i = 0; i < count; i++) {
-    uint64_t pc;
     double power;
     double runtime;
 
-    file.read((char*)&pc, sizeof(uint64_t));
-    file.read((char*)&power, sizeof(double));
-    file.read((char*)&runtime, sizeof(double));
+    if(version) {
+      pc += readVarint(pos, end);
+      runtime = readVarint(pos, end) * period;
+      power = readDouble(pos, end);
+    } else {
+      file.read((char*)&pc, sizeof(uint64_t));
+      file.read((char*)&power, sizeof(double));
+      file.read((char*)&runtime, sizeof(double));
+    }
 
     Location *location = getLocation(core, pc, &elfSupport, &locations);
 
@@ -1070,14 +1402,14 @@ bool Project::runProfiler() {
   QSqlDatabase db;
   {
     db = QSqlDatabase::addDatabase("QSQLITE", dbConnection);
-    db.setDatabaseName("profile.db3");
+    db.setDatabaseName(buildPath("profile.db3"));
     bool success = db.open();
     Q_UNUSED(success);
     assert(success);
   }
 
   ElfSupport elfSupport;
-  if(isSdSocProject()) elfSupport.addElf(elfFilename());
+  if(isSdSocProject()) elfSupport.addElf(buildPath(elfFilename()));
   for(auto ef : customElfFile.split(',')) {
     elfSupport.addElf(ef);
   }
@@ -1095,7 +1427,7 @@ bool Project::runProfiler() {
     emit advance(0, "Uploading binary");
 
     // upload binaries
-    QFile tclFile("temp-pmu-prof.tcl");
+    QFile tclFile(buildPath("temp-pmu-prof.tcl"));
     bool success = tclFile.open(QIODevice::WriteOnly);
     Q_UNUSED(success);
     assert(success);
@@ -1112,7 +1444,7 @@ bool Project::runProfiler() {
 
     tclFile.close();
 
-    int ret = system("xsct temp-pmu-prof.tcl");
+    int ret = runCommand("xsct temp-pmu-prof.tcl");
     if(ret) {
       emit finished(1, "Can't upload binaries");
       pmu.release();
@@ -1158,7 +1490,8 @@ bool Project::runProfiler() {
     bool ret = pmu.collectSamples(runTcf, runTcf,
                                   frameAddr, runTcf, stopAt, samplePc, samplingModeGpio, 
                                   Pmu::secondsToCycles(samplePeriod), startAddr, stopAddr,
-                                  &samples, &minTime, &maxTime, minPower, maxPower, &runtime, energy);
+                                  &samples, &minTime, &maxTime, minPower, maxPower, &runtime, energy,
+                                  buildPath("profile.db3"), abortLimit, abortSensor, &aborted);
     if(!ret) {
       emit finished(1, "Invalid profile settings for PMU firmware version, upgrade firmware");
       pmu.release();
@@ -1168,6 +1501,29 @@ bool Project::runProfiler() {
 
   pmu.release();
 
+  if(aborted) {
+    // the application is still running, reset the target
+    if(runTcf) {
+      QFile tclFile(buildPath("temp-pmu-reset.tcl"));
+      bool success = tclFile.open(QIODevice::WriteOnly);
+      Q_UNUSED(success);
+      assert(success);
+
+      if(ultrascale) {
+        tclFile.write("connect\ntargets -set -nocase -filter {name =~\"APU*\"} -index 1\nrst -system\n");
+      } else {
+        tclFile.write("connect\ntargets -set -nocase -filter {name =~\"ARM*#0\"} -index 0\nrst -system\n");
+      }
+
+      tclFile.close();
+
+      runCommand("xsct temp-pmu-reset.tcl");
+    }
+
+    emit finished(0, "Profiling stopped, limit exceeded");
+    return false;
+  }
+
   int64_t frameRuntimeMin = 0;
   int64_t frameRuntimeMax = 0;
   int64_t frameRuntimeAvg = 0;
@@ -1477,7 +1833,7 @@ bool Project::runApp() {
   emit advance(0, "Uploading binary");
 
   // upload binaries
-  QFile tclFile("temp-pmu-prof.tcl");
+  QFile tclFile(buildPath("temp-pmu-prof.tcl"));
   bool success = tclFile.open(QIODevice::WriteOnly);
   Q_UNUSED(success);
   assert(success);
@@ -1488,7 +1844,7 @@ bool Project::runApp() {
 
   tclFile.close();
 
-  int ret = system("xsct temp-pmu-prof.tcl");
+  int ret = runCommand("xsct temp-pmu-prof.tcl");
   if(ret) {
     emit finished(1, "Can't upload binaries");
     return false;
@@ -49,6 +49,15 @@ protected:
 
   void writeTulippCompileRule(QString compiler, QFile &makefile, QString path, QString opt);
   void writeCleanRule(QFile &makefile);
+  void writeDependencyIncludes(QFile &makefile);
+  void writeCacheVariable(QFile &makefile);
+  QString cachedRecipe(QString command, QString outputs, QString hashInput = "cat $^");
+  void trimBuildCache();
+  QString toolFingerprint();
+  int runCommand(QString command);
+  int runMake(QString target, QStringList progressTargets, int firstStep);
+  QStringList sourceTargets(QString suffix);
+  QStringList binaryTargets();
 
   bool createXmlMakefile();
   virtual bool createMakefile(QFile &makefile);
@@ -85,6 +94,7 @@ public:
 
   QString cmakeArgs;
   bool instrument;
+  bool loopCounters;
   bool createBbInfo;
 
   // settings from either sdsoc project or user
@@ -105,6 +115,14 @@ public:
 
   QString customElfFile;
 
+  // directory where build and profile files are placed, current directory if empty
+  QString buildDir;
+
+  // profiling stops when the runtime (sensor -1) or the energy of the sensor exceeds the limit, 0 means never
+  double abortLimit;
+  int abortSensor;
+  bool aborted;
+
   Cfg *cfg;
 
   int errorCode;
@@ -120,7 +138,7 @@ public:
   bool cleanBin();
 
   virtual void print();
-  int runSourceTool(QString inputFilename, QString outputFilename, QStringList loopsToPipeline, QString opt);
+  int runSourceTool(QString inputFilename, QString outputFilename, QStringList transformations, QString opt);
 
   QString elfFilename(bool instr) {
     if(instr) {
@@ -134,18 +152,23 @@ public:
     return elfFilename(instrument);
   }
 
+  QString buildPath(QString filename) {
+    if(buildDir == "") return filename;
+    return buildDir + "/" + filename;
+  }
+
   bool parseProfFile(QString fileName);
   bool parseGProfFile(QString gprofFileName, QString elfFileName);
 
-  void loadFiles();
+  virtual void loadFiles();
   void loadXmlFile(const QString &fileName);
   void loadProjectFile();
   void saveProjectFile();
 
   int cmakeSteps() { return 1; }
   int makeSteps() { return 1; }
-  int xmlBuildSteps() { return 1; }
-  int binBuildSteps() { return 2; }
+  int xmlBuildSteps() { return sourceTargets(".xml").size() + 1; }
+  int binBuildSteps() { return xmlBuildSteps() + binaryTargets().size() + 1; }
   int profileSteps() { return 3; }
   int runSteps() { return 1; }
 
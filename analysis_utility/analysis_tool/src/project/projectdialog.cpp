@@ -100,6 +100,9 @@ ProjectBuildPage::ProjectBuildPage(Project *project, QWidget *parent) : QWidget(
     instrumentCheckBox = new QCheckBox("Instrument");
     instrumentCheckBox->setCheckState(project->instrument ? Qt::Checked : Qt::Unchecked);
 
+    loopCountersCheckBox = new QCheckBox("Count loop iterations inline (no runtime calls)");
+    loopCountersCheckBox->setCheckState(project->loopCounters ? Qt::Checked : Qt::Unchecked);
+
     QLabel *optLabel = new QLabel("CFG view optimization level:");
 
     optCombo = new QComboBox;
@@ -124,6 +127,7 @@ ProjectBuildPage::ProjectBuildPage(Project *project, QWidget *parent) : QWidget(
 
     QVBoxLayout *compLayout = new QVBoxLayout;
     compLayout->addWidget(instrumentCheckBox);
+    compLayout->addWidget(loopCountersCheckBox);
     compLayout->addLayout(optLayout);
     compLayout->addWidget(createBbInfoCheckBox);
 
@@ -430,6 +434,7 @@ void ProjectDialog::closeEvent(QCloseEvent *e) {
     }
 
     project->instrument = buildPage->instrumentCheckBox->checkState() == Qt::Checked;
+    project->loopCounters = buildPage->loopCountersCheckBox->checkState() == Qt::Checked;
 
     project->createBbInfo = buildPage->createBbInfoCheckBox->checkState() == Qt::Checked;
   }
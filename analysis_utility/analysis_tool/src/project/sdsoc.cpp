@@ -20,8 +20,14 @@
  *****************************************************************************/
 
 #include "sdsoc.h"
+#include "cfg/module.h"
+#include "cfg/function.h"
+#include "cfg/loop.h"
 
 #include <QProcess>
+#include <QRegularExpression>
+
+#include <algorithm>
 
 Sdsoc *Sdsoc::createSdsoc(unsigned version, Profile *profile) {
   switch(version) {
@@ -127,30 +133,51 @@ void Sdsoc::print() {
   printf("C++ system includes: %s\n", cppSysInc.toUtf8().constData());
 }
 
+QStringList Sdsoc::getAcceleratorFiles(ProjectAcc &acc) {
+  QStringList files;
+
+  QFileInfo info(acc.filepath);
+  Module *mod = cfg->getModuleById(info.completeBaseName());
+  if(mod) {
+    QVector<Function*> funcs = mod->getFunctionsByName(acc.name);
+    if(funcs.size() > 0) {
+      files = funcs[0]->getSourceHierarchy(QVector<BasicBlock*>());
+      files.removeAll(acc.filepath);
+    }
+  }
+
+  return files;
+}
+
+QStringList Sdsoc::getSdsHwSources() {
+  QStringList sources;
+
+  for(auto acc : accelerators) {
+    sources << acc.filepath << getAcceleratorFiles(acc);
+  }
+
+  sources.removeDuplicates();
+  return sources;
+}
+
 QStringList Sdsoc::getSdsHwOptions() {
   QStringList options;
 
   for(auto acc : accelerators) {
     options << "-sds-hw" << acc.name << acc.filepath;
 
-    QFileInfo info(acc.filepath);
-    Module *mod = cfg->getModuleById(info.completeBaseName());
-    QVector<Function*> funcs = mod->getFunctionsByName(acc.name);
-    if(funcs.size() > 0) {
-      QStringList files = funcs[0]->getSourceHierarchy(QVector<BasicBlock*>());
-      files.removeAll(acc.filepath);
-      if(files.size()) {
-        options << "-files";
-
-        QString filelist;
-        bool first = true;
-        for(auto file : files) {
-          if(!first) filelist += ",";
-          filelist += file;
-          first = false;
-        }
-        options << filelist;
+    QStringList files = getAcceleratorFiles(acc);
+    if(files.size()) {
+      options << "-files";
+
+      QString filelist;
+      bool first = true;
+      for(auto file : files) {
+        if(!first) filelist += ",";
+        filelist += file;
+        first = false;
       }
+      options << filelist;
     }
 
     options << "-clkid" << QString::number(acc.clkid) << "-sds-end";
@@ -196,7 +223,14 @@ void Sdsoc::writeSdsLinkRule(QString linker, QFile &makefile, QStringList object
   } else {
     makefile.write((name + ".elf : " + objects.join(' ') + "\n").toUtf8());
   }
-  makefile.write((QString("\t") + linker + " " + options.join(' ') + " $^ " + linkerOptions + " -o $@\n\n").toUtf8());
+  // the link runs HLS and creates the bitstream, so cache everything it produces that is used later.
+  // HLS reads the accelerator sources directly, and DSE puts the loop pragmas into them, so they are
+  // part of the key together with the objects
+  QStringList hashInput;
+  hashInput << "cat $^" << getSdsHwSources();
+  makefile.write(cachedRecipe(linker + " " + options.join(' ') + " $^ " + linkerOptions + " -o $@",
+                              "$@ $@.bit sd_card _sds/reports _sds/vhls",
+                              hashInput.join(' ')).toUtf8());
 
   makefile.write(QString("###############################################################################\n\n").toUtf8());
 }
@@ -359,8 +393,9 @@ bool Sdsoc::openProject(QString path, QString configType, bool fast) {
     dir.mkpath(".");
   }
 
-  // cd
+  // cd, the shell commands below expect to run in the project dir
   QDir::setCurrent(dir.path());
+  buildDir = dir.absolutePath();
 
   // get system includes
   // TODO: This slows down startup, and is not very elegant.  Can we do it differently, or cache results?
@@ -397,6 +432,136 @@ bool Sdsoc::openProject(QString path, QString configType, bool fast) {
   return true;
 }
 
+static int64_t getHlsValue(QDomElement element) {
+  bool ok;
+  int64_t value = element.text().trimmed().toLongLong(&ok);
+  return ok ? value : -1;
+}
+
+static void getHlsRange(QDomElement element, int64_t *min, int64_t *max) {
+  QDomElement range = element.firstChildElement("range");
+  if(!range.isNull()) {
+    *min = getHlsValue(range.firstChildElement("min"));
+    *max = getHlsValue(range.firstChildElement("max"));
+  } else {
+    *min = *max = getHlsValue(element);
+  }
+}
+
+void Sdsoc::parseHlsReports() {
+  if(!cfg) return;
+
+  for(auto acc : accelerators) {
+    QDirIterator dirIt(buildPath("_sds/vhls/" + acc.name), QStringList() << "*csynth.xml",
+                       QDir::Files, QDirIterator::Subdirectories);
+    while(dirIt.hasNext()) {
+      parseHlsReport(dirIt.next());
+    }
+  }
+}
+
+void Sdsoc::parseHlsReport(QString filename) {
+  QDomDocument doc;
+  QFile file(filename);
+
+  if(!file.open(QIODevice::ReadOnly)) return;
+  bool success = doc.setContent(&file);
+  file.close();
+  if(!success) return;
+
+  QDomElement root = doc.documentElement();
+  QString top = root.firstChildElement("UserAssignments").firstChildElement("TopModelName").text().trimmed();
+  QDomElement performance = root.firstChildElement("PerformanceEstimates");
+  QDomElement latency = performance.firstChildElement("SummaryOfOverallLatency");
+  QDomElement resources = root.firstChildElement("AreaEstimates").firstChildElement("Resources");
+
+  for(auto child : cfg->children) {
+    if(child == cfg->externalMod) continue;
+
+    Module *module = static_cast<Module*>(child);
+
+    for(auto funcChild : module->children) {
+      Function *func = static_cast<Function*>(funcChild);
+
+      if((func->name == top) || (func->name.split("::").last() == top)) {
+        func->hls.valid = true;
+        func->hls.latencyMin = getHlsValue(latency.firstChildElement("Best-caseLatency"));
+        func->hls.latencyMax = getHlsValue(latency.firstChildElement("Worst-caseLatency"));
+        func->hls.brams = resources.firstChildElement("BRAM_18K").text().toDouble();
+        func->hls.luts = resources.firstChildElement("LUT").text().toDouble();
+        func->hls.dsps = resources.firstChildElement("DSP48E").text().toDouble();
+        func->hls.regs = resources.firstChildElement("FF").text().toDouble();
+
+        parseHlsLoops(func, performance.firstChildElement("SummaryOfLoopLatency"));
+      }
+    }
+  }
+}
+
+// the label of a loop is written before the loop statement, on the same or the previous line
+static QString getLoopLabel(Loop *loop) {
+  static const QRegularExpression labelRe("(^|[^:])\\b([A-Za-z_][A-Za-z0-9_]*)\\s*:\\s*$");
+
+  QString filename = loop->getSourceFilename();
+  QString before = getLine(filename, loop->sourceLineNumber, 1).left(loop->sourceColumn - 1);
+  if((before.trimmed() == "") && (loop->sourceLineNumber > 1)) {
+    before = getLine(filename, loop->sourceLineNumber - 1, 1);
+  }
+
+  QRegularExpressionMatch match = labelRe.match(before);
+  if(match.hasMatch() && (match.captured(2) != "default")) return match.captured(2);
+
+  return "";
+}
+
+void Sdsoc::parseHlsLoops(Container *container, QDomElement summary) {
+  // HLS names a loop by its label.  Unlabeled loops are named Loop N (Loop N.M when nested), where N
+  // is the position of the loop among the loops at the same level, so they are matched by position
+  // in source order.  Loops that are not found in the report get no HLS data
+  static const QRegularExpression indexRe("^Loop[ _]?(?:[0-9]+\\.)*([0-9]+)$");
+
+  QVector<Loop*> loops;
+  container->getAllLoops(loops, QVector<BasicBlock*>(), false);
+  std::sort(loops.begin(), loops.end(), [](Loop *a, Loop *b) {
+      if(a->sourceLineNumber != b->sourceLineNumber) return a->sourceLineNumber < b->sourceLineNumber;
+      return a->sourceColumn < b->sourceColumn;
+    });
+
+  QMap<QString,Loop*> labeled;
+  for(auto loop : loops) {
+    QString label = getLoopLabel(loop);
+    if(label != "") labeled[label] = loop;
+  }
+
+  for(QDomElement element = summary.firstChildElement(); !element.isNull(); element = element.nextSiblingElement()) {
+    // anything else than a loop has no latency
+    if(element.firstChildElement("Latency").isNull()) continue;
+
+    QString name = element.tagName();
+
+    Loop *loop = labeled.value(name, NULL);
+    if(!loop) {
+      QRegularExpressionMatch match = indexRe.match(name);
+      if(match.hasMatch()) {
+        int n = match.captured(1).toInt() - 1;
+        if((n >= 0) && (n < loops.size()) && (getLoopLabel(loops[n]) == "")) loop = loops[n];
+      }
+    }
+
+    if(!loop) continue;
+
+    loop->hls.valid = true;
+    getHlsRange(element.firstChildElement("TripCount"), &loop->hls.tripCountMin, &loop->hls.tripCountMax);
+    getHlsRange(element.firstChildElement("Latency"), &loop->hls.latencyMin, &loop->hls.latencyMax);
+    loop->hls.iterationLatency = getHlsValue(element.firstChildElement("IterationLatency"));
+
+    // not pipelined if there is no numeric II
+    loop->hls.ii = std::max(getHlsValue(element.firstChildElement("PipelineII")), (int64_t)0);
+
+    parseHlsLoops(loop, element);
+  }
+}
+
 QString Sdsoc::processIncludePaths(QString filename) {
   QString options;
 
@@ -661,7 +826,7 @@ QStringList Sdsoc::getBuildConfigurations(QString path) {
 bool Sdsoc::createMakefile() {
   QStringList objects;
 
-  QFile makefile("Makefile");
+  QFile makefile(buildPath("Makefile"));
   bool success = makefile.open(QIODevice::WriteOnly);
   if(!success) {
     QMessageBox msgBox;
@@ -758,7 +923,7 @@ bool Sdsoc::createMakefile() {
 }
 
 void Sdsoc20162::parseSynthesisReport() {
-  QFile file("_sds/reports/sds.rpt");
+  QFile file(buildPath("_sds/reports/sds.rpt"));
 
   if(file.open(QIODevice::ReadOnly)) {
     QTextStream in(&file);
@@ -865,7 +1030,7 @@ void Sdsoc20172::writeSdsLinkRule(QString linker, QFile &makefile, QStringList o
 }
 
 void Sdsoc20172::parseSynthesisReport() {
-  QFile file("_sds/reports/sds.rpt");
+  QFile file(buildPath("_sds/reports/sds.rpt"));
 
   if(file.open(QIODevice::ReadOnly)) {
     QTextStream in(&file);
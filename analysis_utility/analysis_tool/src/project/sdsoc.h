@@ -44,10 +44,14 @@ protected:
   QString processLinkerOptions(QDomElement &childElement);
   QString processIncludePaths(QString filename);
   virtual void parseSynthesisReport() = 0;
+  void parseHlsReport(QString filename);
+  void parseHlsLoops(Container *container, QDomElement summary);
   virtual bool getPlatformOptions();
   virtual bool getProjectOptions() = 0;
   virtual void writeSdsRule(QString compiler, QFile &makefile, QString path, QString opt);
   virtual void writeSdsLinkRule(QString linker, QFile &makefile, QStringList objects, QString opt = "");
+  QStringList getAcceleratorFiles(ProjectAcc &acc);
+  QStringList getSdsHwSources();
   QStringList getSdsHwOptions();
   virtual QString defaultOptions() { return "-MMD -MP"; }
   virtual QString defaultOther() { return "-fmessage-length=0 -MT\"$@\""; }
@@ -71,10 +75,21 @@ public:
 
   bool makeBin() {
     bool ret = Project::makeBin();
-    if(ret) parseSynthesisReport();
+    if(ret) {
+      parseSynthesisReport();
+      parseHlsReports();
+    }
     return ret;
   }
 
+  void loadFiles() {
+    Project::loadFiles();
+    parseHlsReports();
+  }
+
+  // attaches the HLS estimates of all accelerators to the functions and loops in the CFG
+  void parseHlsReports();
+
   bool getTimingOk() const { return timingOk; }
   double getBrams() const { return brams; }
   double getLuts() const { return luts; }
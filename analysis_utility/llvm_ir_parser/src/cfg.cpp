@@ -27,6 +27,8 @@ int bbCounter = 1;
 int regCounter = 1;
 int loopCounter = 1;
 
+bool loopCounters = false;
+
 ///////////////////////////////////////////////////////////////////////////////
 
 std::vector<BbNode*> Node::getAllBasicBlocks() {
@@ -127,12 +129,18 @@ std::vector<BasicBlock*> Node::getAllBbs() {
 
 ModuleNode::ModuleNode(Module *mod) : Node(NULL) {
   this->mod = mod;
+  counters = NULL;
+
+  // the loop nodes are created by the function nodes, so the loops of this module get a contiguous range of IDs
+  firstLoopId = loopCounter;
 
   for(auto &func : mod->functions()) {
     if(!func.isIntrinsic() && func.getBasicBlockList().size() > 0) {
       children.push_back(new FunctionNode(&func, this));
     }
   }
+
+  numLoops = loopCounter - firstLoopId;
 }
 
 void ModuleNode::printXML(FILE *fp) {
@@ -158,6 +166,49 @@ void ModuleNode::printXML(FILE *fp) {
   fprintf(fp, "</module>\n");
 }
 
+void ModuleNode::instrument() {
+  Node::instrument();
+
+  if(loopTable.size()) {
+    LLVMContext &C = mod->getContext();
+
+    Type *EntryTypes[] = {Type::getInt8PtrTy(C), Type::getInt64PtrTy(C)};
+    StructType *EntryTy = StructType::get(C, makeArrayRef(EntryTypes));
+    ArrayType *TableTy = ArrayType::get(EntryTy, loopTable.size());
+
+    GlobalVariable *table = new GlobalVariable(*mod, TableTy, true, GlobalValue::InternalLinkage,
+                                               ConstantArray::get(TableTy, loopTable), "__tulipp_loop_table");
+    table->setSection(LOOP_TABLE_SECTION);
+
+    // nothing references the table except the runtime, through the section symbols
+    GlobalValue *Used[] = {table};
+    appendToUsed(*mod, Used);
+  }
+}
+
+Constant *ModuleNode::getLoopCounter(int loopId) {
+  LLVMContext &C = mod->getContext();
+
+  // one 64 bit counter per loop of this module, indexed by the loop ID relative to the first loop of the module
+  if(!counters) {
+    ArrayType *CountersTy = ArrayType::get(Type::getInt64Ty(C), numLoops);
+    counters = new GlobalVariable(*mod, CountersTy, false, GlobalValue::InternalLinkage,
+                                  ConstantAggregateZero::get(CountersTy), "__tulipp_loop_counters");
+  }
+
+  assert((loopId >= firstLoopId) && (loopId < firstLoopId + numLoops));
+
+  Constant *Indices[] = {ConstantInt::get(Type::getInt32Ty(C), 0), ConstantInt::get(Type::getInt32Ty(C), loopId - firstLoopId)};
+
+  return ConstantExpr::getInBoundsGetElementPtr(counters->getValueType(), counters, Indices);
+}
+
+void ModuleNode::addLoopTableEntry(Constant *address, Constant *counter) {
+  Type *EntryTypes[] = {address->getType(), counter->getType()};
+  Constant *Fields[] = {address, counter};
+  loopTable.push_back(ConstantStruct::get(StructType::get(mod->getContext(), makeArrayRef(EntryTypes)), Fields));
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 void getAllLoops(Loop *loop, std::vector<Loop*> &loops) {
@@ -588,6 +639,25 @@ void LoopNode::printXML(FILE *fp) {
 void LoopNode::instrument() {
   Node::instrument();
 
+  // every loop gets a counter and an entry in the loop table, which maps the counter
+  // to the latch address when the profile is written
+  BasicBlock *bbLatch = loop->getLoopLatch();
+  LLVMContext &C = bbLatch->getContext();
+
+  ModuleNode *top = static_cast<ModuleNode*>(getTop());
+  Constant *counter = top->getLoopCounter(id);
+
+  top->addLoopTableEntry(ConstantExpr::getBitCast(BlockAddress::get(getFunc()->func, bbLatch), Type::getInt8PtrTy(C)),
+                         counter);
+
+  if(loopCounters) {
+    // the latch increments the loop counter inline, the header is left alone
+    IRBuilder<> Builder(&*bbLatch->getFirstInsertionPt());
+    Builder.SetCurrentDebugLocation(bbLatch->getFirstNonPHIOrDbgOrLifetime()->getDebugLoc());
+    Builder.CreateAtomicRMW(AtomicRMWInst::Add, counter, Builder.getInt64(1), AtomicOrdering::Monotonic);
+    return;
+  }
+
   {
     StringRef Func = "__tulipp_loop_header";
     BasicBlock *bbHeader = loop->getHeader();
@@ -609,20 +679,19 @@ void LoopNode::instrument() {
   }
 
   {
-    StringRef Func = "__tulipp_loop_body";
-    BasicBlock *bbLatch = loop->getLoopLatch();
+    // the runtime increments the counter while profiling is on
+    StringRef Func = "__tulipp_loop_count";
     Instruction *InsertionPt = &(*bbLatch->getFirstInsertionPt());
 
     Module &M = *InsertionPt->getParent()->getParent()->getParent();
-    LLVMContext &C = InsertionPt->getParent()->getContext();
 
     DebugLoc DL = bbLatch->getFirstNonPHIOrDbgOrLifetime()->getDebugLoc();
 
-    Type *ArgTypes[] = {Type::getInt8PtrTy(C)};
+    Type *ArgTypes[] = {Type::getInt64PtrTy(C)};
  
     Constant *Fn = M.getOrInsertFunction(Func, FunctionType::get(Type::getVoidTy(C), ArgTypes, false));
  
-    Value *Args[] = {ConstantExpr::getBitCast(BlockAddress::get(getFunc()->func, bbLatch), Type::getInt8PtrTy(C))};
+    Value *Args[] = {counter};
  
     CallInst *Call = CallInst::Create(Fn, ArrayRef<Value *>(Args), "", InsertionPt);
     Call->setDebugLoc(DL);
@@ -36,6 +36,7 @@
 #include "llvm/IR/Type.h"
 #include "llvm/IR/DIBuilder.h"
 #include "llvm/IR/Constants.h"
+#include "llvm/IR/IRBuilder.h"
 
 #include "llvm/IRReader/IRReader.h"
 
@@ -50,21 +51,54 @@
 #include "llvm/Analysis/DominanceFrontier.h"
 #include "llvm/Analysis/GlobalsModRef.h"
 
+#include "llvm/Transforms/Utils/ModuleUtils.h"
+
 #define NO_DUMP  0
 #define XML_DUMP 1
 #define LL_DUMP  2
+#define ALL_DUMP 3
+#define BBMAP_DUMP 4
+
+// BB map, one { address, module ID string, BB ID } record of pointer sized words for each
+// address range belonging to a BB.  The strings are in BBMAP_STR_SECTION.  Both sections are
+// not loaded on the target, the analysis tool reads them from the ELF file
+#define BBMAP_SECTION ".tulipp_bbmap"
+#define BBMAP_STR_SECTION ".tulipp_bbstr"
+#define BBMAP_MODULE_LABEL ".Ltulipp_bbmap_module"
+
+// metadata carrying the BB IDs from the CFG through opt, until the BB map is made
+#define BB_ID_MD "tulipp.bb"
+#define BB_MODULE_MD "tulipp.module"
+
+// section holding the loop table, { latch address, counter pointer } for each loop.
+// The runtime finds it through the linker generated __start_/__stop_ symbols
+#define LOOP_TABLE_SECTION "tulipp_loops"
 
 extern unsigned dumpType;
 
+// instrument loops with inline counter increments instead of calls to the runtime
+extern bool loopCounters;
+
 using namespace llvm;
 
+class RegNode;
+class BbNode;
+class FunctionNode;
+class ModuleNode;
+
 std::string demangle(std::string name);
 std::string xmlify(std::string text);
 std::string removeExtension(std::string filename);
+// writes bitcode if the filename ends with .bc, textual IR otherwise
+void printIR(Module *mod, std::string filename);
+void printXML(ModuleNode *top, std::string filename);
 
-class RegNode;
-class BbNode;
-class FunctionNode;
+// tags the instructions with their basic block IDs, the debug info is left alone
+void tagBbIds(Module *mod, ModuleNode *top);
+
+// inserts the BB map records, used for mapping PCs back to the CFG.  Runs after optimization,
+// so that the markers don't change what the optimizer does
+void insertBbMap(Module *mod);
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -142,6 +176,10 @@ public:
 
 class ModuleNode : public Node {
   Module *mod;
+  GlobalVariable *counters;
+  std::vector<Constant*> loopTable;
+  int firstLoopId;
+  int numLoops;
 
 public:
   ModuleNode(Module *mod);
@@ -149,6 +187,9 @@ public:
   void print() {
     printf("Module %s\n", mod->getName().str().c_str());
   }
+  void instrument();
+  Constant *getLoopCounter(int loopId);
+  void addLoopTableEntry(Constant *address, Constant *counter);
 };
 
 ///////////////////////////////////////////////////////////////////////////////
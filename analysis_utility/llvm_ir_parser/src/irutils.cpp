@@ -0,0 +1,173 @@
+/******************************************************************************
+ *
+ *  This file is part of the TULIPP Analysis Utility
+ *
+ *  Copyright 2018 Asbjørn Djupdal, NTNU, TULIPP EU Project
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *****************************************************************************/
+
+#include "llvm/Config/llvm-config.h"
+#include "llvm/Bitcode/BitcodeWriter.h"
+#include "llvm/IR/InlineAsm.h"
+#include "llvm/Support/Path.h"
+
+#include "cfg.h"
+
+using namespace llvm;
+
+std::string demangle(std::string name) {
+  int status = -4;
+
+  std::unique_ptr<char, void(*)(void*)> res {
+    abi::__cxa_demangle(name.c_str(), NULL, NULL, &status),
+      std::free
+      };
+
+  std::string text = name;
+
+  if(status==0) {
+    text = res.get();
+  }
+
+  return text;
+}
+
+std::string removeExtension(std::string filename) {
+  size_t lastDot = filename.find_last_of(".");
+  if (lastDot == std::string::npos) return filename;
+  return filename.substr(0, lastDot); 
+}
+
+std::string xmlify(std::string text) {
+  text = std::regex_replace(text, std::regex("<"), "&lt;");
+  text = std::regex_replace(text, std::regex(">"), "&gt;");
+  text = std::regex_replace(text, std::regex("&"), "&amp;");
+  text = std::regex_replace(text, std::regex("\""), "&quot;");
+  text = std::regex_replace(text, std::regex("\'"), "&apos;");
+  return text;
+}
+
+void printIR(Module *mod, std::string filename) {
+  std::error_code err;
+  raw_fd_ostream ostream(filename, err, llvm::sys::fs::OpenFlags::F_None);
+
+  if(sys::path::extension(filename) == ".bc") {
+#if LLVM_VERSION_MAJOR >= 7
+    WriteBitcodeToFile(*mod, ostream);
+#else
+    WriteBitcodeToFile(mod, ostream);
+#endif
+    return;
+  }
+
+  PrintModulePass printer(ostream);
+  AnalysisManager<Module> dummy;
+  printer.run(*mod, dummy);
+}
+
+void printXML(ModuleNode *top, std::string filename) {
+  FILE *fp = fopen(filename.c_str(), "wb");
+  fprintf(fp, "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n");
+  top->printXML(fp);
+  fclose(fp);
+}
+
+void tagBbIds(Module *mod, ModuleNode *top) {
+  LLVMContext &C = mod->getContext();
+
+  std::string moduleName = removeExtension(mod->getName().str());
+
+  NamedMDNode *moduleMd = mod->getOrInsertNamedMetadata(BB_MODULE_MD);
+  moduleMd->addOperand(MDNode::get(C, MDString::get(C, moduleName)));
+
+  for(auto &func : mod->functions()) {
+    if(!func.isIntrinsic() && func.getBasicBlockList().size() > 0) {
+      for(auto &bb : func.getBasicBlockList()) {
+        for(auto &instr : bb) {
+          int id = top->getId(&instr);
+          if(id > 0) {
+            instr.setMetadata(BB_ID_MD, MDNode::get(C, ConstantAsMetadata::get(ConstantInt::get(Type::getInt32Ty(C), id))));
+          }
+        }
+      }
+    }
+  }
+}
+
+static unsigned getBbId(Instruction *instr) {
+  MDNode *md = instr->getMetadata(BB_ID_MD);
+  if(!md) return 0;
+  return mdconst::extract<ConstantInt>(md->getOperand(0))->getZExtValue();
+}
+
+void insertBbMap(Module *mod) {
+  NamedMDNode *moduleMd = mod->getNamedMetadata(BB_MODULE_MD);
+  if(!moduleMd || !moduleMd->getNumOperands()) return;
+
+  std::string moduleName = cast<MDString>(moduleMd->getOperand(0)->getOperand(0))->getString().str();
+
+  LLVMContext &C = mod->getContext();
+
+  unsigned pointerSize = mod->getDataLayout().getPointerSize();
+  std::string word = pointerSize == 8 ? ".quad " : ".long ";
+  std::string record = std::string(".pushsection " BBMAP_SECTION ",\"\"\n") + ".balign " + std::to_string(pointerSize) + "\n";
+
+  mod->appendModuleInlineAsm(std::string(".pushsection " BBMAP_STR_SECTION ",\"\"\n") +
+                             BBMAP_MODULE_LABEL ": .asciz \"" + moduleName + "\"\n" +
+                             ".popsection");
+
+  for(auto &func : mod->functions()) {
+    if(func.isDeclaration()) continue;
+
+    for(auto &bb : func) {
+      BasicBlock::iterator it = bb.getFirstInsertionPt();
+      if(it == bb.end()) continue;
+
+      // the block starts with the first BB ID found in it, instructions without an ID
+      // (made by the optimizer) belong to the BB ID in front of them
+      unsigned current = 0;
+      for(auto &instr : bb) {
+        current = getBbId(&instr);
+        if(current) break;
+      }
+      if(!current) continue;
+
+      for(; it != bb.end(); it++) {
+        unsigned id = getBbId(&*it);
+
+        if((it == bb.getFirstInsertionPt()) || (id && (id != current))) {
+          if(id) current = id;
+
+          // the entry record starts at the function symbol, so that the prologue is included
+          std::string address = "1f";
+          if((&bb == &func.getEntryBlock()) && (it == bb.getFirstInsertionPt()) && !func.hasPrivateLinkage()) {
+            address = std::regex_replace(func.getName().str(), std::regex("\\$"), "$$$$");
+          }
+
+          std::string text = record + word + address + "\n" + word + BBMAP_MODULE_LABEL "\n" + word + std::to_string(current) + "\n.popsection\n1:";
+          InlineAsm *marker = InlineAsm::get(FunctionType::get(Type::getVoidTy(C), false), text, "", true);
+          CallInst::Create(marker, "", &*it);
+        }
+      }
+
+      for(auto &instr : bb) {
+        instr.setMetadata(BB_ID_MD, NULL);
+      }
+    }
+  }
+
+  mod->eraseNamedMetadata(moduleMd);
+}
@@ -26,93 +26,18 @@
 using namespace llvm;
 
 static LLVMContext Context;
-static DIBuilder *diBuilder;
-static DIFile *diFile;
-static DICompileUnit *diUnit;
 
 ModuleNode *top = NULL;
 unsigned dumpType = NO_DUMP;
 
 ///////////////////////////////////////////////////////////////////////////////
 
-std::string demangle(std::string name) {
-  int status = -4;
-
-  std::unique_ptr<char, void(*)(void*)> res {
-    abi::__cxa_demangle(name.c_str(), NULL, NULL, &status),
-      std::free
-      };
-
-  std::string text = name;
-
-  if(status==0) {
-    text = res.get();
-  }
-
-  return text;
-}
-
-std::string removeExtension(std::string filename) {
-  size_t lastDot = filename.find_last_of(".");
-  if (lastDot == std::string::npos) return filename;
-  return filename.substr(0, lastDot); 
-}
-
-std::string xmlify(std::string text) {
-  text = std::regex_replace(text, std::regex("<"), "&lt;");
-  text = std::regex_replace(text, std::regex(">"), "&gt;");
-  text = std::regex_replace(text, std::regex("&"), "&amp;");
-  text = std::regex_replace(text, std::regex("\""), "&quot;");
-  text = std::regex_replace(text, std::regex("\'"), "&apos;");
-  return text;
-}
-
-void printIR(Module *mod, std::string filename) {
-  std::error_code err;
-  raw_fd_ostream ostream(filename, err, llvm::sys::fs::OpenFlags::F_None);
-  PrintModulePass printer(ostream);
-  AnalysisManager<Module> dummy;
-  printer.run(*mod, dummy);
-}
-
-void printXML(std::string filename) {
-  FILE *fp = fopen(filename.c_str(), "wb");
-  fprintf(fp, "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n");
-  top->printXML(fp);
-  fclose(fp);
-}
-
-void recreateDbInfo(Module *mod) {
-  StripDebugInfo(*mod);
-
-  std::string moduleName = removeExtension(mod->getName().str());
-
-  diBuilder = new DIBuilder(*mod);
-  diFile = diBuilder->createFile("@" + moduleName, "");
-  diUnit = diBuilder->createCompileUnit(dwarf::DW_LANG_C, diFile, "llvm_ir_parser", false, "", 0);
-
-  for(auto &func : mod->functions()) {
-    if(!func.isIntrinsic() && func.getBasicBlockList().size() > 0) {
-      unsigned entryBlockId = top->getId(&func.getEntryBlock());
-      std::string funcName = demangle(func.getName().str().c_str());
-      DISubroutineType *subRoutineType = diBuilder->createSubroutineType(DITypeRefArray());
-      DISubprogram *diSub = diBuilder->createFunction(diFile, funcName, func.getName(), diFile, entryBlockId, subRoutineType, false, true, entryBlockId);
-
-      for(auto &bb : func.getBasicBlockList()) {
-        for(auto &instr : bb) {
-          instr.setDebugLoc(DebugLoc::get(top->getId(&instr), 1, diSub));
-        }        
-      }
-
-      func.setSubprogram(diSub);
-      diBuilder->finalize();
-    }
-  }
-}
-
 int main(int argc, char* argv[]) {
   if (argc < 4) {
-    fprintf(stderr, "Usage: %s <input ir file> <-xml|-ll> <output file> [--instrument]\n", argv[0]);
+    fprintf(stderr, "Usage: %s <input ir file> <-xml|-ll> <output file> [--instrument [--loop-counters]]\n", argv[0]);
+    fprintf(stderr, "       %s <input ir file> -all <output xml file> <output ir file> [--instrument [--loop-counters]]\n", argv[0]);
+    fprintf(stderr, "       %s <input ir file> -bbmap <output ir file>\n", argv[0]);
+    fprintf(stderr, "IR files ending with .bc are bitcode, others are textual IR\n");
     exit(1);
   }
 
@@ -120,6 +45,16 @@ int main(int argc, char* argv[]) {
     dumpType = XML_DUMP;
   } else if(!strncmp("-ll", argv[2], 3)) {
     dumpType = LL_DUMP;
+  } else if(!strncmp("-all", argv[2], 4) && (argc >= 5)) {
+    dumpType = ALL_DUMP;
+  } else if(!strncmp("-bbmap", argv[2], 6)) {
+    dumpType = BBMAP_DUMP;
+  }
+
+  bool instrument = false;
+  for(int i = 4; i < argc; i++) {
+    if(!strcmp("--instrument", argv[i])) instrument = true;
+    if(!strcmp("--loop-counters", argv[i])) loopCounters = true;
   }
 
   SMDiagnostic Err;
@@ -130,20 +65,34 @@ int main(int argc, char* argv[]) {
     return 1;
   }
 
+  if(dumpType == BBMAP_DUMP) {
+    // the module is already optimized, the CFG is not needed
+    insertBbMap(mod.get());
+    printIR(mod.get(), argv[3]);
+    return 0;
+  }
+
   top = new ModuleNode(mod.get());
 
   switch(dumpType) {
 
     case XML_DUMP:
-      printXML(argv[3]);
+      printXML(top, argv[3]);
       break;
 
     case LL_DUMP:
-      recreateDbInfo(mod.get());
-      if(argc >= 5) top->instrument();
+      tagBbIds(mod.get(), top);
+      if(instrument) top->instrument();
       printIR(mod.get(), argv[3]);
       break;
 
+    case ALL_DUMP:
+      printXML(top, argv[3]);
+      tagBbIds(mod.get(), top);
+      if(instrument) top->instrument();
+      printIR(mod.get(), argv[4]);
+      break;
+
     default:
       printf("Unknown output\n");
       exit(1);
@@ -0,0 +1,282 @@
+/******************************************************************************
+ *
+ *  This file is part of the TULIPP Analysis Utility
+ *
+ *  Copyright 2018 Asbjørn Djupdal, NTNU, TULIPP EU Project
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *****************************************************************************/
+
+// Compiles one translation unit in a single process: clang frontend, CFG XML, instrumentation,
+// optimization and code generation.  This replaces the clang, llvm_ir_parser, opt, llc and as
+// processes run by the wrapper, and the IR is never written to or parsed from disk.
+//
+// Takes the same arguments as the wrapper, except that only the clang executable is given:
+//   tulippcc_driver <clang> [clang options] <input> -o <output> [-O<level>] [--tulipp-instrument [--tulipp-loop-counters]]
+
+#include "llvm/Config/llvm-config.h"
+#include "llvm/IR/LegacyPassManager.h"
+#include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/TargetRegistry.h"
+#include "llvm/Support/Program.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/Host.h"
+#include "llvm/Target/TargetMachine.h"
+#include "llvm/Target/TargetOptions.h"
+#include "llvm/Analysis/TargetTransformInfo.h"
+#include "llvm/Transforms/IPO.h"
+#include "llvm/Transforms/IPO/PassManagerBuilder.h"
+
+#include "clang/Basic/Diagnostic.h"
+#include "clang/Basic/DiagnosticOptions.h"
+#include "clang/Driver/Driver.h"
+#include "clang/Driver/Compilation.h"
+#include "clang/Driver/Job.h"
+#include "clang/Frontend/CompilerInstance.h"
+#include "clang/Frontend/CompilerInvocation.h"
+#include "clang/Frontend/TextDiagnosticPrinter.h"
+#include "clang/CodeGen/CodeGenAction.h"
+
+#include "cfg.h"
+
+using namespace llvm;
+
+#define TULIPP_TARGET "aarch64--none-gnueabi"
+#define TULIPP_CPU    "cortex-a53"
+
+static LLVMContext Context;
+
+unsigned dumpType = NO_DUMP;
+
+///////////////////////////////////////////////////////////////////////////////
+
+static bool isSource(std::string filename) {
+  std::string ext = sys::path::extension(filename);
+  return (ext == ".c") || (ext == ".cpp") || (ext == ".cc");
+}
+
+static std::unique_ptr<Module> compile(std::string clang, std::vector<std::string> &args, std::string input) {
+  // let the clang driver find the headers and create the frontend arguments, as when running clang
+  std::vector<std::string> driverArgs = args;
+  driverArgs.push_back("-Os");
+  driverArgs.push_back("-target");
+  driverArgs.push_back(TULIPP_TARGET);
+  driverArgs.push_back("-g");
+  driverArgs.push_back("-emit-llvm");
+  driverArgs.push_back("-c");
+  driverArgs.push_back(input);
+
+  std::string clangPath = clang;
+  auto found = sys::findProgramByName(clang);
+  if(found) clangPath = *found;
+
+  std::vector<const char*> argv;
+  argv.push_back(clangPath.c_str());
+  for(auto &arg : driverArgs) argv.push_back(arg.c_str());
+
+  IntrusiveRefCntPtr<clang::DiagnosticOptions> diagOpts = new clang::DiagnosticOptions();
+  clang::TextDiagnosticPrinter *diagPrinter = new clang::TextDiagnosticPrinter(errs(), &*diagOpts);
+  IntrusiveRefCntPtr<clang::DiagnosticIDs> diagIds(new clang::DiagnosticIDs());
+  clang::DiagnosticsEngine diags(diagIds, &*diagOpts, diagPrinter);
+
+  clang::driver::Driver driver(clangPath, sys::getDefaultTargetTriple(), diags);
+  driver.setCheckInputsExist(false);
+
+  std::unique_ptr<clang::driver::Compilation> compilation(driver.BuildCompilation(argv));
+  if(!compilation || (compilation->getJobs().size() != 1)) {
+    errs() << "Can't create compiler job for " << input << "\n";
+    return nullptr;
+  }
+
+  const clang::driver::Command &command = cast<clang::driver::Command>(*compilation->getJobs().begin());
+  const opt::ArgStringList &ccArgs = command.getArguments();
+
+  std::shared_ptr<clang::CompilerInvocation> invocation(new clang::CompilerInvocation);
+  if(!clang::CompilerInvocation::CreateFromArgs(*invocation, ccArgs.data(), ccArgs.data() + ccArgs.size(), diags)) {
+    return nullptr;
+  }
+
+  clang::CompilerInstance compiler;
+  compiler.setInvocation(invocation);
+  compiler.createDiagnostics();
+
+  clang::EmitLLVMOnlyAction action(&Context);
+  if(!compiler.ExecuteAction(action)) return nullptr;
+
+  return action.takeModule();
+}
+
+static void optimize(Module *mod, TargetMachine *tm, std::string optlevel) {
+  unsigned optLevel = 0;
+  unsigned sizeLevel = 0;
+
+  if(optlevel == "-Os") {
+    optLevel = 2;
+    sizeLevel = 1;
+  } else if(optlevel == "-Oz") {
+    optLevel = 2;
+    sizeLevel = 2;
+  } else {
+    optLevel = std::min(atoi(optlevel.c_str() + 2), 3);
+  }
+
+  PassManagerBuilder builder;
+  builder.OptLevel = optLevel;
+  builder.SizeLevel = sizeLevel;
+  if(optLevel > 1) {
+    builder.Inliner = createFunctionInliningPass(optLevel, sizeLevel, false);
+  } else {
+    builder.Inliner = createAlwaysInlinerLegacyPass();
+  }
+  tm->adjustPassManager(builder);
+
+  legacy::FunctionPassManager functionPasses(mod);
+  legacy::PassManager modulePasses;
+
+  functionPasses.add(createTargetTransformInfoWrapperPass(tm->getTargetIRAnalysis()));
+  modulePasses.add(createTargetTransformInfoWrapperPass(tm->getTargetIRAnalysis()));
+
+  builder.populateFunctionPassManager(functionPasses);
+  builder.populateModulePassManager(modulePasses);
+
+  functionPasses.doInitialization();
+  for(auto &func : *mod) {
+    functionPasses.run(func);
+  }
+  functionPasses.doFinalization();
+
+  modulePasses.run(*mod);
+}
+
+static bool emitObject(Module *mod, TargetMachine *tm, std::string output) {
+  std::error_code err;
+  raw_fd_ostream out(output, err, sys::fs::OpenFlags::F_None);
+  if(err) {
+    errs() << "Can't open " << output << ": " << err.message() << "\n";
+    return false;
+  }
+
+  legacy::PassManager codegenPasses;
+
+#if LLVM_VERSION_MAJOR >= 7
+  bool failed = tm->addPassesToEmitFile(codegenPasses, out, nullptr, TargetMachine::CGFT_ObjectFile);
+#else
+  bool failed = tm->addPassesToEmitFile(codegenPasses, out, TargetMachine::CGFT_ObjectFile);
+#endif
+
+  if(failed) {
+    errs() << "Can't emit object files for " << mod->getTargetTriple() << "\n";
+    return false;
+  }
+
+  codegenPasses.run(*mod);
+  out.flush();
+
+  return true;
+}
+
+int main(int argc, char *argv[]) {
+  std::vector<std::string> args;
+
+  std::string input;
+  std::string output;
+  std::string optlevel;
+
+  bool instrument = false;
+
+  if(argc < 3) {
+    fprintf(stderr, "Usage: %s <clang> [options] <input> -o <output> [-O<level>] [--tulipp-instrument [--tulipp-loop-counters]]\n", argv[0]);
+    return 1;
+  }
+
+  int arg = 2;
+
+  while(arg < argc) {
+    std::string argstring = std::string(argv[arg]);
+
+    if(isSource(argstring)) {
+      input = argstring;
+      arg++;
+    } else if((argstring == "-o") && (arg + 1 < argc)) {
+      output = std::string(argv[arg+1]);
+      arg += 2;
+    } else if(argstring.substr(0,2) == "-O") {
+      optlevel = argstring;
+      arg++;
+    } else if(argstring == "--tulipp-instrument") {
+      instrument = true;
+      arg++;
+    } else if(argstring == "--tulipp-loop-counters") {
+      loopCounters = true;
+      arg++;
+    } else {
+      args.push_back(argstring);
+      arg++;
+    }
+  }
+
+  if((input == "") || (output == "")) {
+    fprintf(stderr, "No input or output file\n");
+    return 1;
+  }
+
+  InitializeAllTargetInfos();
+  InitializeAllTargets();
+  InitializeAllTargetMCs();
+  InitializeAllAsmPrinters();
+  InitializeAllAsmParsers();
+
+  // frontend
+  std::unique_ptr<Module> mod = compile(argv[1], args, input);
+  if(!mod) return 1;
+
+  // CFG XML for the analysis tool, then instrumentation, as done by llvm_ir_parser
+  std::string base = sys::path::stem(input);
+
+  ModuleNode *top = new ModuleNode(mod.get());
+  printXML(top, base + ".xml");
+
+  tagBbIds(mod.get(), top);
+  if(instrument) top->instrument();
+
+  // backend
+  std::string error;
+  const Target *target = TargetRegistry::lookupTarget(mod->getTargetTriple(), error);
+  if(!target) {
+    errs() << error << "\n";
+    return 1;
+  }
+
+  TargetOptions options;
+  std::unique_ptr<TargetMachine> tm(target->createTargetMachine(mod->getTargetTriple(), TULIPP_CPU, "",
+                                                                options, Optional<Reloc::Model>()));
+
+  // same levels as llc, which runs at -O2 unless told otherwise
+  if(optlevel == "-O0") tm->setOptLevel(CodeGenOpt::None);
+  else if(optlevel == "-O1") tm->setOptLevel(CodeGenOpt::Less);
+  else if(optlevel == "-O3") tm->setOptLevel(CodeGenOpt::Aggressive);
+  else tm->setOptLevel(CodeGenOpt::Default);
+
+  mod->setDataLayout(tm->createDataLayout());
+
+  // opt is only run when an optimization level is given
+  if(optlevel != "") optimize(mod.get(), tm.get(), optlevel);
+
+  insertBbMap(mod.get());
+
+  if(!emitObject(mod.get(), tm.get(), output)) return 1;
+
+  return 0;
+}
@@ -0,0 +1,73 @@
+#!/bin/bash
+
+# Compares the wall time of compiling a synthetic multi-file project with the single process
+# tulippcc_driver and with the old multi-process wrapper pipeline (clang, llvm_ir_parser, opt, llc, as).
+# The compile cache is disabled, so that every file is compiled by both.
+#
+# Usage: bench_driver.sh [files] [functions per file] [-O level] [--tulipp-instrument]
+
+FILES=${1:-400}
+FUNCS=${2:-20}
+OPTLEVEL=${3:-"-O2"}
+INSTRUMENT=$4
+
+cd $(dirname $0)/../wrapper
+. ./toolsettings.sh
+
+if ! command -v $DRIVER > /dev/null; then
+  echo "$DRIVER is not installed"
+  exit 1
+fi
+
+export TULIPP_CACHE_DIR=""
+
+WORK=$(mktemp -d)
+trap "rm -rf $WORK" EXIT
+
+# every function has a loop nest, a branch and a call, so that the CFG XML and the instrumentation
+# have something to do
+for f in $(seq $FILES); do
+  {
+    echo "int g$f;"
+    for n in $(seq $FUNCS); do
+      echo "int f${f}_$n(int *a, int len) {"
+      echo "  int sum = 0;"
+      echo "  for(int i = 0; i < len; i++) {"
+      echo "    for(int j = 0; j < 4; j++) {"
+      echo "      if(a[i] & (1 << j)) sum += a[i] * j; else sum -= g$f;"
+      echo "    }"
+      echo "  }"
+      if [ $n -gt 1 ]; then echo "  sum += f${f}_$((n-1))(a, len / 2);"; fi
+      echo "  return sum;"
+      echo "}"
+    done
+  } > $WORK/file$f.c
+done
+
+compile_all() {
+  for f in $(seq $FILES); do
+    (cd $WORK/$1 && $WRAPPER $CLANG $LLVM_IR_PARSER $OPT $LLC $AS -c $OPTLEVEL $INSTRUMENT file$f.c -o file$f.o) > /dev/null || return 1
+  done
+}
+
+# the wrapper leaves its intermediate files next to the source, so each run gets its own copy
+bench() {
+  mkdir -p $WORK/$1
+  cp $WORK/*.c $WORK/$1
+  local start=$(date +%s.%N)
+  compile_all $1 || { echo "$1 build failed" >&2; return 1; }
+  local end=$(date +%s.%N)
+  echo "$end - $start" | bc
+}
+
+echo "Compiling $FILES files with $FUNCS functions each ($OPTLEVEL $INSTRUMENT)"
+
+unset TULIPP_DRIVER
+WRAPPER_TIME=$(bench wrapper) || exit 1
+echo "wrapper: $WRAPPER_TIME s"
+
+export TULIPP_DRIVER=$DRIVER
+DRIVER_TIME=$(bench driver) || exit 1
+echo "driver:  $DRIVER_TIME s"
+
+echo "speedup: $(echo "scale=2; $WRAPPER_TIME / $DRIVER_TIME" | bc)"
@@ -0,0 +1,98 @@
+#!/bin/bash
+
+# Checks DSE workers on one host: two local socket workers build the same SDSoC project in parallel,
+# clients and workers with a wrong secret are refused, and so are TCP workers without a secret or
+# with an unresolvable host.
+#
+# Usage: dse_workers.sh <sdsoc project> [build config]
+
+ANALYSIS_TOOL=${ANALYSIS_TOOL:-"analysis_tool"}
+
+if [ -z "$1" ]; then
+  echo "Usage: $0 <sdsoc project> [build config]"
+  exit 1
+fi
+
+# the worker only accepts absolute project paths
+PROJECT=$(realpath "$1")
+CONFIG=${2:-"Release"}
+
+export QT_QPA_PLATFORM=offscreen
+export TULIPP_DSE_SECRET=$(head -c 32 /dev/urandom | sha1sum | cut -d' ' -f1)
+
+WORK=$(mktemp -d)
+PIDS=""
+FAILED=0
+
+cleanup() {
+  if [ -n "$PIDS" ]; then kill $PIDS 2> /dev/null; fi
+  rm -rf "$WORK"
+}
+trap cleanup EXIT
+
+check() {
+  if [ $1 -eq 0 ]; then
+    echo "PASS: $2"
+  else
+    echo "FAIL: $2"
+    FAILED=1
+  fi
+}
+
+wait_for() {
+  for i in $(seq 50); do
+    if grep -q "listening" $1; then return 0; fi
+    sleep 0.1
+  done
+  return 1
+}
+
+build_on() {
+  "$ANALYSIS_TOOL" --project "$PROJECT" --build-config "$CONFIG" --build --dse-build-on $1 > $2 2>&1
+}
+
+# two workers on local sockets
+for w in 1 2; do
+  "$ANALYSIS_TOOL" --dse-worker $WORK/worker$w > $WORK/worker$w.log 2>&1 &
+  PIDS="$PIDS $!"
+done
+
+wait_for $WORK/worker1.log && wait_for $WORK/worker2.log
+check $? "workers started"
+
+# parallel builds, one on each worker
+build_on $WORK/worker1 $WORK/build1.log &
+B1=$!
+build_on $WORK/worker2 $WORK/build2.log &
+B2=$!
+wait $B1
+check $? "build on worker 1"
+wait $B2
+check $? "build on worker 2"
+
+grep -q "Building" $WORK/worker1.log && grep -q "Building" $WORK/worker2.log
+check $? "both workers built"
+
+# a client with the wrong secret gets no build
+TULIPP_DSE_SECRET=wrong build_on $WORK/worker1 $WORK/wrong.log
+[ $? -ne 0 ] && grep -q "authentication failed" $WORK/worker1.log
+check $? "wrong secret rejected"
+
+# a worker with another secret is not trusted by the client
+TULIPP_DSE_SECRET=other "$ANALYSIS_TOOL" --dse-worker $WORK/worker3 > $WORK/worker3.log 2>&1 &
+PIDS="$PIDS $!"
+wait_for $WORK/worker3.log
+build_on $WORK/worker3 $WORK/untrusted.log
+[ $? -ne 0 ] && grep -q "failed authentication" $WORK/untrusted.log
+check $? "worker with wrong secret not trusted"
+
+# TCP workers need a secret and a resolvable host
+TULIPP_DSE_SECRET= "$ANALYSIS_TOOL" --dse-worker :0 > $WORK/nosecret.log 2>&1
+[ $? -ne 0 ]
+check $? "TCP worker without secret refused"
+
+"$ANALYSIS_TOOL" --dse-worker no-such-host.invalid:5000 > $WORK/noresolve.log 2>&1
+[ $? -ne 0 ] && grep -q "Can't resolve" $WORK/noresolve.log
+check $? "unresolvable host refused"
+
+exit $FAILED
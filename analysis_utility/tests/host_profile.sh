@@ -0,0 +1,107 @@
+#!/bin/bash
+
+# End-to-end check of the host build of libtulipp: compiles an instrumented program for the host,
+# runs it to get the PC sample file and the call graph file, and loads both into the analysis tool
+# the way profiles from the board are loaded.  Needs no board, so it runs on x86 CI.
+#
+# Usage: host_profile.sh [--loop-counters]
+
+ANALYSIS_TOOL=${ANALYSIS_TOOL:-"analysis_tool"}
+COUNTERS=$1
+
+ROOT=$(realpath $(dirname $0)/../..)
+LIBTULIPP=$ROOT/target/libtulipp
+
+. $ROOT/analysis_utility/wrapper/toolsettings.sh
+
+export QT_QPA_PLATFORM=offscreen
+
+CALLS=50
+
+WORK=$(mktemp -d)
+trap "rm -rf $WORK" EXIT
+
+FAILED=0
+
+check() {
+  if [ $1 -eq 0 ]; then
+    echo "PASS: $2"
+  else
+    echo "FAIL: $2"
+    FAILED=1
+  fi
+}
+
+make -C $LIBTULIPP host > $WORK/libtulipp.log 2>&1
+check $? "libtulipp host build"
+[ $FAILED -eq 0 ] || exit 1
+
+cat > $WORK/main.c <<END
+#include <stdio.h>
+#include "tulipp.h"
+
+extern char __executable_start;
+extern char etext;
+
+int work(int n) {
+  volatile int sum = 0;
+  for(int i = 0; i < n; i++) {
+    sum += i;
+  }
+  return sum;
+}
+
+int main(void) {
+  int sum = 0;
+  initPerfCounters(0, 0, 0, 0, 0, 0);
+  startProfiler((uint64_t)&__executable_start, &etext - &__executable_start, 0.001, false);
+  for(int i = 0; i < $CALLS; i++) {
+    sum += work(2000000);
+  }
+  stopProfiler("prof.dat");
+  printf("%d\n", sum);
+  return 0;
+}
+END
+
+# the project only points the tool at the ELF file, the XML file is made below
+cat > $WORK/project.ini <<END
+[General]
+customElfFile=$WORK/main.elf
+END
+
+# the same steps as the wrapper, but for the host
+(cd $WORK &&
+ $CLANG -I$LIBTULIPP -g -emit-llvm -c main.c -o main.bc &&
+ $LLVM_IR_PARSER main.bc -all main.xml main_2.bc --instrument $COUNTERS &&
+ $OPT -O2 main_2.bc -o - | $LLVM_IR_PARSER - -bbmap main_3.bc &&
+ $CLANG -c main_3.bc -o main.o &&
+ $CLANG main.o $LIBTULIPP/libtulipp_host.a -o main.elf) > $WORK/build.log 2>&1
+check $? "instrumented host build"
+[ $FAILED -eq 0 ] || { cat $WORK/build.log; exit 1; }
+
+(cd $WORK && ./main.elf) > $WORK/run.log 2>&1
+check $? "run"
+
+[ -s $WORK/prof.dat ]
+check $? "PC sample file written"
+
+[ -s $WORK/tulipp.gmn ]
+check $? "call graph file written"
+
+# the tool shows a dialog if a file is missing, so only load complete results
+[ $FAILED -eq 0 ] || exit 1
+
+"$ANALYSIS_TOOL" --project $WORK --load-profile $WORK/prof.dat --load-gprof $WORK/tulipp.gmn,$WORK/main.elf \
+                 --get-count main,work,0 > $WORK/count.log 2>&1
+check $? "profile and call graph loaded"
+
+[ "$(tail -n1 $WORK/count.log)" == "$CALLS" ]
+check $? "calls counted"
+
+"$ANALYSIS_TOOL" --project $WORK --load-profile $WORK/prof.dat --load-gprof $WORK/tulipp.gmn,$WORK/main.elf \
+                 --get-runtime main,work,0 > $WORK/runtime.log 2>&1
+awk 'END { exit !($1 > 0) }' $WORK/runtime.log
+check $? "runtime sampled"
+
+exit $FAILED
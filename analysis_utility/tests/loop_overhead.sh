@@ -0,0 +1,89 @@
+#!/bin/bash
+
+# Measures the overhead of the loop instrumentation on the host.  The same loop is compiled through
+# llvm_ir_parser without instrumentation, with --instrument (a call to __tulipp_loop_count in the
+# latch) and with --instrument --loop-counters (an inline counter in the latch), linked with the host
+# build of libtulipp, and timed with profiling on.
+#
+# Usage: loop_overhead.sh [iterations]
+
+ITERATIONS=${1:-200000000}
+
+ROOT=$(realpath $(dirname $0)/../..)
+LIBTULIPP=$ROOT/target/libtulipp
+
+. $ROOT/analysis_utility/wrapper/toolsettings.sh
+
+WORK=$(mktemp -d)
+trap "rm -rf $WORK" EXIT
+
+make -C $LIBTULIPP libtulipp_host.a > $WORK/libtulipp.log 2>&1 || { cat $WORK/libtulipp.log; exit 1; }
+
+# the loop is in its own file, so that the iteration count is not known when it is compiled
+cat > $WORK/loop.c <<END
+unsigned long loop(unsigned long n) {
+  unsigned long sum = 0;
+  for(unsigned long i = 0; i < n; i++) {
+    sum += i ^ (sum >> 3);
+  }
+  return sum;
+}
+END
+
+cat > $WORK/main.c <<END
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "gmon.h"
+
+void monstartup(size_t lowpc, size_t highpc);
+unsigned long loop(unsigned long n);
+
+extern char __executable_start;
+extern char etext;
+
+volatile unsigned long sink;
+
+int main(int argc, char *argv[]) {
+  unsigned long n = strtoul(argv[1], NULL, 0);
+  struct timespec start, end;
+
+  /* the runtime only counts while profiling is on */
+  _monInit();
+  monstartup((size_t)&__executable_start, (size_t)&etext);
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  sink = loop(n);
+  clock_gettime(CLOCK_MONOTONIC, &end);
+
+  printf("%.3f\n", ((end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec)) / n);
+  return 0;
+}
+END
+
+# the same steps as the wrapper, but for the host
+build() {
+  mkdir -p $WORK/$1
+  (cd $WORK/$1 &&
+   $CLANG -O2 -g -emit-llvm -c ../loop.c -o loop.bc &&
+   $LLVM_IR_PARSER loop.bc -all loop.xml loop_2.bc $2 &&
+   $OPT -O2 loop_2.bc -o - | $LLVM_IR_PARSER - -bbmap loop_3.bc &&
+   $CLANG -c loop_3.bc -o loop.o &&
+   $CLANG -O2 -I$LIBTULIPP -DTULIPP_HOST ../main.c loop.o $LIBTULIPP/libtulipp_host.a -o loop.elf) > $WORK/$1.log 2>&1 ||
+    { echo "$1 build failed" >&2; cat $WORK/$1.log >&2; return 1; }
+}
+
+build plain "" || exit 1
+build call "--instrument" || exit 1
+build inline "--instrument --loop-counters" || exit 1
+
+echo "Running $ITERATIONS loop iterations"
+
+BASE=$($WORK/plain/loop.elf $ITERATIONS) || exit 1
+echo "uninstrumented: $BASE ns/iteration"
+
+CALL=$($WORK/call/loop.elf $ITERATIONS) || exit 1
+echo "runtime call:   $CALL ns/iteration (+$(echo "$CALL - $BASE" | bc))"
+
+INLINE=$($WORK/inline/loop.elf $ITERATIONS) || exit 1
+echo "inline counter: $INLINE ns/iteration (+$(echo "$INLINE - $BASE" | bc))"
@@ -0,0 +1,9 @@
+QT += testlib
+QT -= gui
+CONFIG += console testcase
+QMAKE_CXXFLAGS += -std=gnu++11
+
+INCLUDEPATH += ../../analysis_tool/src
+
+HEADERS = ../../analysis_tool/src/project/makeprogress.h
+SOURCES = tst_makeprogress.cpp
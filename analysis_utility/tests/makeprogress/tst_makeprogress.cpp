@@ -0,0 +1,48 @@
+#include <QtTest>
+
+#include "project/makeprogress.h"
+
+class TestMakeProgress : public QObject {
+  Q_OBJECT
+
+private slots:
+  void matchesCommandLines() {
+    MakeProgress progress(QStringList() << "main.bc" << "main.xml" << "filter.bc");
+
+    QCOMPARE(progress.match("clang -Os -c main.c -o main.bc\n"), QStringList() << "main.bc");
+    QCOMPARE(progress.match("llvm_ir_parser main.bc -all main.xml main_2.bc\n"), QStringList() << "main.xml");
+    QCOMPARE(progress.match("echo 'Using cached filter.bc'\n"), QStringList() << "filter.bc");
+  }
+
+  void matchesWholeWordsOnly() {
+    MakeProgress progress(QStringList() << "foo.o");
+
+    QCOMPARE(progress.match("clang -MF foo.o.d -c foo.c -o libfoo.o\n"), QStringList());
+    QCOMPARE(progress.match("as foo.s -o build/foo.o\n"), QStringList() << "foo.o");
+  }
+
+  void whitespaceAroundTargets() {
+    // tabs and line ends are separators as well
+    MakeProgress progress(QStringList() << "a.o" << "b.o");
+
+    QCOMPARE(progress.match("\tcc -o a.o\tb.o"), QStringList() << "a.o" << "b.o");
+  }
+
+  void reportsEachTargetOnce() {
+    MakeProgress progress(QStringList() << "main.bc");
+
+    QCOMPARE(progress.match("clang -c main.c -o main.bc\n"), QStringList() << "main.bc");
+    QCOMPARE(progress.match("clang -c main.c -o main.bc\n"), QStringList());
+  }
+
+  void escapesTargetNames() {
+    MakeProgress progress(QStringList() << "a+b.o");
+
+    QCOMPARE(progress.match("cc -o aab.o\n"), QStringList());
+    QCOMPARE(progress.match("cc -o a+b.o\n"), QStringList() << "a+b.o");
+  }
+};
+
+QTEST_APPLESS_MAIN(TestMakeProgress)
+
+#include "tst_makeprogress.moc"
@@ -22,6 +22,9 @@
 #include <sstream>
 #include <string>
 #include <iostream>
+#include <map>
+#include <set>
+#include <vector>
 #include <stdio.h>
 
 #include "clang/AST/AST.h"
@@ -49,8 +52,29 @@ static llvm::cl::list<std::string> Array("array", llvm::cl::desc("Partition arra
 
 static llvm::cl::list<unsigned> Dim("dim", llvm::cl::desc("Array dimension to partition"), llvm::cl::value_desc("dim"), llvm::cl::ZeroOrMore, llvm::cl::cat(TulippCategory));
 
+static llvm::cl::list<std::string> Partition("partition", llvm::cl::desc("Array partition type (complete, block or cyclic)"), llvm::cl::value_desc("type"), llvm::cl::ZeroOrMore, llvm::cl::cat(TulippCategory));
+
+static llvm::cl::list<unsigned> Factor("factor", llvm::cl::desc("Array partition factor"), llvm::cl::value_desc("factor"), llvm::cl::ZeroOrMore, llvm::cl::cat(TulippCategory));
+
+static llvm::cl::list<std::string> UnrollLoop("unrollloop", llvm::cl::desc("Unroll loop"), llvm::cl::value_desc("unrollloops"), llvm::cl::ZeroOrMore, llvm::cl::cat(TulippCategory));
+
+static llvm::cl::list<unsigned> Unroll("unroll", llvm::cl::desc("Unroll factor, 0 unrolls completely"), llvm::cl::value_desc("factor"), llvm::cl::ZeroOrMore, llvm::cl::cat(TulippCategory));
+
+static llvm::cl::list<std::string> Dataflow("dataflow", llvm::cl::desc("Dataflow function"), llvm::cl::value_desc("function"), llvm::cl::ZeroOrMore, llvm::cl::cat(TulippCategory));
+
+static llvm::cl::list<std::string> Inline("inline", llvm::cl::desc("Inline function"), llvm::cl::value_desc("function"), llvm::cl::ZeroOrMore, llvm::cl::cat(TulippCategory));
+
+static llvm::cl::list<std::string> NoInline("noinline", llvm::cl::desc("Do not inline function"), llvm::cl::value_desc("function"), llvm::cl::ZeroOrMore, llvm::cl::cat(TulippCategory));
+
+static llvm::cl::opt<bool> List("list", llvm::cl::desc("List functions and arrays instead of transforming"), llvm::cl::cat(TulippCategory));
+
 std::string sourceFile;
 
+// output of --list
+std::vector<std::pair<std::string,int> > functions;
+std::map<std::string,std::set<std::string> > calls;
+std::stringstream arrays;
+
 std::string getBaseName(std::string path) {
   std::string file;
   unsigned long pos = path.rfind("/");
@@ -59,15 +83,25 @@ std::string getBaseName(std::string path) {
   return file;
 }
 
+bool contains(llvm::cl::list<std::string> &list, std::string value) {
+  for(unsigned i = 0; i < list.size(); i++) {
+    if(list[i] == value) return true;
+  }
+  return false;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 class InstrumentationVisitor : public RecursiveASTVisitor<InstrumentationVisitor> {
 
 private:
   Rewriter &rewriter;
+  FunctionDecl *currentFunction;
 
 public:
-  InstrumentationVisitor(Rewriter &R) : rewriter(R) {}
+  InstrumentationVisitor(Rewriter &R) : rewriter(R) {
+    currentFunction = NULL;
+  }
 
   bool VisitStmt(Stmt *s) {
 
@@ -79,6 +113,7 @@ public:
       Stmt *body;
 
       bool instrument = true;
+      std::string pragmas;
 
       std::stringstream loopId;
       loopId << line << "," << column;
@@ -95,43 +130,84 @@ public:
       }
 
       // pipeline loop
-      for(unsigned i = 0; i < PipelineLoop.size(); i++) {
-        if(loopId.str() == PipelineLoop[i]) {
-          instrument = false;
+      if(contains(PipelineLoop, loopId.str())) {
+        instrument = false;
+        pragmas += "#pragma HLS PIPELINE\n";
+      }
+
+      // unroll loop
+      for(unsigned i = 0; i < UnrollLoop.size(); i++) {
+        if(loopId.str() == UnrollLoop[i]) {
+          std::stringstream str;
+          str << "#pragma HLS UNROLL";
+          if((i < Unroll.size()) && Unroll[i]) str << " factor=" << Unroll[i];
+          str << "\n";
+          pragmas += str.str();
+        }
+      }
 
-          if(isa<CompoundStmt>(body)) {
-            CompoundStmt *body_s = cast<CompoundStmt>(body);
+      if(pragmas != "") {
+        if(isa<CompoundStmt>(body)) {
+          CompoundStmt *body_s = cast<CompoundStmt>(body);
 
-            rewriter.InsertTextAfterToken(body_s->getLBracLoc(), "\n#pragma HLS PIPELINE\n");
+          rewriter.InsertTextAfterToken(body_s->getLBracLoc(), "\n" + pragmas);
 
-          } else {
-            rewriter.InsertTextAfter(body->getSourceRange().getBegin(), "\n{ \n#pragma HLS PIPELINE\n");
-            rewriter.InsertTextAfterToken(body->getSourceRange().getEnd(), "}");
-          }
+        } else {
+          rewriter.InsertTextAfter(body->getSourceRange().getBegin(), "\n{ \n" + pragmas);
+          rewriter.InsertTextAfterToken(body->getSourceRange().getEnd(), "}");
         }
       }
     }
 
+    // calls made by the current function
+    if(List && currentFunction && isa<CallExpr>(s)) {
+      FunctionDecl *callee = cast<CallExpr>(s)->getDirectCallee();
+      if(callee) {
+        calls[currentFunction->getNameAsString()].insert(callee->getNameAsString());
+      }
+    }
+
     return true;
   }
 
   bool VisitDecl(Decl *D) {
     SourceManager &SM = rewriter.getSourceMgr();
     int line = SM.getSpellingLineNumber(D->getLocStart());
+    int column = SM.getSpellingColumnNumber(D->getLocStart());
 
     std::string filename = SM.getFilename(D->getLocStart()).str();
 
     if(isa<VarDecl>(D)) {
       VarDecl *var = cast<VarDecl>(D);
       if(isa<ArrayType>(var->getType())) {
+        std::stringstream arrayId;
+        arrayId << line << "," << column;
+
+        // arrays are given either by name or by the position of the declaration
         for(unsigned i = 0; i < Array.size(); i++) {
-          if(var->getNameAsString() == Array[i]) {
+          if((var->getNameAsString() == Array[i]) || (arrayId.str() == Array[i])) {
+            std::string type = i < Partition.size() ? Partition[i] : "complete";
+
             SourceLocation loc = SM.translateFileLineCol(SM.getFileEntryForID(SM.getMainFileID()), line, 0);
             std::stringstream str;
-            str << "\n#pragma HLS ARRAY_PARTITION variable=" << var->getNameAsString() << " complete dim=" << Dim[i] << "\n";
+            str << "\n#pragma HLS ARRAY_PARTITION variable=" << var->getNameAsString() << " " << type;
+            if((type != "complete") && (i < Factor.size())) str << " factor=" << Factor[i];
+            str << " dim=" << (i < Dim.size() ? Dim[i] : 1) << "\n";
             rewriter.InsertText(loc, str.str());
           }
         }
+
+        if(List && SM.isInMainFile(D->getLocStart())) {
+          unsigned dims = 0;
+          for(const Type *t = var->getType().getTypePtr(); isa<ConstantArrayType>(t); t = cast<ConstantArrayType>(t)->getElementType().getTypePtr()) {
+            dims++;
+          }
+          FunctionDecl *parent = dyn_cast_or_null<FunctionDecl>(var->getParentFunctionOrMethod());
+          if(dims) {
+            arrays << "array " << (parent ? parent->getNameAsString() : "-") << " "
+                   << var->getNameAsString() << " " << arrayId.str() << " " << dims << "\n";
+          }
+        }
       }
     }
 
@@ -139,6 +215,27 @@ public:
   }
 
   bool VisitFunctionDecl(FunctionDecl *f) {
+    SourceManager &SM = rewriter.getSourceMgr();
+
+    if(f->hasBody() && f->isThisDeclarationADefinition() && SM.isInMainFile(f->getLocStart())) {
+      currentFunction = f;
+
+      std::string name = f->getNameAsString();
+      std::string pragmas;
+
+      if(contains(Dataflow, name)) pragmas += "#pragma HLS DATAFLOW\n";
+      if(contains(Inline, name)) pragmas += "#pragma HLS INLINE\n";
+      if(contains(NoInline, name)) pragmas += "#pragma HLS INLINE off\n";
+
+      if((pragmas != "") && isa<CompoundStmt>(f->getBody())) {
+        rewriter.InsertTextAfterToken(cast<CompoundStmt>(f->getBody())->getLBracLoc(), "\n" + pragmas);
+      }
+
+      if(List) {
+        functions.push_back(std::make_pair(name, SM.getSpellingLineNumber(f->getLocStart())));
+      }
+    }
+
     return true;
   }
 };
@@ -174,8 +271,20 @@ public:
   void EndSourceFileAction() override {
     SourceManager &SM = rewriter.getSourceMgr();
 
-    // output rewritten source
-    if(PipelineLoop.size() || Array.size()) {
+    if(List) {
+      // output functions with the functions they call, and arrays with the function they are declared in
+      std::error_code err;
+      llvm::raw_fd_ostream ostream(OutputFilename, err, llvm::sys::fs::OpenFlags::F_None);
+      for(auto f : functions) {
+        ostream << "function " << f.first << " " << f.second;
+        for(auto c : calls[f.first]) ostream << " " << c;
+        ostream << "\n";
+      }
+      ostream << arrays.str();
+
+    } else if(PipelineLoop.size() || Array.size() || UnrollLoop.size() ||
+              Dataflow.size() || Inline.size() || NoInline.size()) {
+      // output rewritten source
       std::error_code err;
       llvm::raw_fd_ostream ostream(OutputFilename, err, llvm::sys::fs::OpenFlags::F_None);
       rewriter.getEditBuffer(SM.getMainFileID()).write(ostream);
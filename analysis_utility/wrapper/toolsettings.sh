@@ -1,7 +1,12 @@
 WRAPPER=${WRAPPER:-"wrapper"}
+DRIVER=${DRIVER:-"tulippcc_driver"}
 CLANG=${CLANG:-"clang"}
 CLANGPP=${CLANGPP:-"clang++"}
 LLVM_IR_PARSER=${LLVM_IR_PARSER:-"llvm_ir_parser"}
 OPT=${OPT:-"opt"}
 LLC=${LLC:-"llc"}
 AS=${AS:-"aarch64-hipperos-as"}
+
+# compile cache, set TULIPP_CACHE_DIR to an empty string to disable.  Size is in megabytes
+export TULIPP_CACHE_DIR=${TULIPP_CACHE_DIR-"$HOME/.tulipp/cache/tulippcc"}
+export TULIPP_CACHE_SIZE=${TULIPP_CACHE_SIZE:-"5000"}
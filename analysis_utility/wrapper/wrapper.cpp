@@ -1,10 +1,22 @@
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <limits.h>
 #include <stdint.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <utime.h>
+#include <sys/stat.h>
+#include <sys/file.h>
 
 #include <iostream>
 #include <vector>
 #include <string>
+#include <algorithm>
+
+#define CACHE_VERSION      "3"
+#define CACHE_DEFAULT_SIZE 5000 // MB
 
 std::string ext(std::string s) {
   char sep = '.';
@@ -35,6 +47,378 @@ std::string base(std::string s) {
   }
 }
 
+
+///////////////////////////////////////////////////////////////////////////////
+// compile cache
+//
+// Objects and CFG XML files are stored in TULIPP_CACHE_DIR (empty to disable), keyed by the
+// preprocessed source, the flags, the directory and the tools.  Least recently used entries are removed when the
+// cache grows beyond TULIPP_CACHE_SIZE megabytes.
+
+class Hash {
+  // the key data is collected in a temporary file and hashed with sha1sum, like the Makefile cache
+  std::string filename;
+  FILE *fp;
+
+public:
+  Hash() {
+    char name[] = "/tmp/tulipp_key_XXXXXX";
+    int fd = mkstemp(name);
+    fp = (fd >= 0) ? fdopen(fd, "wb") : NULL;
+    if(fp) filename = name;
+  }
+
+  ~Hash() {
+    if(fp) fclose(fp);
+    if(filename != "") unlink(filename.c_str());
+  }
+
+  void add(const char *data, size_t size) {
+    if(fp && (fwrite(data, 1, size, fp) != size)) {
+      fclose(fp);
+      fp = NULL;
+    }
+  }
+
+  void add(std::string s) {
+    // include the terminator, so that "ab" "c" differs from "a" "bc"
+    add(s.c_str(), s.size() + 1);
+  }
+
+  std::string hex() {
+    // an empty key disables the cache
+    if(!fp) return "";
+
+    bool written = !fclose(fp);
+    fp = NULL;
+    if(!written) return "";
+
+    FILE *sum = popen(("sha1sum " + filename).c_str(), "r");
+    if(!sum) return "";
+
+    char buf[41];
+    bool success = fscanf(sum, "%40[0-9a-f]", buf) == 1;
+    if(pclose(sum) || !success || (strlen(buf) != 40)) return "";
+
+    return std::string(buf);
+  }
+};
+
+std::string findExecutable(std::string name) {
+  if(name.find('/') != std::string::npos) return name;
+
+  const char *path = getenv("PATH");
+  if(!path) return name;
+
+  std::string paths = path;
+  size_t start = 0;
+
+  while(start <= paths.size()) {
+    size_t end = paths.find(':', start);
+    if(end == std::string::npos) end = paths.size();
+
+    std::string candidate = paths.substr(start, end - start) + "/" + name;
+    if(!access(candidate.c_str(), X_OK)) return candidate;
+
+    start = end + 1;
+  }
+
+  return name;
+}
+
+std::string fingerprint(std::string tool) {
+  // changes when the tool is replaced
+  std::string executable = findExecutable(tool);
+
+  struct stat st;
+  if(stat(executable.c_str(), &st)) return tool;
+
+  return executable + ":" + std::to_string((long long)st.st_size) + ":" + std::to_string((long long)st.st_mtime);
+}
+
+bool hashCommandOutput(std::string command, Hash &hash) {
+  FILE *fp = popen(command.c_str(), "r");
+  if(!fp) return false;
+
+  char buf[65536];
+  size_t n;
+  while((n = fread(buf, 1, sizeof(buf), fp)) > 0) {
+    hash.add(buf, n);
+  }
+
+  return pclose(fp) == 0;
+}
+
+bool copyFile(std::string source, std::string dest) {
+  FILE *in = fopen(source.c_str(), "rb");
+  if(!in) return false;
+
+  FILE *out = fopen(dest.c_str(), "wb");
+  if(!out) {
+    fclose(in);
+    return false;
+  }
+
+  bool success = true;
+
+  char buf[65536];
+  size_t n;
+  while((n = fread(buf, 1, sizeof(buf), in)) > 0) {
+    if(fwrite(buf, 1, n, out) != n) {
+      success = false;
+      break;
+    }
+  }
+
+  fclose(in);
+  if(fclose(out)) success = false;
+
+  return success;
+}
+
+int64_t fileSize(std::string filename) {
+  struct stat st;
+  if(stat(filename.c_str(), &st)) return 0;
+  return st.st_size;
+}
+
+std::vector<std::string> listDir(std::string dirname) {
+  std::vector<std::string> entries;
+
+  DIR *dir = opendir(dirname.c_str());
+  if(dir) {
+    struct dirent *entry;
+    while((entry = readdir(dir)) != NULL) {
+      std::string name = entry->d_name;
+      if((name != ".") && (name != "..")) entries.push_back(name);
+    }
+    closedir(dir);
+  }
+
+  return entries;
+}
+
+void removeDir(std::string dirname) {
+  for(auto name : listDir(dirname)) {
+    unlink((dirname + "/" + name).c_str());
+  }
+  rmdir(dirname.c_str());
+}
+
+class Cache {
+  std::string dir;
+  int64_t maxSize;
+  int lockFd;
+
+  struct Stats {
+    int64_t hits;
+    int64_t misses;
+    int64_t size;
+  };
+
+  // the statistics are shared by concurrent compilations, and are only accessed while locked
+  void lock() {
+    lockFd = open((dir + "/lock").c_str(), O_RDWR | O_CREAT, 0644);
+    if(lockFd >= 0) flock(lockFd, LOCK_EX);
+  }
+
+  void unlock() {
+    if(lockFd >= 0) {
+      flock(lockFd, LOCK_UN);
+      close(lockFd);
+    }
+  }
+
+  Stats readStats() {
+    Stats stats = {0, 0, 0};
+
+    FILE *fp = fopen((dir + "/stats").c_str(), "r");
+    if(fp) {
+      long long hits, misses, size;
+      if(fscanf(fp, "hits %lld\nmisses %lld\nsize %lld\n", &hits, &misses, &size) == 3) {
+        stats.hits = hits;
+        stats.misses = misses;
+        stats.size = size;
+      }
+      fclose(fp);
+    }
+
+    return stats;
+  }
+
+  void writeStats(Stats stats) {
+    std::string tmp = dir + "/stats." + std::to_string((long long)getpid());
+
+    FILE *fp = fopen(tmp.c_str(), "w");
+    if(fp) {
+      fprintf(fp, "hits %lld\nmisses %lld\nsize %lld\n",
+              (long long)stats.hits, (long long)stats.misses, (long long)stats.size);
+      fclose(fp);
+      rename(tmp.c_str(), (dir + "/stats").c_str());
+    }
+  }
+
+  void updateStats(int64_t hits, int64_t misses, int64_t size) {
+    lock();
+
+    Stats stats = readStats();
+    stats.hits += hits;
+    stats.misses += misses;
+    stats.size += size;
+
+    if(stats.size > maxSize) stats.size = cleanup();
+
+    writeStats(stats);
+
+    unlock();
+  }
+
+  int64_t cleanup() {
+    // removes the least recently used entries until the cache is below 90% of the limit
+    struct Entry {
+      std::string path;
+      time_t used;
+      int64_t size;
+    };
+
+    std::vector<Entry> entries;
+    int64_t total = 0;
+
+    for(auto sub : listDir(dir)) {
+      if(sub.size() != 2) continue;
+
+      for(auto name : listDir(dir + "/" + sub)) {
+        Entry entry;
+        entry.path = dir + "/" + sub + "/" + name;
+
+        struct stat st;
+        if(stat(entry.path.c_str(), &st) || !S_ISDIR(st.st_mode)) continue;
+        entry.used = st.st_mtime;
+
+        entry.size = 0;
+        for(auto file : listDir(entry.path)) {
+          entry.size += fileSize(entry.path + "/" + file);
+        }
+
+        total += entry.size;
+        entries.push_back(entry);
+      }
+    }
+
+    std::sort(entries.begin(), entries.end(), [](const Entry &a, const Entry &b) {
+        return a.used < b.used;
+      });
+
+    for(auto &entry : entries) {
+      if(total <= maxSize * 9 / 10) break;
+      removeDir(entry.path);
+      total -= entry.size;
+    }
+
+    return total;
+  }
+
+  std::string entryPath(std::string key) {
+    return dir + "/" + key.substr(0, 2) + "/" + key;
+  }
+
+public:
+  Cache() {
+    const char *cacheDir = getenv("TULIPP_CACHE_DIR");
+    const char *home = getenv("HOME");
+
+    if(cacheDir) {
+      dir = cacheDir;
+    } else if(home) {
+      dir = std::string(home) + "/.tulipp/cache/tulippcc";
+    }
+
+    const char *cacheSize = getenv("TULIPP_CACHE_SIZE");
+    maxSize = (cacheSize ? atoll(cacheSize) : CACHE_DEFAULT_SIZE) * 1024 * 1024;
+
+    lockFd = -1;
+
+    if(dir != "") {
+      std::string command = "mkdir -p " + dir;
+      if(system(command.c_str())) dir = "";
+    }
+  }
+
+  bool enabled() {
+    return dir != "";
+  }
+
+  bool get(std::string key, std::string object, std::string xml) {
+    std::string entry = entryPath(key);
+
+    if(copyFile(entry + "/object.o", object) && copyFile(entry + "/cfg.xml", xml)) {
+      // mark as recently used
+      utime(entry.c_str(), NULL);
+      updateStats(1, 0, 0);
+      return true;
+    }
+
+    updateStats(0, 1, 0);
+    return false;
+  }
+
+  void put(std::string key, std::string object, std::string xml) {
+    std::string entry = entryPath(key);
+    std::string tmp = entry + ".tmp." + std::to_string((long long)getpid());
+
+    mkdir((dir + "/" + key.substr(0, 2)).c_str(), 0755);
+    if(mkdir(tmp.c_str(), 0755)) return;
+
+    // entries are created under a temporary name and renamed, so that readers never see partial entries
+    if(copyFile(object, tmp + "/object.o") && copyFile(xml, tmp + "/cfg.xml") && !rename(tmp.c_str(), entry.c_str())) {
+      updateStats(0, 0, fileSize(entry + "/object.o") + fileSize(entry + "/cfg.xml"));
+    } else {
+      removeDir(tmp);
+    }
+  }
+
+  void printStats() {
+    lock();
+    Stats stats = readStats();
+    unlock();
+
+    int64_t lookups = stats.hits + stats.misses;
+
+    printf("Cache directory: %s\n", dir.c_str());
+    printf("Hits:            %lld\n", (long long)stats.hits);
+    printf("Misses:          %lld\n", (long long)stats.misses);
+    printf("Hit rate:        %.1f%%\n", lookups ? (100.0 * stats.hits / lookups) : 0.0);
+    printf("Size:            %.1f MB of %.1f MB\n", stats.size / (1024.0 * 1024), maxSize / (1024.0 * 1024));
+  }
+
+  void clear() {
+    lock();
+
+    for(auto sub : listDir(dir)) {
+      if(sub.size() != 2) continue;
+      for(auto name : listDir(dir + "/" + sub)) {
+        removeDir(dir + "/" + sub + "/" + name);
+      }
+      rmdir((dir + "/" + sub).c_str());
+    }
+
+    Stats stats = {0, 0, 0};
+    writeStats(stats);
+
+    unlock();
+  }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool runCommands(std::vector<std::string> commands) {
+  for(auto command : commands) {
+    printf("%s\n", command.c_str());
+    if(system(command.c_str())) return false;
+  }
+  return true;
+}
+
 int main(int argc, char *argv[]) {
   std::vector<std::string> args;
 
@@ -43,6 +427,9 @@ int main(int argc, char *argv[]) {
   std::string optlevel;
 
   bool instrument = false;
+  bool counters = false;
+  bool cacheStats = false;
+  bool cacheClear = false;
 
   int arg = 6;
 
@@ -71,44 +458,107 @@ int main(int argc, char *argv[]) {
     } else if(argstring == std::string("--tulipp-instrument")) {
       instrument = true;
       arg++;
+    } else if(argstring == std::string("--tulipp-loop-counters")) {
+      counters = true;
+      arg++;
+    } else if(argstring == std::string("--tulipp-cache-stats")) {
+      cacheStats = true;
+      arg++;
+    } else if(argstring == std::string("--tulipp-cache-clear")) {
+      cacheClear = true;
+      arg++;
     } else {
       args.push_back(std::string(argv[arg]));
       arg++;
     }
   }
 
-  std::string clangline = std::string(argv[1]) + " ";
+  Cache cache;
+
+  if(cacheStats || cacheClear) {
+    if(!cache.enabled()) {
+      printf("Cache is disabled\n");
+      return 1;
+    }
+    if(cacheClear) cache.clear();
+    if(cacheStats) cache.printStats();
+    return 0;
+  }
+
+  std::string flags;
   for(auto arg : args) {
-    clangline += arg + " ";
-  }
-  clangline += "-Os -target aarch64--none-gnueabi -g -emit-llvm -S " + input;
-  std::string parserline1 = std::string(argv[2]) + " " + base(input) + ".ll -xml " + base(input) + ".xml";
-  std::string parserline2 = std::string(argv[2]) + " " + base(input) + ".ll -ll " + base(input) + "_2.ll";
-  if(instrument) parserline2 += " --instrument";
-  std::string optline = std::string(argv[3]) + " " + optlevel + " " + base(input) + "_2.ll -o " + base(input) + "_3.ll";
-  if(optlevel == std::string("-Os")) optlevel = std::string("-O2");
-  std::string llcline = std::string(argv[4]) + " " + optlevel + " -mcpu=cortex-a53 " + base(input) + "_3.ll -o " + base(input) + ".s";
-  std::string asline = std::string(argv[5]) + " -mcpu=cortex-a53 " + base(input) + ".s -o " + output;
-
-  printf("%s\n", clangline.c_str());
-  if(!system(clangline.c_str())) {
-    printf("%s\n", parserline1.c_str());
-    if(!system(parserline1.c_str())) {
-      printf("%s\n", parserline2.c_str());
-      if(!system(parserline2.c_str())) {
-        printf("%s\n", optline.c_str());
-        if(!system(optline.c_str())) {
-          printf("%s\n", llcline.c_str());
-          if(!system(llcline.c_str())) {
-            printf("%s\n", asline.c_str());
-            if(!system(asline.c_str())) {
-              return 0;
-            }
-          }
-        }
+    flags += arg + " ";
+  }
+
+  // the single process driver is used if available
+  const char *driver = getenv("TULIPP_DRIVER");
+  bool useDriver = driver && strlen(driver);
+
+  std::string xml = base(input) + ".xml";
+
+  // look up object and CFG in the cache
+  std::string key;
+
+  if(cache.enabled() && (input != "") && (output != "")) {
+    std::string ppline = std::string(argv[1]) + " " + flags + "-Os -target aarch64--none-gnueabi -E " + input + " 2> /dev/null";
+
+    Hash hash;
+    hash.add(CACHE_VERSION);
+
+    // the compilation reports preprocessor errors if this fails
+    if(hashCommandOutput(ppline, hash)) {
+      hash.add(flags);
+      hash.add(optlevel);
+      // objects are compiled with -g, so they record the compilation directory
+      char cwd[PATH_MAX];
+      hash.add(getcwd(cwd, sizeof(cwd)) ? cwd : "");
+      hash.add(instrument ? "instrument" : "");
+      hash.add(counters ? "counters" : "");
+      hash.add(useDriver ? fingerprint(driver) : "");
+      for(int i = 1; i <= 5; i++) {
+        hash.add(fingerprint(argv[i]));
+      }
+
+      key = hash.hex();
+
+      if((key != "") && cache.get(key, output, xml)) {
+        printf("Using cached %s\n", output.c_str());
+        return 0;
       }
     }
   }
 
-  return 1;
+  // compile
+  std::vector<std::string> commands;
+
+  if(useDriver) {
+    std::string driverline = std::string(driver) + " " + std::string(argv[1]) + " " + flags + optlevel + " " + input + " -o " + output;
+    if(instrument) driverline += " --tulipp-instrument";
+    if(counters) driverline += " --tulipp-loop-counters";
+    commands.push_back(driverline);
+
+  } else {
+    std::string clangline = std::string(argv[1]) + " " + flags;
+    clangline += "-Os -target aarch64--none-gnueabi -g -emit-llvm -c " + input + " -o " + base(input) + ".bc";
+    std::string parserline = std::string(argv[2]) + " " + base(input) + ".bc -all " + xml + " " + base(input) + "_2.bc";
+    if(instrument) parserline += " --instrument";
+    if(counters) parserline += " --loop-counters";
+    std::string optline = std::string(argv[3]) + " " + optlevel + " " + base(input) + "_2.bc -o - | " +
+      std::string(argv[2]) + " - -bbmap " + base(input) + "_3.bc";
+    if(optlevel == std::string("-Os")) optlevel = std::string("-O2");
+    std::string llcline = std::string(argv[4]) + " " + optlevel + " -mcpu=cortex-a53 " + base(input) + "_3.bc -o " + base(input) + ".s";
+    std::string asline = std::string(argv[5]) + " -mcpu=cortex-a53 " + base(input) + ".s -o " + output;
+
+    commands.push_back(clangline);
+    commands.push_back(parserline);
+    commands.push_back(optline);
+    commands.push_back(llcline);
+    commands.push_back(asline);
+  }
+
+  if(!runCommands(commands)) return 1;
+
+  if(key != "") cache.put(key, output, xml);
+
+  return 0;
 }
@@ -24,8 +24,8 @@
 
 #include <stdint.h>
 
-#define SW_VERSION        SW_VERSION_1_5
-#define SW_VERSION_STRING "V1.5"
+#define SW_VERSION        SW_VERSION_1_6
+#define SW_VERSION_STRING "V1.6"
 
 #define HW_VERSION_2_0 0x20
 #define HW_VERSION_2_1 0x21
@@ -39,6 +39,7 @@
 #define SW_VERSION_1_3 0x13
 #define SW_VERSION_1_4 0x14
 #define SW_VERSION_1_5 0x15
+#define SW_VERSION_1_6 0x16
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -47,6 +48,7 @@
 #define USB_CMD_JTAG_INIT        'j'
 #define USB_CMD_BREAKPOINT       'b'
 #define USB_CMD_START_SAMPLING   's'
+#define USB_CMD_STOP_SAMPLING    'x' // from V1.6
 #define USB_CMD_CAL              'l'
 #define USB_CMD_CAL_SET          'c'
 #define USB_CMD_TEST             't'
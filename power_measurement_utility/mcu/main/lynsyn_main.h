@@ -53,6 +53,7 @@ int64_t calculateTime();
 // global variables
 
 extern volatile bool sampleMode;
+extern volatile bool stopSampling;
 extern volatile bool samplePc;
 extern volatile bool gpioMode;
 extern volatile bool useStartBp;
@@ -42,6 +42,7 @@
 #include "iic.h"
 
 volatile bool sampleMode;
+volatile bool stopSampling;
 volatile bool samplePc;
 volatile bool gpioMode;
 volatile bool useStartBp;
@@ -77,6 +78,7 @@ void panic(const char *fmt, ...) {
 
 int main(void) {
   sampleMode = false;
+  stopSampling = false;
 
   // setup clocks
   CMU_ClockEnable(cmuClock_HFPER, true);
@@ -176,14 +178,23 @@ int main(void) {
 #endif
       }
 
+      // stopped by the host before the stop condition, the host resets the target afterwards
+      bool stopped = false;
+      if(stopSampling) {
+        stopSampling = false;
+        stopped = true;
+        halted = true;
+      }
+
       if(halted) {
 #ifndef USE_SWO
         send = true;
 #endif
         samplePtr->time = -1;
         sampleMode = false;
+        stopSampling = false;
 
-        if(useStopBp) {
+        if(useStopBp && !stopped) {
           coreClearBp(stopCore, STOP_BP);
           coresResume();
         }
@@ -219,6 +219,9 @@ static void startSampling(struct StartSamplingRequestPacket *startSamplingReq) {
 
   printf("Starting sample mode (%llx)\n", startSamplingReq->flags);
 
+  // a stop that arrived as the previous session ended on its own must not stop this one
+  stopSampling = false;
+
   setLed(0);
 
   if(useStartBp) {
@@ -490,6 +493,10 @@ static int UsbDataReceived(USB_Status_TypeDef status, uint32_t xf, uint32_t rema
         startSampling((struct StartSamplingRequestPacket *)req);
         break;
 
+      case USB_CMD_STOP_SAMPLING:
+        if(sampleMode) stopSampling = true;
+        break;
+
       case USB_CMD_CAL:
         calibrate((struct CalibrateRequestPacket *)req);
         break;
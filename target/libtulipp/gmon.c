@@ -41,7 +41,11 @@
 #include <stdbool.h>
 #include <string.h>
 
-#include <ff.h>
+#ifdef TULIPP_HOST
+#include <link.h>
+#endif
+
+#include "writebuf.h"
 
 #ifdef HIPPEROS
 #include <SdMmc.h>
@@ -52,11 +56,10 @@
 #define printf h_printf
 #endif
 
-#define MINUS_ONE_P (-1)
 #define bzero(ptr,size) memset (ptr, 0, size);
 #define ERR(s) write(2, s, sizeof(s))
 
-struct gmonparam _gmonparam = { GMON_PROF_OFF, NULL, 0, NULL, 0, NULL, 0, 0L, 0, 0, 0};
+struct gmonparam _gmonparam = { GMON_PROF_OFF, NULL, 0, { NULL }, 0, 0, 0L, 0, 0, 0};
 static char already_setup = 0; /* flag to indicate if we need to init */
 static int    s_scale;
 /* see profil(2) where this is described (incorrectly) */
@@ -64,8 +67,77 @@ static int    s_scale;
 
 static void moncontrol(int mode);
 
+#ifdef TULIPP_HOST
+static int findLoadBias(struct dl_phdr_info *info, size_t size, void *data) {
+    /* the first object is the executable */
+    *(size_t *)data = info->dlpi_addr;
+    return 1;
+}
+#endif
+
+/*
+ * Difference between run time and link time addresses.  Always 0 on the target,
+ * on the host it is the load address of a position independent executable.
+ * The profile holds link time addresses, so that they match the ELF file.
+ */
+size_t _monLoadBias(void) {
+#ifdef TULIPP_HOST
+    static size_t bias = 0;
+    static bool found = false;
+    if (!found) {
+        dl_iterate_phdr(findLoadBias, &bias);
+        found = true;
+    }
+    return bias;
+#else
+    return 0;
+#endif
+}
+
+/*
+ * Core number, stored in the profile.  On the host the process is one core,
+ * matching the PC sample file.  HIPPEROS runs tasks in user mode, where
+ * MPIDR_EL1 can't be read, and moves them between cores, so the core is
+ * unknown (~0) and the analysis tool asks for it when the profile is loaded
+ */
+static unsigned currentCore(void) {
+#if defined(TULIPP_HOST)
+    return 0;
+#elif defined(HIPPEROS)
+    return ~0;
+#else
+    uint64_t mpidr;
+    asm ("mrs %0, MPIDR_EL1\n":"=r"(mpidr)::);
+    return mpidr & 0xff;
+#endif
+}
+
+/*
+ * Arc table used by the caller.  Each core has its own table, on the host each
+ * thread gets its own, so that threads don't contend for the chains.  Under
+ * HIPPEROS the core is unknown, so all tasks share one table
+ */
+static unsigned currentArcTable(void) {
+#if defined(TULIPP_HOST)
+    static unsigned threads = 0;
+    static __thread unsigned table = ~0;
+    if (table == ~0) {
+        table = __atomic_fetch_add(&threads, 1, __ATOMIC_RELAXED) % GMON_CORES;
+    }
+    return table;
+#elif defined(HIPPEROS)
+    return 0;
+#else
+    return currentCore() % GMON_CORES;
+#endif
+}
+
 static FATFS fatfs;
 
+/* start and end of the loop table, defined by the linker if any module has instrumented loops */
+extern struct tulipp_loop __start_tulipp_loops[] __attribute__((weak));
+extern struct tulipp_loop __stop_tulipp_loops[] __attribute__((weak));
+
 void monstartup (size_t lowpc, size_t highpc) {
     register size_t o;
     char *cp;
@@ -79,7 +151,7 @@ void monstartup (size_t lowpc, size_t highpc) {
     p->highpc = ROUNDUP(highpc, HISTFRACTION * sizeof(HISTCOUNTER));
     p->textsize = p->highpc - p->lowpc;
     p->kcountsize = p->textsize / HISTFRACTION;
-    p->fromssize = p->textsize / HASHFRACTION;
+    p->fromssize = p->textsize / FROMGRANULE * sizeof(uint32_t);
     p->tolimit = p->textsize * ARCDENSITY / 100;
     if (p->tolimit < MINARCS) {
         p->tolimit = MINARCS;
@@ -88,22 +160,19 @@ void monstartup (size_t lowpc, size_t highpc) {
     }
     p->tossize = p->tolimit * sizeof(struct tostruct);
 
-    cp = malloc(p->kcountsize + p->fromssize + p->tossize);
-    if (cp == (char *)MINUS_ONE_P) {
+    cp = malloc(p->kcountsize);
+    if (cp == NULL) {
         ERR("monstartup: out of memory\n");
         return;
     }
 
     /* zero out cp as value will be added there */
-    bzero(cp, p->kcountsize + p->fromssize + p->tossize);
+    bzero(cp, p->kcountsize);
 
-    p->tos = (struct tostruct *)cp;
-    cp += p->tossize;
     p->kcount = (u_short *)cp;
-    cp += p->kcountsize;
-    p->froms = (u_short *)cp;
 
-    p->tos[0].link = 0;
+    /* the arc tables are allocated by the first call on each core */
+    bzero(p->arcs, sizeof(p->arcs));
 
     o = p->highpc - p->lowpc;
     if (p->kcountsize < o) {
@@ -125,37 +194,39 @@ void monstartup (size_t lowpc, size_t highpc) {
         s_scale = SCALE_1_TO_1;
     }
 
-    p->loopcounts = malloc((p->textsize/4) * sizeof(uint64_t));
-    if(!p->loopcounts) {
-      ERR("monstartup: out of memory\n");
-      return;
-    }
-    memset(p->loopcounts, 0, (p->textsize/4) * sizeof(uint64_t));
-
     moncontrol(1); /* start */
 }
 
 bool _mcleanup(unsigned core) {
     static const char gmon_out[] = SDDRIVE "tulipp.gmn";
     int hz;
-    int fromindex;
-    int endfrom;
+    size_t fromindex;
+    size_t endfrom;
     size_t frompc;
-    int toindex;
-    struct rawarc rawarc;
+    uint32_t toindex;
+    int table;
+    size_t bias = _monLoadBias();
+    uint64_t prevpc;
+    struct writebuf *wb;
+    uint64_t *loopcounts;
     struct gmonparam *p = &_gmonparam;
     struct gmonhdr gmonhdr, *hdr;
     const char *proffile;
-    if (p->state != GMON_PROF_ON) {
+    /*
+     * stop profiling.  Only the core that stops it writes the profile, with
+     * the arcs of all cores and the shared loop counters, so every loop and
+     * arc is in one file once
+     */
+    int state = __atomic_exchange_n(&p->state, GMON_PROF_OFF, __ATOMIC_ACQ_REL);
+    if ((state != GMON_PROF_ON) && (state != GMON_PROF_ERROR)) {
     	return false;
     }
 
-    if (p->state == GMON_PROF_ERROR) {
-        ERR("_mcleanup: tos overflow\n");
+    if (state == GMON_PROF_ERROR) {
+        ERR("_mcleanup: tos overflow, arcs are incomplete\n");
     }
 
     hz = 0;
-    moncontrol(0); /* stop */
     proffile = gmon_out;
 
 #ifdef HIPPEROS
@@ -177,50 +248,97 @@ bool _mcleanup(unsigned core) {
     }
 
     hdr = (struct gmonhdr *)&gmonhdr;
-    hdr->lpc = p->lowpc;
-    hdr->hpc = p->highpc;
+    hdr->lpc = p->lowpc - bias;
+    hdr->hpc = p->highpc - bias;
     hdr->ncnt = sizeof(gmonhdr);
-    hdr->version = GMONVERSION;
+    hdr->version = GMONVERSION_COMPACT;
     hdr->core = core;
     hdr->profrate = hz;
 
+    /*
+     * inline loop counters keep counting on other cores after profiling has
+     * stopped, so the counts are read once and the header and the records are
+     * made from the same values
+     */
+    size_t numloops = __stop_tulipp_loops - __start_tulipp_loops;
+    /* one extra entry, malloc(0) may return NULL */
+    loopcounts = malloc((numloops + 1) * sizeof(uint64_t));
+    wb = malloc(sizeof(struct writebuf));
+    if((loopcounts == NULL) || (wb == NULL)) {
+        printf("CALLTRACER: Out of memory\n");
+        free(loopcounts);
+        free(wb);
+        f_close(&fp);
+        return false;
+    }
+
     hdr->loops = 0;
-    for(int i = 0; i < (p->textsize/4); i++) {
-      if(p->loopcounts[i]) {
+    for(size_t i = 0; i < numloops; i++) {
+      loopcounts[i] = __atomic_load_n(__start_tulipp_loops[i].count, __ATOMIC_RELAXED);
+      if(loopcounts[i]) {
         hdr->loops++;
       }
     }
 
-    UINT bw;
+    writeBufInit(wb, &fp);
 
-    f_write(&fp, (char *)hdr, sizeof *hdr, &bw);
+    writeBufData(wb, hdr, sizeof *hdr);
 
-    for(int i = 0; i < (p->textsize/4); i++) {
-      if(p->loopcounts[i]) {
-        uint64_t pc = (i*4) + p->lowpc;
-        f_write(&fp, &pc, sizeof(uint64_t), &bw);
-        f_write(&fp, &(p->loopcounts[i]), sizeof(uint64_t), &bw);
+    /* loops: pc as difference from the previous loop, count */
+    prevpc = hdr->lpc;
+    for(size_t i = 0; i < numloops; i++) {
+      if(loopcounts[i]) {
+        uint64_t pc = (size_t)__start_tulipp_loops[i].addr - bias;
+        writeBufSigned(wb, pc - prevpc);
+        writeBufVarint(wb, loopcounts[i]);
+        prevpc = pc;
       }
     }
 
-    endfrom = p->fromssize / sizeof(*p->froms);
-    for (fromindex = 0; fromindex < endfrom; fromindex++) {
-        if (p->froms[fromindex] == 0) {
+    /*
+     * arcs of all cores, one group per table, tagged with the core that made
+     * the calls.  The reader adds up arcs that appear in more than one group.
+     * Group: core, then per arc frompc as difference from the previous arc,
+     * selfpc relative to lpc and count, then an arc with count 0.  Other cores
+     * may still be adding arcs, so the number of arcs is not known up front
+     */
+    endfrom = p->fromssize / sizeof(uint32_t);
+    for (table = 0; table < GMON_CORES; table++) {
+        struct gmonarcs *arcs = p->arcs[table];
+        if (arcs == NULL) {
             continue;
         }
-        frompc = p->lowpc;
-        frompc += fromindex * HASHFRACTION * sizeof(*p->froms);
-        for (toindex = p->froms[fromindex]; toindex != 0; toindex = p->tos[toindex].link) {
-            rawarc.raw_frompc = frompc;
-            rawarc.raw_selfpc = p->tos[toindex].selfpc;
-            rawarc.raw_count = p->tos[toindex].count;
-            f_write(&fp, &rawarc, sizeof rawarc, &bw);
+        writeBufVarint(wb, arcs->core);
+        prevpc = hdr->lpc;
+        for (fromindex = 0; fromindex < endfrom; fromindex++) {
+            uint32_t head = __atomic_load_n(&arcs->froms[fromindex], __ATOMIC_ACQUIRE);
+            if (head == 0) {
+                continue;
+            }
+            frompc = p->lowpc;
+            frompc += fromindex * FROMGRANULE;
+            for (toindex = head; toindex != 0; toindex = arcs->tos[toindex].link) {
+                writeBufSigned(wb, frompc - bias - prevpc);
+                writeBufSigned(wb, arcs->tos[toindex].selfpc - bias - hdr->lpc);
+                writeBufVarint(wb, __atomic_load_n(&arcs->tos[toindex].count, __ATOMIC_RELAXED));
+                prevpc = frompc - bias;
+            }
         }
+        writeBufSigned(wb, 0);
+        writeBufSigned(wb, 0);
+        writeBufVarint(wb, 0);
     }
 
+    bool written = writeBufFlush(wb);
+    if(!written) {
+        printf("CALLTRACER: Could not write\n");
+    }
+    free(wb);
+    free(loopcounts);
+
     f_close(&fp);
 
-    return true;
+    return written;
 }
 
 /*
@@ -234,127 +352,129 @@ static void moncontrol(int mode) {
     if (mode) {
         /* start */
         //profil((char *)p->kcount, p->kcountsize, p->lowpc, s_scale);
-        p->state = GMON_PROF_ON;
+        __atomic_store_n(&p->state, GMON_PROF_ON, __ATOMIC_RELEASE);
     } else {
         /* stop */
         //profil((char *)0, 0, 0, 0);
-        p->state = GMON_PROF_OFF;
+        __atomic_store_n(&p->state, GMON_PROF_OFF, __ATOMIC_RELEASE);
     }
 }
 
-void _mcount_internal(u_short *frompcindex, u_short *selfpc) {
-  register struct tostruct    *top;
-  register struct tostruct    *prevtop;
-  register long            toindex;
+/*
+ * Arc table with the given index, allocated on first use, so only the cores
+ * that make calls pay for a table.  If two cores race for the same table, the
+ * loser frees its copy and uses the winner's.
+ */
+static struct gmonarcs *arcTable(unsigned table) {
   struct gmonparam *p = &_gmonparam;
+  struct gmonarcs **slot = &p->arcs[table];
+  struct gmonarcs *arcs = __atomic_load_n(slot, __ATOMIC_ACQUIRE);
 
-  if (!already_setup) {
-    already_setup = 1;
-#ifdef HIPPEROS
+  if (arcs == NULL) {
+    struct gmonarcs *newArcs = calloc(1, sizeof(struct gmonarcs) + p->tossize + p->fromssize);
+    if (newArcs == NULL) {
+      return NULL;
+    }
+    newArcs->core = currentCore();
+    newArcs->tos = (struct tostruct *)(newArcs + 1);
+    newArcs->froms = (uint32_t *)((char *)newArcs->tos + p->tossize);
+
+    if (__atomic_compare_exchange_n(slot, &arcs, newArcs, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+      arcs = newArcs;
+    } else {
+      free(newArcs);
+    }
+  }
+
+  return arcs;
+}
+
+void _mcount_internal(size_t frompc, size_t selfpc) {
+  struct gmonparam *p = &_gmonparam;
+  struct gmonarcs *arcs;
+  struct tostruct *top = NULL;
+  uint32_t *from;
+  uint32_t head;
+  uint32_t toindex = 0;
+
+  if (!__atomic_load_n(&already_setup, __ATOMIC_ACQUIRE) &&
+      !__atomic_exchange_n(&already_setup, 1, __ATOMIC_ACQ_REL)) {
+#if defined(HIPPEROS)
     extern char __init_start;
     extern char _rodata_start;
     monstartup((size_t)&__init_start, (size_t)&_rodata_start);
+#elif defined(TULIPP_HOST)
+    extern char __executable_start;
+    extern char etext;
+    monstartup((size_t)&__executable_start, (size_t)&etext);
 #else
     extern char __rodata_start;
     monstartup(0x0, (size_t)&__rodata_start);
 #endif
   }
   /*
-   *    check that we are profiling
-   *    and that we aren't recursively invoked.
+   *    check that we are profiling.  The insert below is lock-free,
+   *    so recursive invocations need no guard.
    */
-  if (p->state!=GMON_PROF_ON) {
-    goto out;
+  if (__atomic_load_n(&p->state, __ATOMIC_ACQUIRE) != GMON_PROF_ON) {
+    return;
   }
-  p->state++;
   /*
-   *    check that frompcindex is a reasonable pc value.
+   *    check that frompc is a reasonable pc value.
    *    for example:    signal catchers get called from the stack,
    *            not from text space.  too bad.
    */
-  frompcindex = (u_short*)((long)frompcindex - (long)p->lowpc);
-  if ((unsigned long)frompcindex > p->textsize) {
-      goto done;
+  frompc -= p->lowpc;
+  if (frompc >= p->textsize) {
+    return;
   }
-  frompcindex = (u_short*)&p->froms[((long)frompcindex) / (HASHFRACTION * sizeof(*p->froms))];
-  toindex = *frompcindex;
-  if (toindex == 0) {
+  arcs = arcTable(currentArcTable());
+  if (arcs == NULL) {
+    goto overflow;
+  }
+  from = &arcs->froms[frompc / FROMGRANULE];
+
+  for (;;) {
     /*
-    *    first time traversing this arc
-    */
-    toindex = ++p->tos[0].link; /* the link of tos[0] points to the last used record in the array */
-    if (toindex >= p->tolimit) { /* more tos[] entries than we can handle! */
-        goto overflow;
+     *    look for the arc in the chain.  Linked entries never change
+     *    their link or selfpc, so the chain can be walked while other
+     *    cores prepend to it.
+     */
+    head = __atomic_load_n(from, __ATOMIC_ACQUIRE);
+    for (uint32_t i = head; i != 0; i = arcs->tos[i].link) {
+      if (arcs->tos[i].selfpc == selfpc) {
+        __atomic_fetch_add(&arcs->tos[i].count, 1, __ATOMIC_RELAXED);
+        return;
       }
-    *frompcindex = toindex;
-    top = &p->tos[toindex];
-    top->selfpc = (size_t)selfpc;
-    top->count = 1;
-    top->link = 0;
-    goto done;
-  }
-  top = &p->tos[toindex];
-  if (top->selfpc == (size_t)selfpc) {
+    }
     /*
-     *    arc at front of chain; usual case.
+     *    first time traversing this arc, allocate a new tostruct
+     *    (once, it is reused if the insert has to be retried)
+     *    and link it to the head of the chain.
      */
-    top->count++;
-    goto done;
-  }
-  /*
-   *    have to go looking down chain for it.
-   *    top points to what we are looking at,
-   *    prevtop points to previous top.
-   *    we know it is not at the head of the chain.
-   */
-  for (; /* goto done */; ) {
-    if (top->link == 0) {
-      /*
-       *    top is end of the chain and none of the chain
-       *    had top->selfpc == selfpc.
-       *    so we allocate a new tostruct
-       *    and link it to the head of the chain.
-       */
-      toindex = ++p->tos[0].link;
-      if (toindex >= p->tolimit) {
+    if (toindex == 0) {
+      /* the link of tos[0] points to the last used record in the array */
+      toindex = __atomic_add_fetch(&arcs->tos[0].link, 1, __ATOMIC_RELAXED);
+      if (toindex >= p->tolimit) { /* more tos[] entries than we can handle! */
         goto overflow;
       }
-      top = &p->tos[toindex];
-      top->selfpc = (size_t)selfpc;
+      top = &arcs->tos[toindex];
+      top->selfpc = selfpc;
       top->count = 1;
-      top->link = *frompcindex;
-      *frompcindex = toindex;
-      goto done;
     }
-    /*
-     *    otherwise, check the next arc on the chain.
-     */
-    prevtop = top;
-    top = &p->tos[top->link];
-    if (top->selfpc == (size_t)selfpc) {
-      /*
-       *    there it is.
-       *    increment its count
-       *    move it to the head of the chain.
-       */
-      top->count++;
-      toindex = prevtop->link;
-      prevtop->link = top->link;
-      top->link = *frompcindex;
-      *frompcindex = toindex;
-      goto done;
+    top->link = head;
+    if (__atomic_compare_exchange_n(from, &head, toindex, false, __ATOMIC_RELEASE, __ATOMIC_RELAXED)) {
+      return;
     }
+    /* another core changed the chain, look again */
   }
-  done:
-    p->state--;
-    /* and fall through */
-  out:
-    return;        /* normal return restores saved registers */
+
   overflow:
-    p->state++; /* halt further profiling */
-    #define    TOLIMIT    "mcount: tos overflow\n"
-    write (2, TOLIMIT, sizeof(TOLIMIT));
-  goto out;
+    if (__atomic_exchange_n(&p->state, GMON_PROF_ERROR, __ATOMIC_ACQ_REL) == GMON_PROF_ON) {
+      /* halt further profiling */
+      #define    TOLIMIT    "mcount: tos overflow\n"
+      write (2, TOLIMIT, sizeof(TOLIMIT));
+    }
 }
 
 void _monInit(void) {
@@ -365,35 +485,26 @@ void _monInit(void) {
 ///////////////////////////////////////////////////////////////////////////////
 
 void __tulipp_func_enter (void *this_fn, void *call_site) {
-  _mcount_internal(call_site, this_fn);
+  _mcount_internal((size_t)call_site, (size_t)this_fn);
 }
  
 void __tulipp_loop_header (void *loopAddr) {
 }
  
-void __tulipp_loop_body (void *loopAddr) {
+void __tulipp_loop_count (uint64_t *counter) {
   struct gmonparam *p = &_gmonparam;
 
-  if (p->state == GMON_PROF_ON) {
-    struct gmonparam *p = &_gmonparam;
-
-    if(((size_t)loopAddr >= p->lowpc) && ((size_t)loopAddr <= p->highpc)) {
-      unsigned index = ((size_t)loopAddr - p->lowpc)/4;
-      p->loopcounts[index]++;
-    }
+  if (__atomic_load_n(&p->state, __ATOMIC_ACQUIRE) == GMON_PROF_ON) {
+#ifdef TULIPP_HOST
+    __atomic_fetch_add(counter, 1, __ATOMIC_RELAXED);
+#else
+    (*counter)++;
+#endif
   }
 }
  
 void __tulipp_exit(void) {
-#ifdef HIPPEROS
-  unsigned core = ~0; // FIXME
-#else
-  uint64_t mpidr;
-  asm ("mrs %0, MPIDR_EL1\n":"=r"(mpidr)::);
-  unsigned core = mpidr & 0xff;
-#endif
-
-  if(_mcleanup(core)) {
+  if(_mcleanup(currentCore())) {
     printf("CALLTRACER: Call trace file written\n");
   }
 }
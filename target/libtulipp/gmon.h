@@ -36,6 +36,8 @@
 #include <stdint.h>
 #include <stdbool.h>
 
+#include "profformat.h"
+
 /*
  * This file is taken from Cygwin distribution. Please keep it in sync.
  * The differences should be within __MINGW32__ guard.
@@ -80,7 +82,6 @@ struct gmonhdr {
  int loops;
  int spare; /* reserved */
 };
-#define GMONVERSION 0x00051879
 
 /*
  * histogram counters are unsigned shorts (according to the kernel).
@@ -122,18 +123,46 @@ struct gmonhdr {
  */
 #define HASHFRACTION 2
 
+/*
+ * bytes of text space covered by each from hash bucket.  The buckets hold
+ * 32 bit indices, but keep the granularity of the original 16 bit buckets.
+ */
+#define FROMGRANULE (HASHFRACTION * sizeof(uint16_t))
+
 /*
  * percent of text space to allocate for tostructs with a minimum.
  */
 #define ARCDENSITY 2 /* this is in percentage, relative to text size! */
 #define MINARCS 50
-#define MAXARCS ((1 << (8 * sizeof(HISTCOUNTER))) - 2)
+#define MAXARCS (UINT32_MAX - 1)
+
+/*
+ * number of arc tables.  Each core records arcs in its own table, selected by
+ * core number modulo GMON_CORES.  On the host each thread gets a table, modulo
+ * GMON_CORES
+ */
+#ifdef TULIPP_HOST
+#define GMON_CORES 16
+#else
+#define GMON_CORES 4
+#endif
 
 struct tostruct {
  size_t selfpc; /* callee address/program counter. The caller address is in froms[] array which points to tos[] array */
  long count; /* how many times it has been called */
- uint16_t link; /* link to next entry in hash table. For tos[0] this points to the last used entry */
- uint16_t pad; /* additional padding bytes, to have entries 4byte aligned */
+ uint32_t link; /* link to next entry in hash table. For tos[0] this points to the last used entry */
+ uint32_t pad; /* additional padding bytes, to have entries 8byte aligned */
+};
+
+/*
+ * arc table of one core.  Entries are only ever prepended to a froms[] chain
+ * with compare-and-swap, and never move once linked, so several cores may
+ * share a table without locking.
+ */
+struct gmonarcs {
+ unsigned core; /* core that allocated the table, written with its arcs */
+ uint32_t *froms; /* array of hashed 'from' addresses. The 32bit value is an index into the tos[] array */
+ struct tostruct *tos; /* to struct, contains histogram counter */
 };
 
 /*
@@ -159,18 +188,25 @@ struct gmonparam {
  int state;
  uint16_t *kcount; /* histogram PC sample array */
  size_t kcountsize; /* size of kcount[] array in bytes */
- uint16_t *froms; /* array of hashed 'from' addresses. The 16bit value is an index into the tos[] array */
+ struct gmonarcs *arcs[GMON_CORES]; /* per-core arc tables, allocated on the first call made on the core */
  size_t fromssize; /* size of froms[] array in bytes */
- struct tostruct *tos; /* to struct, contains histogram counter */
  size_t tossize; /* size of tos[] array in bytes */
  long tolimit;
  size_t lowpc; /* low program counter of area */
  size_t highpc; /* high program counter */
  size_t textsize; /* code size */
- uint64_t *loopcounts;
 };
 extern struct gmonparam _gmonparam;
 
+/*
+ * Loop table made by the instrumentation when inline loop counters are used.
+ * The entries are placed in section tulipp_loops, one per loop.
+ */
+struct tulipp_loop {
+    void *addr; /* address of the loop latch */
+    uint64_t *count; /* counter incremented by the latch, shared by all threads and cores and written once */
+};
+
 /*
  * Possible states of profiling.
  */
@@ -183,5 +219,6 @@ void _mcount(void);
 
 bool _mcleanup(unsigned core); /* routine to be called to write gmon.out file */
 void _monInit(void); /* initialization routine */
+size_t _monLoadBias(void); /* run time minus link time address */
 
 #endif /* !_SYS_GMONH_ */
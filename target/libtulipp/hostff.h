@@ -0,0 +1,48 @@
+/*
+ * Minimal stand-in for the FatFs API used by libtulipp, for host builds.
+ * Files are written through stdio, SDDRIVE is the directory prefix.
+ */
+
+#ifndef HOSTFF_H
+#define HOSTFF_H
+
+#include <stdio.h>
+
+typedef int FRESULT;
+typedef unsigned int UINT;
+
+typedef struct {
+  int dummy;
+} FATFS;
+
+typedef struct {
+  FILE *fp;
+} FIL;
+
+#define FR_OK 0
+#define FR_DISK_ERR 1
+#define FR_NO_FILE 4
+
+#define FA_WRITE 0x02
+#define FA_CREATE_ALWAYS 0x08
+#define FA_OPEN_ALWAYS 0x10
+
+static inline FRESULT f_mount(FATFS *fs, const char *path, int opt) {
+  return FR_OK;
+}
+
+static inline FRESULT f_open(FIL *fil, const char *path, int mode) {
+  fil->fp = fopen(path, "wb");
+  return fil->fp ? FR_OK : FR_NO_FILE;
+}
+
+static inline FRESULT f_write(FIL *fil, const void *buf, UINT btw, UINT *bw) {
+  *bw = fwrite(buf, 1, btw, fil->fp);
+  return (*bw == btw) ? FR_OK : FR_DISK_ERR;
+}
+
+static inline FRESULT f_close(FIL *fil) {
+  return fclose(fil->fp) ? FR_DISK_ERR : FR_OK;
+}
+
+#endif
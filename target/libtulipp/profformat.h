@@ -0,0 +1,34 @@
+/*
+ * Versions of the profile files written by libtulipp.  Shared with the
+ * analysis tool, which reads the files.
+ */
+
+#ifndef PROFFORMAT_H
+#define PROFFORMAT_H
+
+/*
+ * Call graph file (tulipp.gmn), starts with struct gmonhdr.  The original
+ * version is followed by fixed size loop records and struct rawarc records.
+ */
+#define GMONVERSION 0x00051879
+
+/*
+ * Compact version: the header is followed by LEB128 varints instead of fixed
+ * size records.  Per loop zigzag(pc - previous loop pc) and count.  Then the
+ * arcs in groups, one per core: the core number, per arc
+ * zigzag(frompc - previous frompc), zigzag(selfpc - lpc) and count, and an arc
+ * with count 0 at the end of the group.  The first differences of the loops
+ * and of each group are taken from lpc.
+ */
+#define GMONVERSION_COMPACT 0x0005187b
+
+/*
+ * Compact PC sample file: PROFMAGIC and PROFVERSION bytes, then the same
+ * fields as the original format up to the sample count, then per sample
+ * varint(pc - previous pc), varint(ticks) and the average current as a double.
+ * The original format starts with the core number, which is never PROFMAGIC.
+ */
+#define PROFMAGIC 0xff
+#define PROFVERSION 1
+
+#endif
@@ -0,0 +1,168 @@
+/*
+ * Host multithreaded stress test of the call arc tables.  Many threads record
+ * the same and different arcs at the same time through __tulipp_func_enter,
+ * then the arc counts in the written profile are compared with a reference
+ * computed from the call pattern.
+ *
+ * Usage: arc_stress
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <pthread.h>
+
+#include "../gmon.h"
+
+void __tulipp_func_enter(void *this_fn, void *call_site);
+void __tulipp_exit(void);
+
+#define THREADS 40
+#define SITES 2000
+#define CALLEES 7
+#define ROUNDS 200
+
+/* fake call sites and callees are addresses in the text, which is padded to fit all their arcs */
+#define SETUP_SITE 4
+#define SITE(s) (8 + (s) * 4)
+#define CALLEE(s, c) (64 + (((s) * 5 + (c)) % SITES) * 16 + (c))
+
+__asm__(".text\n.skip 0x100000\n");
+
+extern char __executable_start[];
+
+/* address at the given offset in the text */
+static void *text(uintptr_t offset) {
+  return (void*)((uintptr_t)__executable_start + offset);
+}
+
+static long reference[SITES][CALLEES];
+static long counted[SITES][CALLEES];
+
+static int callees(int site, long thread) {
+  return (site + thread) % CALLEES + 1;
+}
+
+static void *worker(void *arg) {
+  long thread = (long)arg;
+
+  for(int r = 0; r < ROUNDS; r++) {
+    for(int s = 0; s < SITES; s++) {
+      for(int c = 0; c < callees(s, thread); c++) {
+        __tulipp_func_enter(text(CALLEE(s, c)), text(SITE(s)));
+      }
+    }
+  }
+
+  return NULL;
+}
+
+static uint64_t readVarint(FILE *fp) {
+  uint64_t value = 0;
+  int c;
+  for(int shift = 0; (shift < 64) && ((c = fgetc(fp)) != EOF); shift += 7) {
+    value |= (uint64_t)(c & 0x7f) << shift;
+    if(!(c & 0x80)) break;
+  }
+  return value;
+}
+
+static int64_t readSigned(FILE *fp) {
+  uint64_t value = readVarint(fp);
+  return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+}
+
+int main(void) {
+  pthread_t threads[THREADS];
+
+  /* the first call sets up profiling */
+  __tulipp_func_enter(text(CALLEE(0, 0)), text(SETUP_SITE));
+
+  for(long t = 0; t < THREADS; t++) {
+    pthread_create(&threads[t], NULL, worker, (void*)t);
+  }
+  for(int t = 0; t < THREADS; t++) {
+    pthread_join(threads[t], NULL);
+  }
+
+  __tulipp_exit();
+
+  long total = 0;
+  for(long t = 0; t < THREADS; t++) {
+    for(int s = 0; s < SITES; s++) {
+      for(int c = 0; c < callees(s, t); c++) {
+        reference[s][c] += ROUNDS;
+        total += ROUNDS;
+      }
+    }
+  }
+
+  FILE *fp = fopen("tulipp.gmn", "rb");
+  if(!fp) {
+    printf("FAIL: profile opened\n");
+    return 1;
+  }
+
+  struct gmonhdr hdr;
+  if((fread(&hdr, sizeof(hdr), 1, fp) != 1) || (hdr.version != GMONVERSION_COMPACT) || (hdr.loops != 0)) {
+    printf("FAIL: header read\n");
+    return 1;
+  }
+
+  long arcs = 0;
+  long bad = 0;
+  long countedTotal = 0;
+  uint64_t frompc = hdr.lpc;
+  bool inGroup = false;
+
+  while(fgetc(fp) != EOF) {
+    fseek(fp, -1, SEEK_CUR);
+
+    /* groups of arcs, one per core, the host process is core 0 */
+    if(!inGroup) {
+      if(readVarint(fp) != 0) bad++;
+      frompc = hdr.lpc;
+      inGroup = true;
+      continue;
+    }
+
+    frompc += readSigned(fp);
+    uint64_t selfpc = hdr.lpc + readSigned(fp);
+    uint64_t count = readVarint(fp);
+
+    if(count == 0) {
+      inGroup = false;
+      continue;
+    }
+
+    long from = frompc - hdr.lpc;
+    long self = selfpc - hdr.lpc;
+    if(from == SETUP_SITE) continue;
+
+    int s = (from - SITE(0)) / 4;
+    int c = self % 16;
+    if((s < 0) || (s >= SITES) || (c >= CALLEES) || (self != CALLEE(s, c))) {
+      bad++;
+      continue;
+    }
+
+    counted[s][c] += count;
+    countedTotal += count;
+    arcs++;
+  }
+
+  fclose(fp);
+  remove("tulipp.gmn");
+
+  long mismatches = 0;
+  for(int s = 0; s < SITES; s++) {
+    for(int c = 0; c < CALLEES; c++) {
+      if(counted[s][c] != reference[s][c]) mismatches++;
+    }
+  }
+
+  printf("%ld arc records, %ld/%ld calls, %ld unknown arcs, %ld mismatches\n", arcs, countedTotal, total, bad, mismatches);
+  printf("%s: arc counts match the reference\n", (bad || mismatches) ? "FAIL" : "PASS");
+
+  return bad || mismatches;
+}
@@ -0,0 +1,110 @@
+/*
+ * Host unit test of the loop table.  Puts entries in section tulipp_loops the
+ * way the instrumentation does, counts through __tulipp_loop_count and checks
+ * that _mcleanup writes one record per loop with a non-zero count.
+ *
+ * Usage: loop_table
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "../gmon.h"
+
+void monstartup(size_t lowpc, size_t highpc);
+void __tulipp_loop_count(uint64_t *counter);
+
+#define LOOPS 3
+
+static void loop0(void) {}
+static void loop1(void) {}
+static void loop2(void) {}
+
+static uint64_t counters[LOOPS];
+
+static const struct tulipp_loop loopTable[LOOPS] __attribute__((section("tulipp_loops"), used)) = {
+  { (void*)loop0, &counters[0] },
+  { (void*)loop1, &counters[1] },
+  { (void*)loop2, &counters[2] },
+};
+
+/* loop 1 never runs, so it is left out of the file */
+static const uint64_t expected[LOOPS] = { 1000, 0, 7 };
+
+static int failed = 0;
+
+static void check(bool ok, const char *what) {
+  printf("%s: %s\n", ok ? "PASS" : "FAIL", what);
+  if(!ok) failed = 1;
+}
+
+static uint64_t readVarint(FILE *fp) {
+  uint64_t value = 0;
+  int c;
+  for(int shift = 0; (shift < 64) && ((c = fgetc(fp)) != EOF); shift += 7) {
+    value |= (uint64_t)(c & 0x7f) << shift;
+    if(!(c & 0x80)) break;
+  }
+  return value;
+}
+
+static int64_t readSigned(FILE *fp) {
+  uint64_t value = readVarint(fp);
+  return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+}
+
+int main(void) {
+  extern char __executable_start;
+  extern char etext;
+
+  _monInit();
+
+  /* nothing is counted before profiling starts */
+  __tulipp_loop_count(&counters[0]);
+  check(counters[0] == 0, "no counting while profiling is off");
+
+  monstartup((size_t)&__executable_start, (size_t)&etext);
+
+  for(int i = 0; i < LOOPS; i++) {
+    for(uint64_t n = 0; n < expected[i]; n++) {
+      __tulipp_loop_count(loopTable[i].count);
+    }
+  }
+  check((counters[0] == expected[0]) && (counters[1] == expected[1]) && (counters[2] == expected[2]), "loops counted");
+
+  check(_mcleanup(0), "profile written");
+
+  /* the shared counters are in one profile only, written by the core that stops profiling */
+  check(!_mcleanup(1), "profile written once");
+
+  FILE *fp = fopen("tulipp.gmn", "rb");
+  check(fp != NULL, "profile opened");
+  if(!fp) return 1;
+
+  struct gmonhdr hdr;
+  check(fread(&hdr, sizeof(hdr), 1, fp) == 1, "header read");
+  check(hdr.version == GMONVERSION_COMPACT, "compact version");
+  check(hdr.loops == 2, "one loop record per counted loop");
+
+  size_t bias = _monLoadBias();
+  uint64_t prevpc = hdr.lpc;
+  int loop = 0;
+  for(int i = 0; i < hdr.loops; i++) {
+    uint64_t pc = prevpc + readSigned(fp);
+    uint64_t count = readVarint(fp);
+    prevpc = pc;
+
+    /* records are in table order and skip the loops that never ran */
+    while((loop < LOOPS) && (expected[loop] == 0)) loop++;
+    check((loop < LOOPS) && (pc == (size_t)loopTable[loop].addr - bias), "loop address");
+    check((loop < LOOPS) && (count == expected[loop]), "loop count");
+    loop++;
+  }
+
+  fclose(fp);
+  remove("tulipp.gmn");
+
+  return failed;
+}
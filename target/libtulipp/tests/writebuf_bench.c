@@ -0,0 +1,137 @@
+/*
+ * Host benchmark of the buffered profile writer.  Writes the same arc records
+ * through the file-backed stand-in for FatFs, once with one f_write per field
+ * like the original writer and once through a writebuf.  The stdio buffer of
+ * the file is turned off, so that every f_write reaches the file like it
+ * reaches the SD card on the target, where each write that doesn't cover
+ * whole sectors costs a sector read-modify-write.
+ *
+ * Usage: writebuf_bench [records]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "../writebuf.h"
+
+struct record {
+  uint64_t frompc;
+  uint64_t selfpc;
+  int64_t count;
+};
+
+struct result {
+  double seconds;
+  unsigned long writes;
+  unsigned long partialWrites;
+  long bytes;
+};
+
+static double now(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static FIL *openFile(FIL *fp, const char *name) {
+  if(f_open(fp, name, FA_OPEN_ALWAYS | FA_CREATE_ALWAYS | FA_WRITE) != FR_OK) {
+    printf("Could not open %s\n", name);
+    exit(1);
+  }
+  setvbuf(fp->fp, NULL, _IONBF, 0);
+  return fp;
+}
+
+static void closeFile(FIL *fp, struct result *result) {
+  result->bytes = ftell(fp->fp);
+  f_close(fp);
+}
+
+static void writeField(FIL *fp, const void *data, UINT size, struct result *result) {
+  UINT bw;
+  long pos = ftell(fp->fp);
+  f_write(fp, data, size, &bw);
+  result->writes++;
+  if((pos % WRITEBUF_SECTOR) || (size % WRITEBUF_SECTOR)) {
+    result->partialWrites++;
+  }
+}
+
+static void unbuffered(const struct record *records, unsigned n, struct result *result) {
+  FIL fp;
+  double start = now();
+
+  openFile(&fp, "writebuf_bench_unbuffered.out");
+  for(unsigned i = 0; i < n; i++) {
+    writeField(&fp, &records[i].frompc, sizeof(uint64_t), result);
+    writeField(&fp, &records[i].selfpc, sizeof(uint64_t), result);
+    writeField(&fp, &records[i].count, sizeof(int64_t), result);
+  }
+  closeFile(&fp, result);
+
+  result->seconds = now() - start;
+}
+
+static void buffered(const struct record *records, unsigned n, struct result *result) {
+  FIL fp;
+  struct writebuf *wb = malloc(sizeof(struct writebuf));
+  double start = now();
+
+  openFile(&fp, "writebuf_bench_buffered.out");
+  writeBufInit(wb, &fp);
+  uint64_t prevpc = 0;
+  for(unsigned i = 0; i < n; i++) {
+    writeBufSigned(wb, records[i].frompc - prevpc);
+    writeBufSigned(wb, records[i].selfpc);
+    writeBufVarint(wb, records[i].count);
+    prevpc = records[i].frompc;
+  }
+  if(!writeBufFlush(wb)) {
+    printf("Could not write\n");
+  }
+  closeFile(&fp, result);
+
+  result->seconds = now() - start;
+
+  /* only the last write may be partial */
+  result->writes = (result->bytes + WRITEBUF_SIZE - 1) / WRITEBUF_SIZE;
+  result->partialWrites = (result->bytes % WRITEBUF_SIZE) ? 1 : 0;
+
+  free(wb);
+}
+
+static void print(const char *name, struct result *result) {
+  printf("%-12s %8.3f s %10lu writes %10lu partial sector writes %10ld bytes\n",
+         name, result->seconds, result->writes, result->partialWrites, result->bytes);
+}
+
+int main(int argc, char *argv[]) {
+  unsigned n = argc > 1 ? strtoul(argv[1], NULL, 0) : 200000;
+
+  /* arcs sorted by caller, with callees spread over the text, like _mcleanup writes them */
+  struct record *records = malloc(n * sizeof(struct record));
+  srand(1);
+  for(unsigned i = 0; i < n; i++) {
+    records[i].frompc = 0x100000 + i * 12;
+    records[i].selfpc = rand() % 0x400000;
+    records[i].count = rand() % 100000;
+  }
+
+  struct result resultUnbuffered = { 0, 0, 0, 0 };
+  struct result resultBuffered = { 0, 0, 0, 0 };
+
+  unbuffered(records, n, &resultUnbuffered);
+  buffered(records, n, &resultBuffered);
+
+  printf("%u arc records\n", n);
+  print("unbuffered", &resultUnbuffered);
+  print("writebuf", &resultBuffered);
+
+  remove("writebuf_bench_unbuffered.out");
+  remove("writebuf_bench_buffered.out");
+  free(records);
+
+  return 0;
+}
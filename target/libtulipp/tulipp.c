@@ -1,6 +1,6 @@
 #include "tulipp.h"
 
-#ifndef HIPPEROS
+#if !defined(HIPPEROS) && !defined(TULIPP_HOST)
 
 #include <stdint.h>
 #include <stdbool.h>
@@ -16,10 +16,10 @@
 #include <xgpiops.h>
 #include <xil_cache.h>
 
-#include <ff.h>
-
 #include <sds_lib.h>
 
+#include "writebuf.h"
+
 #include "gmon.h"
 
 #include "interruptWrapper.h"
@@ -425,17 +425,26 @@ void stopProfiler(char *filename) {
   double unknownCurrentAvg = unknownCurrent / (double)unknownTicks;
   double unknownRuntime = unknownTicks * pcSamplerPeriod;
 
-  UINT bw;
+  uint8_t magic = PROFMAGIC;
+  uint8_t version = PROFVERSION;
 
-  f_write(&fp, &core, sizeof(uint8_t), &bw);
-  f_write(&fp, &sensor, sizeof(uint8_t), &bw);
-  for(int i = 0; i < 14; i++) {
-    f_write(&fp, &(calData[i]), sizeof(double), &bw);
+  struct writebuf *wb = malloc(sizeof(struct writebuf));
+  if(wb == NULL) {
+    printf("PROFILER: Out of memory\n");
+    f_close(&fp);
+    return;
   }
-  f_write(&fp, &pcSamplerPeriod, sizeof(double), &bw);
+  writeBufInit(wb, &fp);
+
+  writeBufData(wb, &magic, sizeof(uint8_t));
+  writeBufData(wb, &version, sizeof(uint8_t));
+  writeBufData(wb, &core, sizeof(uint8_t));
+  writeBufData(wb, &sensor, sizeof(uint8_t));
+  writeBufData(wb, calData, 14 * sizeof(double));
+  writeBufData(wb, &pcSamplerPeriod, sizeof(double));
 
-  f_write(&fp, &unknownCurrentAvg, sizeof(double), &bw);
-  f_write(&fp, &unknownRuntime, sizeof(double), &bw);
+  writeBufData(wb, &unknownCurrentAvg, sizeof(double));
+  writeBufData(wb, &unknownRuntime, sizeof(double));
 
   uint32_t count = 0;
   for(int i = 0; i < bufSize; i++) {
@@ -444,20 +453,27 @@ void stopProfiler(char *filename) {
     }
   }
 
-  f_write(&fp, &count, sizeof(uint32_t), &bw);
+  writeBufData(wb, &count, sizeof(uint32_t));
 
+  uint64_t prevPc = 0;
   for(int i = 0; i < bufSize; i++) {
     if((currentBuf[i] != 0) || (ticksBuf[i] != 0)) {
       uint64_t pc = (uint64_t)i * (uint64_t)4 + pcStart;
       double current = currentBuf[i] / (double)ticksBuf[i];
-      double runtime = ticksBuf[i] * pcSamplerPeriod;
 
-      f_write(&fp, &pc, sizeof(uint64_t), &bw);
-      f_write(&fp, &current, sizeof(double), &bw);
-      f_write(&fp, &runtime, sizeof(double), &bw);
+      writeBufVarint(wb, pc - prevPc);
+      writeBufVarint(wb, ticksBuf[i]);
+      writeBufData(wb, &current, sizeof(double));
+
+      prevPc = pc;
     }
   }
 
+  if(!writeBufFlush(wb)) {
+    printf("PROFILER: Could not write\n");
+  }
+  free(wb);
+
   f_close(&fp);
 
   printf("PROFILER: Done\n");
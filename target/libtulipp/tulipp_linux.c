@@ -0,0 +1,273 @@
+#include "tulipp.h"
+
+#ifdef TULIPP_HOST
+
+/*
+ * Linux host implementation of the profiler API.  PC sampling uses a SIGPROF
+ * interval timer, performance counters use perf_event_open on the calling thread.
+ * There is no power sensor, so all samples have zero current.
+ *
+ * Performance counters and call arcs are per thread.  Loop counters are not: the
+ * loop table has one counter per loop in the program, so all threads increment
+ * the same counter and the loop counts in the profile are for the whole process.
+ * The profile is written once, by the thread that stops profiling.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <ucontext.h>
+#include <sys/time.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+#include "gmon.h"
+#include "writebuf.h"
+
+#define PERF_COUNTERS 6
+
+static uint64_t pcStart;
+static int bufSize;
+static uint64_t *ticksBuf;
+static uint64_t unknownTicks;
+
+static volatile bool profilerActive;
+
+static double pcSamplerPeriod;
+
+static FATFS fatfs;
+
+static __thread int cycleFd = -1;
+static __thread int counterFd[PERF_COUNTERS] = { -1, -1, -1, -1, -1, -1 };
+
+static void sampleHandler(int sig, siginfo_t *info, void *context) {
+  if(profilerActive) {
+    ucontext_t *uc = (ucontext_t*)context;
+
+#if defined(__x86_64__)
+    uint64_t pc = uc->uc_mcontext.gregs[REG_RIP];
+#elif defined(__aarch64__)
+    uint64_t pc = uc->uc_mcontext.pc;
+#else
+    uint64_t pc = 0;
+#endif
+
+    int index = (pc - pcStart)/4;
+    if((pc >= pcStart) && (index < bufSize)) {
+      ticksBuf[index]++;
+    } else {
+      unknownTicks++;
+    }
+  }
+}
+
+static int perfEventOpen(uint32_t type, uint64_t config) {
+  struct perf_event_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = type;
+  attr.config = config;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+
+  return syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+uint64_t getCycleCounter(void) {
+  uint64_t result = 0;
+  if((cycleFd < 0) || (read(cycleFd, &result, sizeof(uint64_t)) != sizeof(uint64_t))) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    result = (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+  }
+  return result;
+}
+
+uint64_t getCounter(unsigned i) {
+  uint64_t result = -1;
+  if((i < PERF_COUNTERS) && (counterFd[i] >= 0)) {
+    if(read(counterFd[i], &result, sizeof(uint64_t)) != sizeof(uint64_t)) {
+      result = -1;
+    }
+  }
+  return result;
+}
+
+void initPerfCounters(uint32_t pmuEvent0, uint32_t pmuEvent1, uint32_t pmuEvent2, uint32_t pmuEvent3, uint32_t pmuEvent4, uint32_t pmuEvent5) {
+  disablePerfCounters();
+
+  cycleFd = perfEventOpen(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+
+#ifdef __aarch64__
+  // the PMU event numbers are only meaningful on an ARMv8 core
+  uint32_t events[PERF_COUNTERS] = { pmuEvent0, pmuEvent1, pmuEvent2, pmuEvent3, pmuEvent4, pmuEvent5 };
+  for(int i = 0; i < PERF_COUNTERS; i++) {
+    counterFd[i] = perfEventOpen(PERF_TYPE_RAW, events[i]);
+  }
+#endif
+}
+
+void disablePerfCounters(void) {
+  if(cycleFd >= 0) close(cycleFd);
+  cycleFd = -1;
+
+  for(int i = 0; i < PERF_COUNTERS; i++) {
+    if(counterFd[i] >= 0) close(counterFd[i]);
+    counterFd[i] = -1;
+  }
+}
+
+bool setupGpio(void) {
+  return false;
+}
+
+bool startProfiler(uint64_t textStart, uint64_t textSize, double period, bool dualCore) {
+  if(period > 0) {
+    pcSamplerPeriod = period;
+
+    bufSize = textSize/4;
+    ticksBuf = calloc(bufSize, sizeof(uint64_t));
+
+    if(ticksBuf) {
+      pcStart = textStart;
+      unknownTicks = 0;
+
+      struct sigaction sa;
+      memset(&sa, 0, sizeof(sa));
+      sa.sa_sigaction = sampleHandler;
+      sa.sa_flags = SA_SIGINFO | SA_RESTART;
+      sigemptyset(&sa.sa_mask);
+
+      struct itimerval timer;
+      timer.it_interval.tv_sec = (time_t)period;
+      timer.it_interval.tv_usec = (suseconds_t)((period - (time_t)period) * 1000000);
+      if((timer.it_interval.tv_sec == 0) && (timer.it_interval.tv_usec == 0)) {
+        timer.it_interval.tv_usec = 1;
+      }
+      timer.it_value = timer.it_interval;
+
+      profilerActive = true;
+
+      if((sigaction(SIGPROF, &sa, NULL) == 0) && (setitimer(ITIMER_PROF, &timer, NULL) == 0)) {
+        printf("PROFILER: Started, profiling between %p and %p at %f Hz\n", (void*)pcStart, (void*)pcStart+textSize, 1/period);
+        return true;
+      } else printf("PROFILER: Can't init timer\n");
+    } else printf("PROFILER: Can't allocate ticksBuf\n");
+
+    profilerActive = false;
+    return false;
+  }
+
+  return true;
+}
+
+static void writeSamples(char *filename) {
+  FRESULT res = f_mount(&fatfs, SDDRIVE, 1);
+  if(res != FR_OK) {
+    printf("PROFILER: Could not mount (%d)\n", res);
+    return;
+  }
+
+  FIL fp;
+  int mode = FA_OPEN_ALWAYS | FA_CREATE_ALWAYS | FA_WRITE;
+  res = f_open(&fp, filename, mode);
+  if(res != FR_OK) {
+    printf("PROFILER: Could not open (%d)\n", res);
+    return;
+  }
+
+  printf("PROFILER: Writing to file %s\n", filename);
+
+  // no power sensor on the host
+  double calData[14];
+  memset(calData, 0, sizeof(calData));
+
+  uint8_t core = 0;
+  uint8_t sensor = 1;
+
+  double unknownCurrentAvg = 0;
+  double unknownRuntime = unknownTicks * pcSamplerPeriod;
+
+  uint8_t magic = PROFMAGIC;
+  uint8_t version = PROFVERSION;
+
+  struct writebuf *wb = malloc(sizeof(struct writebuf));
+  if(wb == NULL) {
+    printf("PROFILER: Out of memory\n");
+    f_close(&fp);
+    return;
+  }
+  writeBufInit(wb, &fp);
+
+  writeBufData(wb, &magic, sizeof(uint8_t));
+  writeBufData(wb, &version, sizeof(uint8_t));
+  writeBufData(wb, &core, sizeof(uint8_t));
+  writeBufData(wb, &sensor, sizeof(uint8_t));
+  writeBufData(wb, calData, 14 * sizeof(double));
+  writeBufData(wb, &pcSamplerPeriod, sizeof(double));
+
+  writeBufData(wb, &unknownCurrentAvg, sizeof(double));
+  writeBufData(wb, &unknownRuntime, sizeof(double));
+
+  uint32_t count = 0;
+  for(int i = 0; i < bufSize; i++) {
+    if(ticksBuf[i] != 0) {
+      count++;
+    }
+  }
+
+  writeBufData(wb, &count, sizeof(uint32_t));
+
+  uint64_t prevPc = 0;
+  for(int i = 0; i < bufSize; i++) {
+    if(ticksBuf[i] != 0) {
+      // the profile holds link time addresses
+      uint64_t pc = (uint64_t)i * (uint64_t)4 + pcStart - _monLoadBias();
+      double current = 0;
+
+      writeBufVarint(wb, pc - prevPc);
+      writeBufVarint(wb, ticksBuf[i]);
+      writeBufData(wb, &current, sizeof(double));
+
+      prevPc = pc;
+    }
+  }
+
+  if(!writeBufFlush(wb)) {
+    printf("PROFILER: Could not write\n");
+  }
+  free(wb);
+
+  f_close(&fp);
+
+  printf("PROFILER: Done\n");
+}
+
+void stopProfiler(char *filename) {
+  if(profilerActive) {
+    struct itimerval timer;
+    memset(&timer, 0, sizeof(timer));
+    setitimer(ITIMER_PROF, &timer, NULL);
+    profilerActive = false;
+  }
+
+  writeSamples(filename);
+
+  // the sample handler checks the index against bufSize
+  bufSize = 0;
+  free(ticksBuf);
+  ticksBuf = NULL;
+}
+
+void profilerOn(void) {
+}
+
+void profilerOff(void) {
+}
+
+#endif
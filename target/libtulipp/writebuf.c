@@ -0,0 +1,62 @@
+#include "writebuf.h"
+
+#include <string.h>
+
+static void writeBufDrain(struct writebuf *wb) {
+  if(wb->len) {
+    UINT bw;
+    FRESULT res = f_write(wb->fp, wb->buffer, wb->len, &bw);
+    if((res != FR_OK) || (bw != wb->len)) {
+      wb->error = true;
+    }
+    wb->len = 0;
+  }
+}
+
+void writeBufInit(struct writebuf *wb, FIL *fp) {
+  wb->fp = fp;
+  wb->len = 0;
+  wb->error = false;
+}
+
+void writeBufData(struct writebuf *wb, const void *data, UINT size) {
+  const uint8_t *src = data;
+
+  while(size) {
+    UINT chunk = WRITEBUF_SIZE - wb->len;
+    if(chunk > size) chunk = size;
+
+    memcpy(wb->buffer + wb->len, src, chunk);
+    wb->len += chunk;
+    src += chunk;
+    size -= chunk;
+
+    // only full buffers are written before the end, keeping the file position sector aligned
+    if(wb->len == WRITEBUF_SIZE) {
+      writeBufDrain(wb);
+    }
+  }
+}
+
+void writeBufVarint(struct writebuf *wb, uint64_t value) {
+  uint8_t bytes[10];
+  UINT n = 0;
+
+  do {
+    bytes[n] = value & 0x7f;
+    value >>= 7;
+    if(value) bytes[n] |= 0x80;
+    n++;
+  } while(value);
+
+  writeBufData(wb, bytes, n);
+}
+
+void writeBufSigned(struct writebuf *wb, int64_t value) {
+  writeBufVarint(wb, ((uint64_t)value << 1) ^ (uint64_t)(value >> 63));
+}
+
+bool writeBufFlush(struct writebuf *wb) {
+  writeBufDrain(wb);
+  return !wb->error;
+}
@@ -0,0 +1,43 @@
+#ifndef _WRITEBUF_H
+#define _WRITEBUF_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef TULIPP_HOST
+#include "hostff.h"
+#else
+#include <ff.h>
+#endif
+
+#include "profformat.h"
+
+/*
+ * Buffered output to a FatFs file.  FatFs does a sector read-modify-write for
+ * every write that does not cover whole sectors, so records are packed into a
+ * buffer that is handed to f_write a multiple of sectors at a time.  The buffer
+ * is part of the writebuf, which is too large for the stack of the target, so
+ * callers allocate it.  Each writebuf writes one file.
+ */
+
+#define WRITEBUF_SECTOR 512
+#define WRITEBUF_SIZE (64 * WRITEBUF_SECTOR)
+
+struct writebuf {
+  FIL *fp;
+  UINT len; /* bytes waiting in the buffer */
+  bool error;
+  uint8_t buffer[WRITEBUF_SIZE];
+};
+
+void writeBufInit(struct writebuf *wb, FIL *fp);
+/** Append raw bytes */
+void writeBufData(struct writebuf *wb, const void *data, UINT size);
+/** Append unsigned LEB128 varint */
+void writeBufVarint(struct writebuf *wb, uint64_t value);
+/** Append zigzag encoded signed LEB128 varint */
+void writeBufSigned(struct writebuf *wb, int64_t value);
+/** Write what is left in the buffer.  Returns false if any write failed */
+bool writeBufFlush(struct writebuf *wb);
+
+#endif